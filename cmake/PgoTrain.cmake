@@ -0,0 +1,70 @@
+# PgoTrain.cmake - The training run behind the pgo-train target
+#
+# Plays GAMES seeded games headless, recording each as a replay, then
+# verifies every replay the way the leaderboard server does and plays a
+# batch on the SIMD engine. The instrumented tools write their counters
+# into PROFILE_DIR as they exit; a TOWERBUILDER_PGO=USE build reads them.
+#
+#   cmake -DHEADLESS=... -DREPLAY=... [-DSIM=...] -DGAMES=N
+#         -DPROFILE_DIR=... -DREPLAY_DIR=... -DCOMPILER=GNU|Clang
+#         [-DLLVM_PROFDATA=...] -P PgoTrain.cmake
+
+foreach(var HEADLESS REPLAY GAMES PROFILE_DIR REPLAY_DIR COMPILER)
+    if("${${var}}" STREQUAL "")
+        message(FATAL_ERROR "PgoTrain.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+# Run one training step; a crash would leave a partial profile
+function(train)
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE result OUTPUT_QUIET)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "PGO training step failed (${result}): ${ARGN}")
+    endif()
+endfunction()
+
+# Counters accumulate across runs; start from an empty profile so one
+# from an older build never mixes in
+file(REMOVE_RECURSE ${PROFILE_DIR} ${REPLAY_DIR})
+file(MAKE_DIRECTORY ${PROFILE_DIR} ${REPLAY_DIR})
+
+message(STATUS "Recording ${GAMES} games")
+train(${HEADLESS} --games ${GAMES} --record ${REPLAY_DIR})
+
+file(GLOB replays ${REPLAY_DIR}/*.tbr)
+list(LENGTH replays replayCount)
+if(replayCount EQUAL 0)
+    message(FATAL_ERROR "TowerBuilderHeadless recorded no replays in ${REPLAY_DIR}")
+endif()
+
+# In groups, so the command line stays short on every platform
+message(STATUS "Verifying ${replayCount} replays")
+set(group "")
+foreach(replay IN LISTS replays)
+    list(APPEND group ${replay})
+    list(LENGTH group groupSize)
+    if(groupSize EQUAL 200)
+        train(${REPLAY} --quiet ${group})
+        set(group "")
+    endif()
+endforeach()
+if(group)
+    train(${REPLAY} --quiet ${group})
+endif()
+
+if(NOT "${SIM}" STREQUAL "")
+    message(STATUS "Playing ${GAMES} games on the batch engine")
+    train(${SIM} --games ${GAMES} --engine batch)
+endif()
+
+# Clang writes one raw profile per process; USE builds read the merge
+if(COMPILER MATCHES "Clang")
+    if("${LLVM_PROFDATA}" STREQUAL "" OR LLVM_PROFDATA MATCHES "NOTFOUND$")
+        message(FATAL_ERROR "llvm-profdata not found; set TOWER_LLVM_PROFDATA to merge the profile")
+    endif()
+    file(GLOB rawProfiles ${PROFILE_DIR}/*.profraw)
+    train(${LLVM_PROFDATA} merge -output=${PROFILE_DIR}/tower.profdata ${rawProfiles})
+    file(REMOVE ${rawProfiles})
+endif()
+
+message(STATUS "PGO profile written to ${PROFILE_DIR}")
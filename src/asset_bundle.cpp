@@ -0,0 +1,200 @@
+/**
+ * AssetBundle - Every game asset packed into one memory-mapped file
+ * See asset_bundle.h for the byte layout.
+ */
+
+#include "asset_bundle.h"
+#include "byte_io.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+
+namespace {
+
+constexpr std::uint32_t BUNDLE_MAGIC = 0x42414254;  // "TBAB"
+constexpr std::uint8_t BUNDLE_FORMAT_VERSION = 1;
+constexpr std::size_t DATA_ALIGNMENT = 16;
+
+std::string LowerCase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+bool ReadWholeFile(const std::filesystem::path& path, std::vector<std::uint8_t>& bytes) {
+    std::FILE* file = std::fopen(path.string().c_str(), "rb");
+    if (file == nullptr) return false;
+
+    bytes.clear();
+    std::uint8_t buffer[16384];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + read);
+    }
+    bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    return ok;
+}
+
+struct PackedFile {
+    AssetKind kind;
+    std::string name;
+    std::vector<std::uint8_t> bytes;
+};
+
+}  // namespace
+
+AssetKind AssetKindForPath(const std::string& path) {
+    std::string extension = LowerCase(AssetExtension(path));
+    if (extension == ".ttf" || extension == ".otf") {
+        return AssetKind::Font;
+    }
+    if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+        extension == ".bmp" || extension == ".tga" || extension == ".qoi") {
+        return AssetKind::Texture;
+    }
+    if (extension == ".wav" || extension == ".ogg" || extension == ".mp3" ||
+        extension == ".flac" || extension == ".qoa") {
+        // Long tracks are streamed; by convention their names start "music"
+        std::size_t slash = path.find_last_of('/');
+        std::string base = LowerCase(slash == std::string::npos ? path : path.substr(slash + 1));
+        return base.compare(0, 5, "music") == 0 ? AssetKind::Music : AssetKind::Sound;
+    }
+    return AssetKind::Data;
+}
+
+const char* AssetExtension(const std::string& name) {
+    std::size_t dot = name.find_last_of('.');
+    std::size_t slash = name.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return "";
+    return name.c_str() + dot;
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+bool AssetBundle::Open(const char* path) {
+    Close();
+    if (!file.Open(path)) return false;
+
+    ByteReader reader{file.GetData(), file.GetSize()};
+    if (reader.Fixed(4) != BUNDLE_MAGIC || reader.Fixed(1) != BUNDLE_FORMAT_VERSION) {
+        Close();
+        return false;
+    }
+
+    std::uint64_t count = reader.Varint();
+    for (std::uint64_t i = 0; i < count && reader.ok; i++) {
+        AssetEntry entry;
+        entry.kind = static_cast<AssetKind>(reader.Fixed(1));
+        std::uint64_t nameLength = reader.Varint();
+        if (!reader.ok || nameLength > reader.size - reader.offset) break;
+        entry.name.assign(reinterpret_cast<const char*>(reader.data + reader.offset),
+                          static_cast<std::size_t>(nameLength));
+        reader.offset += static_cast<std::size_t>(nameLength);
+
+        std::uint64_t offset = reader.Fixed(8);
+        std::uint64_t size = reader.Fixed(8);
+        if (!reader.ok || offset > file.GetSize() || size > file.GetSize() - offset) {
+            reader.ok = false;
+            break;
+        }
+        entry.data = file.GetData() + offset;
+        entry.size = static_cast<std::size_t>(size);
+        entries.push_back(std::move(entry));
+    }
+
+    if (!reader.ok) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void AssetBundle::Close() {
+    entries.clear();
+    file.Close();
+}
+
+const AssetEntry* AssetBundle::Find(const std::string& name) const {
+    for (const AssetEntry& entry : entries) {
+        if (entry.name == name) return &entry;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Packing
+// ============================================================================
+
+int WriteAssetBundle(const char* path, const char* sourceDir) {
+    namespace fs = std::filesystem;
+
+    std::vector<PackedFile> files;
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(sourceDir, error), end; !error && it != end;
+         it.increment(error)) {
+        if (!it->is_regular_file()) continue;
+
+        std::string name = it->path().lexically_relative(sourceDir).generic_string();
+        if (LowerCase(AssetExtension(name)) == ".md") continue;  // Notes, not assets
+
+        PackedFile packed{AssetKindForPath(name), name, {}};
+        if (!ReadWholeFile(it->path(), packed.bytes)) return -1;
+        files.push_back(std::move(packed));
+    }
+    if (error) return -1;
+
+    // Load order: by kind, then smallest first; names break ties so the
+    // bundle is the same byte for byte on every machine
+    std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) {
+        if (a.kind != b.kind) return a.kind < b.kind;
+        if (a.bytes.size() != b.bytes.size()) return a.bytes.size() < b.bytes.size();
+        return a.name < b.name;
+    });
+
+    // Offsets are fixed-width, so the table's size is known before any
+    // offset is
+    std::size_t tableSize = 4 + 1;
+    {
+        std::vector<std::uint8_t> scratch;
+        PutVarint(scratch, files.size());
+        tableSize += scratch.size();
+        for (const PackedFile& packed : files) {
+            scratch.clear();
+            PutVarint(scratch, packed.name.size());
+            tableSize += 1 + scratch.size() + packed.name.size() + 8 + 8;
+        }
+    }
+
+    std::vector<std::uint8_t> bytes;
+    PutFixed(bytes, BUNDLE_MAGIC, 4);
+    bytes.push_back(BUNDLE_FORMAT_VERSION);
+    PutVarint(bytes, files.size());
+
+    std::size_t offset = tableSize;
+    for (const PackedFile& packed : files) {
+        offset = (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+        bytes.push_back(static_cast<std::uint8_t>(packed.kind));
+        PutVarint(bytes, packed.name.size());
+        bytes.insert(bytes.end(), packed.name.begin(), packed.name.end());
+        PutFixed(bytes, offset, 8);
+        PutFixed(bytes, packed.bytes.size(), 8);
+        offset += packed.bytes.size();
+    }
+
+    for (const PackedFile& packed : files) {
+        bytes.resize((bytes.size() + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT, 0);
+        bytes.insert(bytes.end(), packed.bytes.begin(), packed.bytes.end());
+    }
+
+    std::FILE* out = std::fopen(path, "wb");
+    if (out == nullptr) return -1;
+    bool written = std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+    if (std::fclose(out) != 0 || !written) return -1;
+    return static_cast<int>(files.size());
+}
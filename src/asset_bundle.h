@@ -0,0 +1,81 @@
+/**
+ * AssetBundle - Every game asset packed into one memory-mapped file
+ *
+ * TowerBuilderPack packs assets/ into assets.tbab at build time. At
+ * startup the game maps the bundle and reads its small table of contents;
+ * asset bytes are only paged in when the loader thread decodes them, so
+ * opening the bundle costs the same with 3 assets or 300.
+ *
+ * Byte layout (little-endian, varint = LEB128 unsigned):
+ *
+ *     u32    magic "TBAB"
+ *     u8     format version
+ *     varint entry count
+ *     entries, each:
+ *         u8     AssetKind
+ *         varint name length, then the name (path under assets/, '/'-separated)
+ *         u64    offset of the data from the start of the file
+ *         u64    data size in bytes
+ *     data   each entry's file bytes, starting on a 16-byte boundary
+ *
+ * Entries are stored in load order: fonts first (the HUD wants them on
+ * the first frames), then textures, sounds and music, smallest first
+ * within a kind, so the loader delivers the cheap assets before the big
+ * ones.
+ *
+ * Time Complexity:
+ * - Open: O(entries); no asset data is read
+ * - Find: O(entries) - bundles hold a handful of assets
+ */
+
+#pragma once
+
+#include "mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class AssetKind : std::uint8_t {
+    Font = 0,
+    Texture = 1,
+    Sound = 2,   // Decoded fully into memory
+    Music = 3,   // Streamed while it plays
+    Data = 4,    // Anything else; handed over as raw bytes
+};
+
+struct AssetEntry {
+    AssetKind kind;
+    std::string name;            // e.g. "sounds/drop.wav"
+    const std::uint8_t* data;    // Inside the mapping; valid while the bundle is open
+    std::size_t size;
+};
+
+// Kind a file is packed as, from its extension; Data if unknown
+AssetKind AssetKindForPath(const std::string& path);
+
+// Extension with its dot (".wav"), which raylib's *FromMemory loaders want
+const char* AssetExtension(const std::string& name);
+
+class AssetBundle {
+public:
+    // Map `path` and read its table; false if missing or malformed
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return file.IsOpen(); }
+
+    const std::vector<AssetEntry>& GetEntries() const { return entries; }
+    const AssetEntry* Find(const std::string& name) const;
+
+private:
+    MappedFile file;
+    std::vector<AssetEntry> entries;  // In load order
+};
+
+/**
+ * Pack every file under `sourceDir` (recursively, skipping Markdown notes)
+ * into a bundle at `path`, in load order. Returns the number of assets
+ * packed, or -1 on an I/O error.
+ */
+int WriteAssetBundle(const char* path, const char* sourceDir);
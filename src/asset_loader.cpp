@@ -0,0 +1,236 @@
+/**
+ * AssetLoader - Streams the asset bundle in while the game is already running
+ * See asset_loader.h for an overview.
+ */
+
+#include "asset_loader.h"
+
+#include <chrono>
+
+bool AssetLoader::Start(const char* bundlePath) {
+    Unload();
+    if (!bundle.Open(bundlePath)) return false;
+
+    loaded.assign(bundle.GetEntries().size(), LoadedAsset());
+    delivered = 0;
+    started = true;
+    stopDecoder.store(false);
+    decoder = std::thread(&AssetLoader::DecodeLoop, this);
+    return true;
+}
+
+// ============================================================================
+// LOADER THREAD
+// ============================================================================
+
+void AssetLoader::DecodeLoop() {
+    std::size_t count = bundle.GetEntries().size();
+    for (std::size_t index = 0; index < count; index++) {
+        DecodedAsset decoded = Decode(index);
+
+        // QUEUE: Wait for the main thread to make room
+        while (!ring.TryPush(decoded)) {
+            if (stopDecoder.load()) {
+                FreeDecoded(decoded);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (stopDecoder.load()) return;
+    }
+}
+
+// CPU-side decode only: nothing here touches the GPU or the audio device
+AssetLoader::DecodedAsset AssetLoader::Decode(std::size_t index) const {
+    const AssetEntry& entry = bundle.GetEntries()[index];
+    const char* extension = AssetExtension(entry.name);
+    const unsigned char* data = entry.data;
+    int size = static_cast<int>(entry.size);
+
+    DecodedAsset decoded;
+    decoded.entry = index;
+
+    switch (entry.kind) {
+        case AssetKind::Texture:
+            decoded.image = LoadImageFromMemory(extension, data, size);
+            decoded.ok = IsImageReady(decoded.image);
+            break;
+        case AssetKind::Font:
+            // Same steps as LoadFontFromMemory, minus the texture upload
+            decoded.glyphCount = FONT_GLYPH_COUNT;
+            decoded.glyphs = LoadFontData(data, size, FONT_SIZE, nullptr, FONT_GLYPH_COUNT,
+                                          FONT_DEFAULT);
+            if (decoded.glyphs != nullptr) {
+                decoded.image = GenImageFontAtlas(decoded.glyphs, &decoded.glyphRects,
+                                                  FONT_GLYPH_COUNT, FONT_SIZE, FONT_PADDING, 0);
+            }
+            decoded.ok = decoded.glyphs != nullptr && IsImageReady(decoded.image);
+            break;
+        case AssetKind::Sound:
+            decoded.wave = LoadWaveFromMemory(extension, data, size);
+            decoded.ok = IsWaveReady(decoded.wave);
+            break;
+        case AssetKind::Music:  // Decoded by the audio thread as it plays
+        case AssetKind::Data:   // Used straight from the mapping
+            decoded.ok = true;
+            break;
+    }
+    return decoded;
+}
+
+void AssetLoader::FreeDecoded(DecodedAsset& decoded) {
+    if (decoded.image.data != nullptr) UnloadImage(decoded.image);
+    if (decoded.wave.data != nullptr) UnloadWave(decoded.wave);
+    if (decoded.glyphs != nullptr) UnloadFontData(decoded.glyphs, decoded.glyphCount);
+    if (decoded.glyphRects != nullptr) MemFree(decoded.glyphRects);
+    decoded = DecodedAsset();
+}
+
+// ============================================================================
+// MAIN THREAD
+// ============================================================================
+
+void AssetLoader::Pump(double budgetSeconds) {
+    if (!started || IsDone()) return;
+
+    double deadline = GetTime() + budgetSeconds;
+    DecodedAsset decoded;
+    // At least one upload per call, so a tight budget still makes progress
+    while (ring.TryPop(decoded)) {
+        Upload(decoded);
+        delivered++;
+        if (GetTime() >= deadline) break;
+    }
+
+    if (IsDone()) {
+        decoder.join();
+        TraceLog(LOG_INFO, "Assets: %zu loaded from the bundle", loaded.size());
+    }
+}
+
+void AssetLoader::Upload(DecodedAsset& decoded) {
+    const AssetEntry& entry = bundle.GetEntries()[decoded.entry];
+    LoadedAsset& asset = loaded[decoded.entry];
+    if (!decoded.ok) {
+        TraceLog(LOG_WARNING, "Assets: could not decode %s", entry.name.c_str());
+        FreeDecoded(decoded);
+        return;
+    }
+
+    // The audio device costs tens of milliseconds to open, so only a
+    // bundle with audio opens it, and only once the game is running
+    bool audio = entry.kind == AssetKind::Sound || entry.kind == AssetKind::Music;
+    if (audio && !IsAudioDeviceReady()) {
+        InitAudioDevice();
+        openedAudio = IsAudioDeviceReady();
+    }
+
+    switch (entry.kind) {
+        case AssetKind::Texture:
+            asset.texture = LoadTextureFromImage(decoded.image);
+            asset.ready = IsTextureReady(asset.texture);
+            break;
+        case AssetKind::Font:
+            // The font takes ownership of the glyphs and their rectangles only
+            // once the atlas is on the GPU; otherwise FreeDecoded frees them
+            asset.font.texture = LoadTextureFromImage(decoded.image);
+            asset.ready = IsTextureReady(asset.font.texture);
+            if (asset.ready) {
+                asset.font.baseSize = FONT_SIZE;
+                asset.font.glyphCount = decoded.glyphCount;
+                asset.font.glyphPadding = FONT_PADDING;
+                asset.font.glyphs = decoded.glyphs;
+                asset.font.recs = decoded.glyphRects;
+                decoded.glyphs = nullptr;
+                decoded.glyphRects = nullptr;
+            }
+            break;
+        case AssetKind::Sound:
+            if (IsAudioDeviceReady()) {
+                asset.sound = LoadSoundFromWave(decoded.wave);
+                asset.ready = IsSoundReady(asset.sound);
+            }
+            break;
+        case AssetKind::Music:
+            // Streams straight out of the mapping, which outlives it
+            if (IsAudioDeviceReady()) {
+                asset.music = LoadMusicStreamFromMemory(AssetExtension(entry.name), entry.data,
+                                                        static_cast<int>(entry.size));
+                asset.ready = IsMusicReady(asset.music);
+            }
+            break;
+        case AssetKind::Data:
+            asset.ready = true;
+            break;
+    }
+    FreeDecoded(decoded);  // CPU copies are no longer needed
+}
+
+std::size_t AssetLoader::FindReady(const std::string& name, AssetKind kind) const {
+    const std::vector<AssetEntry>& entries = bundle.GetEntries();
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].name == name) {
+            return entries[i].kind == kind && loaded[i].ready ? i : loaded.size();
+        }
+    }
+    return loaded.size();
+}
+
+const Texture2D* AssetLoader::GetTexture(const std::string& name) const {
+    std::size_t index = FindReady(name, AssetKind::Texture);
+    return index < loaded.size() ? &loaded[index].texture : nullptr;
+}
+
+const Font* AssetLoader::GetFont(const std::string& name) const {
+    std::size_t index = FindReady(name, AssetKind::Font);
+    return index < loaded.size() ? &loaded[index].font : nullptr;
+}
+
+const Sound* AssetLoader::GetSound(const std::string& name) const {
+    std::size_t index = FindReady(name, AssetKind::Sound);
+    return index < loaded.size() ? &loaded[index].sound : nullptr;
+}
+
+Music* AssetLoader::GetMusic(const std::string& name) {
+    std::size_t index = FindReady(name, AssetKind::Music);
+    return index < loaded.size() ? &loaded[index].music : nullptr;
+}
+
+const AssetEntry* AssetLoader::GetData(const std::string& name) const {
+    return bundle.Find(name);
+}
+
+void AssetLoader::Unload() {
+    if (!started) return;
+
+    stopDecoder.store(true);
+    if (decoder.joinable()) decoder.join();
+
+    // Decoded but never uploaded
+    DecodedAsset decoded;
+    while (ring.TryPop(decoded)) {
+        FreeDecoded(decoded);
+    }
+
+    const std::vector<AssetEntry>& entries = bundle.GetEntries();
+    for (std::size_t i = 0; i < loaded.size(); i++) {
+        LoadedAsset& asset = loaded[i];
+        if (!asset.ready) continue;
+        switch (entries[i].kind) {
+            case AssetKind::Texture: UnloadTexture(asset.texture); break;
+            case AssetKind::Font: UnloadFont(asset.font); break;
+            case AssetKind::Sound: UnloadSound(asset.sound); break;
+            case AssetKind::Music: UnloadMusicStream(asset.music); break;
+            case AssetKind::Data: break;
+        }
+    }
+    loaded.clear();
+    if (openedAudio) {
+        CloseAudioDevice();
+        openedAudio = false;
+    }
+
+    bundle.Close();
+    delivered = 0;
+    started = false;
+}
@@ -0,0 +1,106 @@
+/**
+ * AssetLoader - Streams the asset bundle in while the game is already running
+ *
+ * WHY ASYNCHRONOUS?
+ * - Decoding PNGs, fonts and sounds takes milliseconds each; doing it in
+ *   main() before the first frame makes startup grow with every asset
+ * - A loader thread decodes from the memory-mapped bundle (CPU only:
+ *   images, glyph atlases, waves) while the main thread keeps drawing
+ * - GPU textures and audio buffers can only be created on the main
+ *   thread, so decoded assets come back through a QUEUE (SpscRing) and
+ *   Pump() uploads them between frames within a time budget
+ * - An asset is unavailable (nullptr) until it arrives; everything that
+ *   uses one has a fallback, so the first frame never waits
+ *
+ *     loader thread: bundle entry -> decode -> ring.TryPush
+ *     main thread:   ring.TryPop -> upload -> ready
+ *
+ * Time Complexity:
+ * - Start: O(entries); no asset data is read on the calling thread
+ * - Pump: O(assets uploaded), bounded by the budget
+ * - GetTexture / GetSound / ...: O(entries) - bundles hold a handful
+ */
+
+#pragma once
+
+#include "asset_bundle.h"
+#include "spsc_ring.h"
+
+#include "raylib.h"
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AssetLoader {
+public:
+    AssetLoader() = default;
+    ~AssetLoader() { Unload(); }
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Map the bundle and start decoding it in the background. The game
+    // runs without assets if this fails.
+    bool Start(const char* bundlePath);
+
+    // Main thread, once per frame: upload decoded assets for at most
+    // `budgetSeconds`
+    void Pump(double budgetSeconds);
+
+    // Every bundled asset has been uploaded (or failed to decode)
+    bool IsDone() const { return started && delivered == loaded.size(); }
+
+    // A ready asset by bundle name, or nullptr while it is still loading
+    const Texture2D* GetTexture(const std::string& name) const;
+    const Font* GetFont(const std::string& name) const;
+    const Sound* GetSound(const std::string& name) const;
+    Music* GetMusic(const std::string& name);
+    const AssetEntry* GetData(const std::string& name) const;  // Raw bytes, ready at once
+
+    // Stop the loader and free everything; call before CloseWindow
+    void Unload();
+
+private:
+    // Decoded on the loader thread, uploaded on the main thread
+    struct DecodedAsset {
+        std::size_t entry = 0;
+        bool ok = false;
+        Image image = {};          // Texture, or a font's glyph atlas
+        Wave wave = {};            // Sound
+        GlyphInfo* glyphs = nullptr;
+        Rectangle* glyphRects = nullptr;
+        int glyphCount = 0;
+    };
+
+    struct LoadedAsset {
+        bool ready = false;
+        Texture2D texture = {};
+        Font font = {};
+        Sound sound = {};
+        Music music = {};
+    };
+
+    static constexpr int FONT_SIZE = 32;         // Glyph atlas size, in pixels
+    static constexpr int FONT_GLYPH_COUNT = 95;  // Printable ASCII
+    static constexpr int FONT_PADDING = 4;
+
+    AssetBundle bundle;
+    std::vector<LoadedAsset> loaded;   // By bundle entry
+    std::size_t delivered = 0;         // Entries popped so far
+    bool started = false;
+    bool openedAudio = false;          // We started the audio device
+
+    SpscRing<DecodedAsset, 16> ring;   // QUEUE: Loader thread -> main thread
+    std::thread decoder;
+    std::atomic<bool> stopDecoder{false};
+
+    void DecodeLoop();
+    DecodedAsset Decode(std::size_t index) const;
+    void Upload(DecodedAsset& decoded);
+    static void FreeDecoded(DecodedAsset& decoded);
+    // Entry index of a ready asset of `kind`, else loaded.size()
+    std::size_t FindReady(const std::string& name, AssetKind kind) const;
+};
@@ -0,0 +1,66 @@
+/**
+ * Tower Builder - Asset packer
+ *
+ * Packs a directory of assets into one bundle the game memory-maps at
+ * startup (see asset_bundle.h). The build runs it whenever a file under
+ * assets/ changes; run it by hand to inspect a bundle.
+ *
+ * Usage:
+ *   TowerBuilderPack SOURCE_DIR BUNDLE       Pack SOURCE_DIR into BUNDLE
+ *   TowerBuilderPack --list BUNDLE           Print BUNDLE's table of contents
+ *
+ * Exit status is 0 on success, 1 otherwise.
+ */
+
+#include "asset_bundle.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char* KindName(AssetKind kind) {
+    switch (kind) {
+        case AssetKind::Font: return "font";
+        case AssetKind::Texture: return "texture";
+        case AssetKind::Sound: return "sound";
+        case AssetKind::Music: return "music";
+        case AssetKind::Data: return "data";
+    }
+    return "?";
+}
+
+void PrintUsage(const char* program) {
+    std::printf("Usage: %s SOURCE_DIR BUNDLE\n"
+                "       %s --list BUNDLE\n",
+                program, program);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (std::strcmp(argv[1], "--list") == 0) {
+        AssetBundle bundle;
+        if (!bundle.Open(argv[2])) {
+            std::fprintf(stderr, "%s is not an asset bundle\n", argv[2]);
+            return 1;
+        }
+        for (const AssetEntry& entry : bundle.GetEntries()) {
+            std::printf("%-8s %10zu  %s\n", KindName(entry.kind), entry.size, entry.name.c_str());
+        }
+        return 0;
+    }
+
+    int count = WriteAssetBundle(argv[2], argv[1]);
+    if (count < 0) {
+        std::fprintf(stderr, "Could not pack %s into %s\n", argv[1], argv[2]);
+        return 1;
+    }
+    std::printf("Packed %d assets into %s\n", count, argv[2]);
+    return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * BatchSimulation - Structure-of-arrays engine that steps many games at once
+ * See batch_simulation.h for an overview.
+ */
+
+#include "batch_simulation.h"
+#include "simd.h"
+
+#include <algorithm>
+
+BatchSimulation::BatchSimulation(int laneCount, const SimParams& params)
+    : params(params), laneCount(laneCount) {
+    paddedCount = (laneCount + SimdNative::WIDTH - 1) / SimdNative::WIDTH * SimdNative::WIDTH;
+
+    for (std::vector<float>* field : {&currentX, &currentWidth, &blockSpeed, &direction,
+                                      &topX, &topWidth}) {
+        field->resize(paddedCount);
+    }
+    for (std::vector<std::int32_t>* field : {&score, &consecutivePerfects, &towerHeight,
+                                             &speedCounter, &alive, &dropRequests, &stacked}) {
+        field->resize(paddedCount);
+    }
+
+    Reset();
+}
+
+void BatchSimulation::Reset() {
+    // Same starting state as Simulation::Reset(): base block centred,
+    // first block spawned at x = 0 moving right
+    const float baseX = Simulation::SCREEN_WIDTH / 2 - Simulation::INITIAL_BLOCK_WIDTH / 2;
+    const float width = Simulation::INITIAL_BLOCK_WIDTH;
+
+    std::fill(currentX.begin(), currentX.end(), 0.0f);
+    std::fill(currentWidth.begin(), currentWidth.end(), width);
+    std::fill(blockSpeed.begin(), blockSpeed.end(), params.initialSpeed);
+    std::fill(direction.begin(), direction.end(), 1.0f);
+    std::fill(topX.begin(), topX.end(), baseX);
+    std::fill(topWidth.begin(), topWidth.end(), width);
+
+    std::fill(score.begin(), score.end(), 0);
+    std::fill(consecutivePerfects.begin(), consecutivePerfects.end(), 0);
+    std::fill(towerHeight.begin(), towerHeight.end(), 0);
+    std::fill(speedCounter.begin(), speedCounter.end(), 1);  // Base block only
+    std::fill(dropRequests.begin(), dropRequests.end(), 0);
+    std::fill(stacked.begin(), stacked.end(), 0);
+
+    // Padding lanes start dead so they never move or score
+    std::fill(alive.begin(), alive.begin() + laneCount, 1);
+    std::fill(alive.begin() + laneCount, alive.end(), 0);
+}
+
+int BatchSimulation::GetLiveLaneCount() const {
+    return static_cast<int>(std::count(alive.begin(), alive.begin() + laneCount, 1));
+}
+
+void BatchSimulation::Step(float deltaTime) {
+    StepKernel<SimdNative>(deltaTime);
+}
+
+template <typename S>
+void BatchSimulation::StepKernel(float deltaTime) {
+    using F = typename S::F;
+    using I = typename S::I;
+    using M = typename S::M;
+
+    const F dt = S::Set(deltaTime);
+    const F zero = S::Set(0.0f);
+    const F left = S::Set(-1.0f);
+    const F right = S::Set(1.0f);
+    const F screenWidth = S::Set(Simulation::SCREEN_WIDTH);
+    const F minOverlapRatio = S::Set(params.minOverlapRatio);
+    const F perfectThreshold = S::Set(params.perfectThreshold);
+    const F speedIncrement = S::Set(params.speedIncrement);
+    const I zeroI = S::SetI(0);
+    const I oneI = S::SetI(1);
+
+    // Scoring and difficulty constants, from the same policy as Simulation
+    const F accuracyPoints = S::Set(GameRules::ACCURACY_POINTS);
+    const I accuracyBase = S::SetI(GameRules::ACCURACY_BASE_POINTS);
+    const I perfectBase = S::SetI(GameRules::PERFECT_BASE_POINTS);
+    const I perfectStreak = S::SetI(GameRules::PERFECT_STREAK_POINTS);
+    const I speedupInterval = S::SetI(GameRules::SPEEDUP_INTERVAL);
+
+    for (int i = 0; i < paddedCount; i += S::WIDTH) {
+        M live = S::NonZero(S::LoadI(&alive[i]));
+        F x = S::Load(&currentX[i]);
+        F width = S::Load(&currentWidth[i]);
+        F speed = S::Load(&blockSpeed[i]);
+        F dir = S::Load(&direction[i]);
+
+        // UpdateBlockMovement: x += blockSpeed * direction * deltaTime
+        x = S::Select(live, S::Add(x, S::Mul(S::Mul(speed, dir), dt)), x);
+
+        // Bounce at screen edges (right edge wins, as in the scalar else-if)
+        M hitRight = S::And(live, S::GreaterEqual(S::Add(x, width), screenWidth));
+        M hitLeft = S::AndNot(S::And(live, S::LessEqual(x, zero)), hitRight);
+        dir = S::Select(hitRight, left, S::Select(hitLeft, right, dir));
+
+        M drop = S::And(live, S::NonZero(S::LoadI(&dropRequests[i])));
+        M stackedNow = drop;  // Narrowed below; all-false when nobody drops
+
+        if (S::Any(drop)) {
+            F belowX = S::Load(&topX[i]);
+            F belowWidth = S::Load(&topWidth[i]);
+
+            // CheckOverlap, with std::max / std::min argument order
+            F currentRight = S::Add(x, width);
+            F belowRight = S::Add(belowX, belowWidth);
+            F overlapStart = S::Select(S::Less(x, belowX), belowX, x);
+            F overlapEnd = S::Select(S::Less(belowRight, currentRight), belowRight, currentRight);
+            F overlapWidth = S::Sub(overlapEnd, overlapStart);
+
+            M hit = S::Greater(overlapEnd, overlapStart);
+            M tooSmall = S::Less(overlapWidth, S::Mul(width, minOverlapRatio));
+            stackedNow = S::AndNot(S::And(drop, hit), tooSmall);
+            M missed = S::AndNot(drop, stackedNow);
+
+            // Scoring
+            F accuracy = S::Div(overlapWidth, width);
+            M perfect = S::Less(S::Abs(S::Sub(overlapWidth, width)), perfectThreshold);
+
+            I perfects = S::LoadI(&consecutivePerfects[i]);
+            I perfectsAfter = S::SelectI(perfect, S::AddI(perfects, oneI), zeroI);
+            I perfectGain = S::AddI(perfectBase, S::MulI(perfectsAfter, perfectStreak));
+            I accuracyGain = S::AddI(accuracyBase, S::Truncate(S::Mul(accuracy, accuracyPoints)));
+            I gained = S::SelectI(perfect, perfectGain, accuracyGain);
+
+            S::StoreI(&score[i], S::SelectI(stackedNow,
+                                            S::AddI(S::LoadI(&score[i]), gained),
+                                            S::LoadI(&score[i])));
+            S::StoreI(&consecutivePerfects[i], S::SelectI(stackedNow, perfectsAfter, perfects));
+            S::StoreI(&towerHeight[i], S::SelectI(stackedNow,
+                                                  S::AddI(S::LoadI(&towerHeight[i]), oneI),
+                                                  S::LoadI(&towerHeight[i])));
+
+            // Increase difficulty every SPEEDUP_INTERVAL blocks
+            I counter = S::AddI(S::LoadI(&speedCounter[i]), oneI);
+            M speedUp = S::And(stackedNow, S::EqualI(counter, speedupInterval));
+            counter = S::SelectI(speedUp, zeroI, counter);
+            S::StoreI(&speedCounter[i], S::SelectI(stackedNow, counter,
+                                                   S::LoadI(&speedCounter[i])));
+            speed = S::Select(speedUp, S::Add(speed, speedIncrement), speed);
+
+            // STACK: The trimmed block becomes the new top
+            S::Store(&topX[i], S::Select(stackedNow, overlapStart, belowX));
+            S::Store(&topWidth[i], S::Select(stackedNow, overlapWidth, belowWidth));
+
+            // QUEUE: Spawn the next block, as wide as the new top. Nothing
+            // is queued: colours never affect the outcome
+            width = S::Select(stackedNow, overlapWidth, width);
+            x = S::Select(stackedNow, zero, x);
+
+            S::StoreI(&alive[i], S::SelectI(missed, zeroI, S::LoadI(&alive[i])));
+        }
+
+        S::Store(&currentX[i], x);
+        S::Store(&currentWidth[i], width);
+        S::Store(&blockSpeed[i], speed);
+        S::Store(&direction[i], dir);
+        S::StoreI(&stacked[i], S::MaskToInt(stackedNow));
+    }
+
+    // Requests are consumed every step, including those on dead lanes
+    std::fill(dropRequests.begin(), dropRequests.end(), 0);
+}
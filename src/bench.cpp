@@ -0,0 +1,610 @@
+/**
+ * Tower Builder - Microbenchmarks (Google Benchmark)
+ *
+ * Covers the hot paths of the data structures and rules:
+ * - STACK: Tower::Push and the visible-range culling behind drawing,
+ *   at heights from 10 to 100k blocks, and whole-tower walks of packed
+ *   blocks against full Blocks up to 1M blocks
+ * - LINKED LIST: ScoreHistory::AddScore and the O(1) queries, at 1 to 10M
+ *   recorded games
+ * - Rules: CheckOverlap, drop-and-trim throughput, plain movement ticks
+ * - Bots: the predictive policy's closed-form drop plan, next to a search
+ *   that steps the block forward tick by tick
+ * - QUEUE: on-demand peeks into the seeded block sequence, next to the
+ *   std::queue spawn cycle and preview copy it replaced
+ * - Practice timeline: undo/redo and rewinds on towers up to 10k blocks
+ * - Particles: one frame's SIMD integration of 1k to 16k live particles
+ * - Leaderboard: submission throughput through the lock-free lanes and
+ *   shard workers, and rank lookups on boards of 10k to 1M players
+ * - Telemetry: the game thread's cost of recording a drop and a frame
+ *   while the writer thread is running
+ *
+ * For regression tracking, write machine-readable results with
+ *   TowerBuilderBench --benchmark_format=json --benchmark_out=bench.json
+ * or build the perf-baseline and perf-regress targets, which compare the
+ * medians of repeated runs (see perf_compare.cpp).
+ */
+
+#include "drop_policy.h"
+#include "leaderboard.h"
+#include "particle_system.h"
+#include "score_history.h"
+#include "simulation.h"
+#include "telemetry.h"
+#include "timeline.h"
+#include "tower.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdio>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr float BLOCK_HEIGHT = Simulation::BLOCK_HEIGHT;
+
+// A settled block at stack position `index`, laid out like the game does
+Block TowerBlock(int index) {
+    Block block(300.0f, Simulation::SCREEN_HEIGHT - 100 - index * BLOCK_HEIGHT,
+                200.0f, BLOCK_HEIGHT, index, 0.0f);
+    block.isMoving = false;
+    return block;
+}
+
+void FillTower(Tower& tower, int height) {
+    tower.Clear();
+    for (int i = 0; i < height; i++) {
+        tower.Push(TowerBlock(i));
+    }
+}
+
+// ============================================================================
+// STACK - Tower
+// ============================================================================
+
+void BM_TowerPush(benchmark::State& state) {
+    int height = static_cast<int>(state.range(0));
+    Tower tower;
+    for (auto _ : state) {
+        FillTower(tower, height);  // Clear keeps capacity, as on restart
+        benchmark::DoNotOptimize(tower.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * height);
+}
+BENCHMARK(BM_TowerPush)->RangeMultiplier(10)->Range(10, 100000);
+
+// Same, with the game's retention: memory stays bounded as the tower grows
+void BM_TowerPushRetained(benchmark::State& state) {
+    int height = static_cast<int>(state.range(0));
+    Tower tower;
+    tower.SetRetention(512);
+    for (auto _ : state) {
+        FillTower(tower, height);
+        benchmark::DoNotOptimize(tower.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * height);
+}
+BENCHMARK(BM_TowerPushRetained)->RangeMultiplier(10)->Range(10, 100000);
+
+// CPU side of drawing: find the blocks in a screen-sized window at the top
+// of the tower and visit them
+void BM_TowerVisibleRange(benchmark::State& state) {
+    int height = static_cast<int>(state.range(0));
+    Tower tower;
+    FillTower(tower, height);
+
+    float viewBottom = tower.Top().GetBottom() + 200.0f;
+    float viewTop = viewBottom - Simulation::SCREEN_HEIGHT;
+
+    for (auto _ : state) {
+        float widthSum = 0.0f;
+        for (const Block& block : tower.VisibleRange(viewTop, viewBottom)) {
+            widthSum += block.rect.width;
+        }
+        benchmark::DoNotOptimize(widthSum);
+    }
+}
+BENCHMARK(BM_TowerVisibleRange)->RangeMultiplier(10)->Range(10, 100000);
+
+// Walk every block of an endurance-length tower, as a summary or export
+// would. Packed blocks are 6 bytes, so a million of them still fit in L2/L3.
+void BM_TowerTraversePacked(benchmark::State& state) {
+    int height = static_cast<int>(state.range(0));
+    Tower tower;
+    FillTower(tower, height);
+
+    for (auto _ : state) {
+        float widthSum = 0.0f;
+        for (const Block& block : tower) {
+            widthSum += block.rect.width;
+        }
+        benchmark::DoNotOptimize(widthSum);
+    }
+    state.SetItemsProcessed(state.iterations() * height);
+    state.counters["bytes"] = static_cast<double>(height * sizeof(PackedBlock));
+}
+BENCHMARK(BM_TowerTraversePacked)->RangeMultiplier(10)->Range(1000, 1000000);
+
+// The same walk over full Blocks, as the tower used to store them
+void BM_TowerTraverseFullBlocks(benchmark::State& state) {
+    int height = static_cast<int>(state.range(0));
+    std::vector<Block> blocks;
+    for (int i = 0; i < height; i++) {
+        blocks.push_back(TowerBlock(i));
+    }
+
+    for (auto _ : state) {
+        float widthSum = 0.0f;
+        for (const Block& block : blocks) {
+            widthSum += block.rect.width;
+        }
+        benchmark::DoNotOptimize(widthSum);
+    }
+    state.SetItemsProcessed(state.iterations() * height);
+    state.counters["bytes"] = static_cast<double>(height * sizeof(Block));
+}
+BENCHMARK(BM_TowerTraverseFullBlocks)->RangeMultiplier(10)->Range(1000, 1000000);
+
+// ============================================================================
+// LINKED LIST - ScoreHistory
+// ============================================================================
+
+void PrefillHistory(ScoreHistory& history, int64_t games) {
+    for (int64_t i = 0; i < games; i++) {
+        history.AddScore(static_cast<int>((i * 7919) % 5000), static_cast<int>(i % 120));
+    }
+}
+
+void BM_ScoreHistoryAddScore(benchmark::State& state) {
+    ScoreHistory history;
+    PrefillHistory(history, state.range(0));
+
+    int score = 0;
+    for (auto _ : state) {
+        history.AddScore(score, score % 120);
+        score = (score + 37) % 5000;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScoreHistoryAddScore)->RangeMultiplier(10)->Range(1, 10000000);
+
+void BM_ScoreHistoryGetBestScore(benchmark::State& state) {
+    ScoreHistory history;
+    PrefillHistory(history, state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(history.GetBestScore());
+    }
+}
+BENCHMARK(BM_ScoreHistoryGetBestScore)->RangeMultiplier(10)->Range(1, 10000000);
+
+void BM_ScoreHistoryPercentile(benchmark::State& state) {
+    ScoreHistory history;
+    PrefillHistory(history, state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(history.GetScorePercentile(0.99));
+    }
+}
+BENCHMARK(BM_ScoreHistoryPercentile)->RangeMultiplier(100)->Range(1, 10000000);
+
+// ============================================================================
+// RULES - Overlap, trim, movement
+// ============================================================================
+
+void BM_CheckOverlap(benchmark::State& state) {
+    constexpr int PAIRS = 1024;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> x(0.0f, 600.0f);
+    std::uniform_real_distribution<float> width(5.0f, 200.0f);
+
+    std::vector<Block> current, below;
+    for (int i = 0; i < PAIRS; i++) {
+        current.emplace_back(x(rng), 0.0f, width(rng), BLOCK_HEIGHT, 0);
+        below.emplace_back(x(rng), BLOCK_HEIGHT, width(rng), BLOCK_HEIGHT, 0);
+    }
+
+    for (auto _ : state) {
+        int overlapping = 0;
+        for (int i = 0; i < PAIRS; i++) {
+            float start, end;
+            overlapping += Simulation::CheckOverlap(current[i], below[i], start, end);
+        }
+        benchmark::DoNotOptimize(overlapping);
+    }
+    state.SetItemsProcessed(state.iterations() * PAIRS);
+}
+BENCHMARK(BM_CheckOverlap);
+
+// Full drop path: overlap, trim, score, push and spawn, driven by the
+// headless aiming bot; items are blocks stacked
+void BM_DropAndTrim(benchmark::State& state) {
+    Simulation simulation;
+    SimInput input;
+    input.deltaTime = 1.0f / 240.0f;
+
+    int64_t stacked = 0;
+    for (auto _ : state) {
+        // Advance to the next aligned position, then drop
+        for (;;) {
+            if (simulation.IsGameOver()) simulation.Reset();
+            input.drop = std::fabs(simulation.GetCurrentBlock().GetLeft() -
+                                   simulation.GetTower().Top().GetLeft()) <= 3.0f;
+            SimDelta delta = simulation.Step(input);
+            if (delta.dropped) {
+                stacked += delta.stacked;
+                break;
+            }
+        }
+    }
+    state.SetItemsProcessed(stacked);
+}
+BENCHMARK(BM_DropAndTrim);
+
+void BM_SimulationStep(benchmark::State& state) {
+    Simulation simulation;
+    SimInput input;
+    input.deltaTime = 1.0f / 240.0f;
+
+    for (auto _ : state) {
+        simulation.Step(input);
+        benchmark::DoNotOptimize(simulation.GetCurrentBlock().rect.x);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SimulationStep);
+
+// ============================================================================
+// Bots - Drop planning
+// ============================================================================
+
+struct DropPlanCase {
+    float x, width, speed, aim;
+    int direction;
+};
+
+std::vector<DropPlanCase> DropPlanCases(int count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> width(5.0f, 200.0f);
+    std::uniform_real_distribution<float> speed(150.0f, 600.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<DropPlanCase> cases;
+    for (int i = 0; i < count; i++) {
+        DropPlanCase plan;
+        plan.width = width(rng);
+        plan.x = 0.0f;  // Blocks spawn at the left edge
+        plan.speed = speed(rng);
+        plan.aim = unit(rng) * (Simulation::SCREEN_WIDTH - plan.width);
+        plan.direction = unit(rng) < 0.5f ? 1 : -1;
+        cases.push_back(plan);
+    }
+    return cases;
+}
+
+// Predictive policy: the best drop tick in a few divisions
+void BM_BotPlanClosedForm(benchmark::State& state) {
+    std::vector<DropPlanCase> cases = DropPlanCases(1024);
+    const float deltaTime = 1.0f / 240.0f;
+
+    for (auto _ : state) {
+        long long tickSum = 0;
+        for (const DropPlanCase& plan : cases) {
+            BlockMotion motion(plan.x, plan.width, plan.speed, plan.direction, deltaTime);
+            tickSum += motion.PredictDropTick(plan.aim);
+        }
+        benchmark::DoNotOptimize(tickSum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(cases.size()));
+}
+BENCHMARK(BM_BotPlanClosedForm);
+
+// The same plan by stepping UpdateBlockMovement's rule forward over two
+// legs and keeping the closest tick
+void BM_BotPlanStepped(benchmark::State& state) {
+    std::vector<DropPlanCase> cases = DropPlanCases(1024);
+    const float deltaTime = 1.0f / 240.0f;
+
+    for (auto _ : state) {
+        long long tickSum = 0;
+        for (const DropPlanCase& plan : cases) {
+            float x = plan.x;
+            int direction = plan.direction;
+            int turns = 0;
+            float bestDistance = std::fabs(x - plan.aim);
+            long long bestTick = 0;
+            for (long long tick = 1; turns < 2; tick++) {
+                x += plan.speed * direction * deltaTime;
+                int before = direction;
+                if (x + plan.width >= Simulation::SCREEN_WIDTH) {
+                    direction = -1;
+                } else if (x <= 0) {
+                    direction = 1;
+                }
+                turns += direction != before;
+                float distance = std::fabs(x - plan.aim);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    bestTick = tick;
+                }
+            }
+            tickSum += bestTick;
+        }
+        benchmark::DoNotOptimize(tickSum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(cases.size()));
+}
+BENCHMARK(BM_BotPlanStepped);
+
+// ============================================================================
+// Practice timeline - Undo / redo
+// ============================================================================
+
+// A practice game `height` blocks tall, with the game's retention. The bot
+// drops at the sub-tick instant the block lines up with the top, so it
+// never trims and any height is reachable.
+void BuildPracticeGame(Simulation& simulation, Timeline& timeline, int height) {
+    simulation.SetTowerRetention(512);
+    simulation.EnableHistory(true);
+    simulation.Reset();
+    timeline.Start(simulation);
+
+    SimInput input;
+    input.deltaTime = 1.0f / 240.0f;
+    while (simulation.GetTowerHeight() < height) {
+        float velocity = simulation.GetBlockSpeed() * simulation.GetDirection();
+        float alignedIn = (simulation.GetTower().Top().GetLeft() -
+                           simulation.GetCurrentBlock().GetLeft()) / velocity;
+        input.drop = alignedIn >= 0.0f && alignedIn < input.deltaTime;
+        input.dropTime = alignedIn;
+        if (simulation.Step(input).stacked) timeline.OnStacked(simulation);
+    }
+}
+
+SimParams NoSpeedUp() {
+    SimParams params;
+    params.speedIncrement = 0.0f;
+    return params;
+}
+
+// One undo and one redo at the top of the tower: a pop and a push
+void BM_TimelineUndoRedo(benchmark::State& state) {
+    Simulation simulation(NoSpeedUp());
+    Timeline timeline;
+    BuildPracticeGame(simulation, timeline, static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        timeline.Undo(simulation);
+        timeline.Redo(simulation);
+        benchmark::DoNotOptimize(simulation.GetScore());
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_TimelineUndoRedo)->RangeMultiplier(10)->Range(100, 10000);
+
+// Rewind 10 blocks and jump back to the top, like practice mode's X key
+void BM_TimelineRewind(benchmark::State& state) {
+    Simulation simulation(NoSpeedUp());
+    Timeline timeline;
+    int height = static_cast<int>(state.range(0));
+    BuildPracticeGame(simulation, timeline, height);
+
+    for (auto _ : state) {
+        timeline.RewindToHeight(simulation, height - 10);
+        timeline.RewindToHeight(simulation, height);
+        benchmark::DoNotOptimize(simulation.GetScore());
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_TimelineRewind)->RangeMultiplier(10)->Range(100, 10000);
+
+// ============================================================================
+// QUEUE - Upcoming blocks
+// ============================================================================
+
+// Preview: compute the three upcoming blocks on demand
+void BM_QueuePreviewSequence(benchmark::State& state) {
+    Simulation simulation(SimParams(), 7);
+
+    for (auto _ : state) {
+        float widthSum = 0.0f;
+        for (int i = 0; i < 3; i++) {
+            widthSum += simulation.GetUpcomingBlock(i).rect.width;
+        }
+        benchmark::DoNotOptimize(widthSum);
+    }
+}
+BENCHMARK(BM_QueuePreviewSequence);
+
+// Peek(i) costs the same however far ahead it looks
+void BM_QueuePeekAhead(benchmark::State& state) {
+    Simulation simulation(SimParams(), 7);
+    int ahead = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simulation.GetUpcomingBlock(ahead));
+    }
+}
+BENCHMARK(BM_QueuePeekAhead)->RangeMultiplier(100)->Range(1, 10000);
+
+// The old spawn cycle: dequeue the front block, enqueue a new one at the back
+void BM_QueueSpawnStdQueue(benchmark::State& state) {
+    std::queue<Block> queue;
+    for (int i = 0; i < 3; i++) queue.push(TowerBlock(i));
+
+    int colorIndex = 3;
+    for (auto _ : state) {
+        Block next = queue.front();
+        queue.pop();
+        benchmark::DoNotOptimize(next);
+        queue.push(TowerBlock(colorIndex++));
+    }
+}
+BENCHMARK(BM_QueueSpawnStdQueue);
+
+// The old preview: copy the std::queue and pop the copy
+void BM_QueuePreviewStdQueueCopy(benchmark::State& state) {
+    std::queue<Block> queue;
+    for (int i = 0; i < 3; i++) queue.push(TowerBlock(i));
+
+    for (auto _ : state) {
+        std::queue<Block> copy = queue;
+        float widthSum = 0.0f;
+        while (!copy.empty()) {
+            widthSum += copy.front().rect.width;
+            copy.pop();
+        }
+        benchmark::DoNotOptimize(widthSum);
+    }
+}
+BENCHMARK(BM_QueuePreviewStdQueueCopy);
+
+// ============================================================================
+// Particles
+// ============================================================================
+
+// Top the pool up to `count` live debris chunks
+void FillParticles(ParticleSystem& particles, std::size_t count) {
+    while (particles.GetCount() < count) {
+        particles.SpawnDebris(0.0f, 0.0f, 100.0f, 40.0f, 1, 0xFF0000FF);
+    }
+}
+
+// One frame: gravity, velocity and life for every live particle. The step
+// is tiny so none expire and the live count stays put.
+void BM_ParticleUpdate(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    ParticleSystem particles(count);
+    FillParticles(particles, count);
+
+    for (auto _ : state) {
+        particles.Update(1e-7f);
+        benchmark::DoNotOptimize(particles.GetY());
+        if (particles.GetCount() < count) FillParticles(particles, count);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK(BM_ParticleUpdate)->RangeMultiplier(4)->Range(1024, 16384);
+
+// ============================================================================
+// Leaderboard
+// ============================================================================
+
+LeaderboardEntry RandomEntry(std::mt19937_64& rng, std::uint64_t players) {
+    LeaderboardEntry entry;
+    entry.playerId = rng() % players;
+    entry.score = static_cast<std::int32_t>(rng() % 20000);
+    entry.height = entry.score / 70;
+    entry.timestamp = static_cast<std::int64_t>(rng() % 1000000);
+    return entry;
+}
+
+// Submit `count` entries from producer 0, waiting out full lanes, then
+// wait until the workers have applied them
+void SubmitAll(Leaderboard& board, std::mt19937_64& rng, std::uint64_t players, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        LeaderboardEntry entry = RandomEntry(rng, players);
+        while (!board.Submit(0, entry)) std::this_thread::yield();  // Let the workers drain
+    }
+    board.Flush();
+}
+
+// End to end: Submit, drain into batches, apply to the skip lists. One
+// producer; `shards` workers apply in parallel.
+void BM_LeaderboardIngest(benchmark::State& state) {
+    int shards = static_cast<int>(state.range(0));
+    constexpr std::size_t BATCH = 16384;
+    Leaderboard board(shards, 1);
+    board.Open(nullptr);
+    std::mt19937_64 rng(7);
+
+    for (auto _ : state) {
+        SubmitAll(board, rng, 100000, BATCH);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(BATCH));
+}
+BENCHMARK(BM_LeaderboardIngest)->Arg(1)->Arg(4)->UseRealTime();
+
+// The "rank that score earns" lookup behind every ack
+void BM_LeaderboardRankForScore(benchmark::State& state) {
+    std::uint64_t players = static_cast<std::uint64_t>(state.range(0));
+    Leaderboard board(4, 1);
+    board.Open(nullptr);
+    std::mt19937_64 rng(11);
+    SubmitAll(board, rng, players, static_cast<std::size_t>(players) * 2);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(board.GetRankForScore(static_cast<std::int32_t>(rng() % 20000)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LeaderboardRankForScore)->RangeMultiplier(10)->Range(10000, 1000000);
+
+// A player's own rank and best, as the game's HUD asks for it
+void BM_LeaderboardStanding(benchmark::State& state) {
+    std::uint64_t players = static_cast<std::uint64_t>(state.range(0));
+    Leaderboard board(4, 1);
+    board.Open(nullptr);
+    std::mt19937_64 rng(13);
+    SubmitAll(board, rng, players, static_cast<std::size_t>(players) * 2);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(board.GetStanding(rng() % players));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LeaderboardStanding)->RangeMultiplier(10)->Range(10000, 1000000);
+
+// ============================================================================
+// Telemetry
+// ============================================================================
+
+// The writer drains every 5 ms; recording faster than it writes fills the
+// ring, so this also covers the counted-drop path
+void BM_TelemetryRecordDrop(benchmark::State& state) {
+    const char* path = "bench_telemetry.tbtm";
+    if (!Telemetry::Get().Start(path)) {
+        state.SkipWithError("could not open a telemetry file");
+        return;
+    }
+    Telemetry::Get().AttachThread();
+
+    TelemetryDrop drop{};
+    drop.offset = 3.5f;
+    drop.overlapRatio = 0.9f;
+    for (auto _ : state) {
+        drop.tick++;
+        Telemetry::RecordDrop(drop);
+    }
+    state.SetItemsProcessed(state.iterations());
+    Telemetry::Get().Stop();
+    std::remove(path);
+}
+BENCHMARK(BM_TelemetryRecordDrop);
+
+// Per frame: one histogram bucket, plus a push once a simulated second
+void BM_TelemetryRecordFrame(benchmark::State& state) {
+    const char* path = "bench_telemetry.tbtm";
+    if (!Telemetry::Get().Start(path)) {
+        state.SkipWithError("could not open a telemetry file");
+        return;
+    }
+    Telemetry::Get().AttachThread();
+
+    double frameSeconds = 1.0 / 60.0;
+    for (auto _ : state) {
+        Telemetry::RecordFrame(frameSeconds);
+    }
+    state.SetItemsProcessed(state.iterations());
+    Telemetry::Get().Stop();
+    std::remove(path);
+}
+BENCHMARK(BM_TelemetryRecordFrame);
+
+}  // namespace
+
+BENCHMARK_MAIN();
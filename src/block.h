@@ -0,0 +1,101 @@
+/**
+ * Block - the building piece shared by the game and the headless simulation
+ *
+ * Blocks carry no raylib types so the simulation can run without a window.
+ * The game turns BlockRect into a raylib Rectangle and colorIndex into a
+ * palette Color only when drawing.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Palette slots; colorIndex wraps at this many colours when drawn
+constexpr int BLOCK_PALETTE_SIZE = 10;
+
+/**
+ * Axis-aligned rectangle with the same layout as raylib's Rectangle
+ */
+struct BlockRect {
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+/**
+ * Block Structure
+ * Represents a single building block in the tower
+ * Used in STACK data structure for tower management
+ */
+struct Block {
+    BlockRect rect;      // Position and dimensions (x, y, width, height)
+    int colorIndex;      // Palette slot for visual distinction (wraps when drawn)
+    float speed;         // Horizontal movement speed
+    bool isMoving;       // Whether block is currently moving horizontally
+
+    // Constructors
+    Block() : rect{0, 0, 0, 0}, colorIndex(0), speed(0), isMoving(false) {}
+
+    Block(float x, float y, float width, float height, int colorIndex, float speed = 200.0f)
+        : rect{x, y, width, height}, colorIndex(colorIndex), speed(speed), isMoving(true) {}
+
+    // Methods
+    void SetPosition(float x, float y) {
+        rect.x = x;
+        rect.y = y;
+    }
+
+    float GetLeft() const { return rect.x; }
+    float GetRight() const { return rect.x + rect.width; }
+    float GetTop() const { return rect.y; }
+    float GetBottom() const { return rect.y + rect.height; }
+};
+
+/**
+ * PackedBlock - A settled block, 6 bytes instead of sizeof(Block) = 28
+ *
+ * WHY PACKED?
+ * - A settled block never moves again, and its height and y follow from
+ *   its place in the tower, so only x, width and colour are left to store
+ * - x and width are 1/32 px fixed point, well below what a screen can
+ *   show, so a million-block tower is 6 MB instead of 28 MB
+ * - The rules only compare against the top block, which the Tower keeps
+ *   as a full Block, so packing never changes a game's outcome
+ *
+ * Time Complexity:
+ * - Pack / Unpack: O(1)
+ */
+struct PackedBlock {
+    static constexpr float POSITION_SCALE = 32.0f;  // Fixed-point steps per pixel
+    // Widest x range (either sign) and width the fixed point can hold
+    static constexpr float MAX_POSITION = INT16_MAX / POSITION_SCALE;
+
+    std::int16_t x;           // Left edge, 1/POSITION_SCALE px
+    std::uint16_t width;      // 1/POSITION_SCALE px
+    std::uint8_t colorIndex;  // Palette slot, already wrapped
+
+    static PackedBlock Pack(const Block& block) {
+        PackedBlock packed;
+        packed.x = static_cast<std::int16_t>(Quantize(block.rect.x, INT16_MIN, INT16_MAX));
+        packed.width = static_cast<std::uint16_t>(Quantize(block.rect.width, 0, UINT16_MAX));
+        packed.colorIndex = static_cast<std::uint8_t>(block.colorIndex % BLOCK_PALETTE_SIZE);
+        return packed;
+    }
+
+    // Back to a settled Block at the given row
+    Block Unpack(float y, float height) const {
+        Block block(x / POSITION_SCALE, y, width / POSITION_SCALE, height, colorIndex, 0.0f);
+        block.isMoving = false;
+        return block;
+    }
+
+private:
+    static long Quantize(float value, long low, long high) {
+        return std::clamp(std::lround(value * POSITION_SCALE), low, high);
+    }
+};
+
+static_assert(sizeof(PackedBlock) == 6, "PackedBlock should stay 6 bytes");
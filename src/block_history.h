@@ -0,0 +1,73 @@
+/**
+ * BlockHistory - Persistent STACK of blocks with structural sharing
+ *
+ * WHY PERSISTENT?
+ * - Undo has to bring back the tower as it was, and redo the tower as it
+ *   will be again; copying a tower of thousands of blocks per snapshot
+ *   would make every stacked block O(height)
+ * - Here a pushed block becomes an immutable node pointing at the node
+ *   below it. A whole tower is then just the id of its top node, and
+ *   towers that share a bottom share those nodes
+ * - Nodes live in one arena (a vector indexed by id), so a push is an
+ *   append and nothing is ever freed individually
+ *
+ * Undoing and pushing a different block creates a branch: both tops stay
+ * valid, and walking their parents meets at the common part.
+ *
+ * Time Complexity:
+ * - Push: O(1) amortized
+ * - GetBlock / GetParent / GetDepth: O(1)
+ * - CommonAncestor: O(blocks where the two towers differ)
+ */
+
+#pragma once
+
+#include "block.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BlockHistory {
+public:
+    using NodeId = std::uint32_t;
+    static constexpr NodeId EMPTY = UINT32_MAX;  // The empty tower
+
+    // STACK: Push onto the tower whose top is `parent`; returns the new top
+    NodeId Push(NodeId parent, const Block& block) {
+        nodes.push_back(Node{block, parent, GetDepth(parent) + 1});
+        return static_cast<NodeId>(nodes.size() - 1);
+    }
+
+    const Block& GetBlock(NodeId id) const { return nodes[id].block; }
+    NodeId GetParent(NodeId id) const { return nodes[id].parent; }
+
+    // Tower height with `id` on top (0 for EMPTY)
+    std::uint32_t GetDepth(NodeId id) const { return id == EMPTY ? 0 : nodes[id].depth; }
+
+    // Highest node both towers contain (EMPTY if they share nothing)
+    NodeId CommonAncestor(NodeId a, NodeId b) const {
+        while (GetDepth(a) > GetDepth(b)) a = GetParent(a);
+        while (GetDepth(b) > GetDepth(a)) b = GetParent(b);
+        while (a != b) {
+            a = GetParent(a);
+            b = GetParent(b);
+        }
+        return a;
+    }
+
+    // Forget every node; ids handed out before are invalid afterwards.
+    // Keeps the arena's capacity for the next game.
+    void Clear() { nodes.clear(); }
+
+    size_t GetNodeCount() const { return nodes.size(); }
+
+private:
+    struct Node {
+        Block block;
+        NodeId parent;
+        std::uint32_t depth;
+    };
+
+    std::vector<Node> nodes;
+};
@@ -0,0 +1,72 @@
+/**
+ * BlockSequence - Seeded, counter-based description of every block a game will spawn
+ *
+ * WHY COUNTER-BASED?
+ * - The upcoming blocks used to be built ahead of time and copied through
+ *   a queue, so every engine had to maintain that queue on each spawn
+ * - Here block `index` (its position in the tower, 0 = base) is a pure
+ *   function of (seed, index): any block, however far ahead, is computed
+ *   on demand and nothing is stored
+ * - The headless and batch engines never ask for a block they don't
+ *   spawn, and the preview can look ahead as far as it likes
+ *
+ * What the sequence decides is the colour. A block's width and speed are
+ * rules, not luck: it spawns as wide as the top of the tower, at the speed
+ * the tower's height has reached (see Simulation::GetUpcomingBlock).
+ *
+ * Colours step through the palette by a seeded stride coprime to its size,
+ * so neighbouring blocks never share a colour. Seed 0 is the classic
+ * sequence: block i gets palette slot i.
+ *
+ * Time Complexity:
+ * - GetColorIndex: O(1)
+ */
+
+#pragma once
+
+#include "block.h"
+
+#include <cstdint>
+
+class BlockSequence {
+public:
+    explicit BlockSequence(std::uint64_t seed = 0) : seed(seed) {
+        if (seed == 0) return;
+
+        std::uint64_t hash = Mix(seed);
+        offset = static_cast<int>(hash % BLOCK_PALETTE_SIZE);
+        stride = 1 + static_cast<int>((hash >> 32) % (BLOCK_PALETTE_SIZE - 1));
+        while (GreatestCommonDivisor(stride, BLOCK_PALETTE_SIZE) != 1) {
+            stride = stride % (BLOCK_PALETTE_SIZE - 1) + 1;
+        }
+    }
+
+    std::uint64_t GetSeed() const { return seed; }
+
+    // Palette slot of the block at tower position `index`
+    int GetColorIndex(std::uint64_t index) const {
+        return static_cast<int>((offset + index * stride) % BLOCK_PALETTE_SIZE);
+    }
+
+private:
+    std::uint64_t seed;
+    int offset = 0;
+    int stride = 1;
+
+    // SplitMix64 finalizer
+    static std::uint64_t Mix(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    static int GreatestCommonDivisor(int a, int b) {
+        while (b != 0) {
+            int rest = a % b;
+            a = b;
+            b = rest;
+        }
+        return a;
+    }
+};
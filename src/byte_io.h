@@ -0,0 +1,86 @@
+/**
+ * Byte I/O - Little-endian and varint encoding shared by the wire formats
+ *
+ * Used by replays (replay.h) and spectator packets (spectator.h). Varints
+ * are LEB128 unsigned: 7 bits per byte, high bit set on every byte but
+ * the last. Signed values are zigzag-mapped first, so small negative
+ * numbers stay short too.
+ *
+ * Time Complexity: O(bytes written or read)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+inline void PutVarint(std::vector<std::uint8_t>& bytes, std::uint64_t value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+inline std::uint64_t ZigZagEncode(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t ZigZagDecode(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+inline void PutFixed(std::vector<std::uint8_t>& bytes, std::uint64_t value, int byteCount) {
+    for (int i = 0; i < byteCount; i++) {
+        bytes.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+inline void PutFloat(std::vector<std::uint8_t>& bytes, float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    PutFixed(bytes, bits, 4);
+}
+
+// Bounds-checked reader; any overrun latches `ok` to false
+struct ByteReader {
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t offset = 0;
+    bool ok = true;
+
+    std::uint64_t Fixed(int byteCount) {
+        if (size - offset < static_cast<std::size_t>(byteCount)) {
+            ok = false;
+            return 0;
+        }
+        std::uint64_t value = 0;
+        for (int i = 0; i < byteCount; i++) {
+            value |= static_cast<std::uint64_t>(data[offset++]) << (8 * i);
+        }
+        return value;
+    }
+
+    std::uint64_t Varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (offset == size) break;
+            std::uint8_t byte = data[offset++];
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::int64_t SignedVarint() { return ZigZagDecode(Varint()); }
+
+    float Float() {
+        std::uint32_t bits = static_cast<std::uint32_t>(Fixed(4));
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
@@ -0,0 +1,309 @@
+/**
+ * DropPolicy - Decides when a simulated player presses drop
+ *
+ * Used by the batch tools to stand in for a human. Each policy owns its
+ * own seeded random generator, so a game's outcome depends only on its
+ * seed and never on which thread ran it.
+ *
+ * Policies:
+ * - FixedOffset:    drop when the block's left edge crosses top.x + offset
+ * - GaussianJitter: like FixedOffset, plus a fresh N(0, sigma) error per block
+ * - ReactionTime:   notice alignment with the top block, then press after a
+ *                   Gaussian reaction delay minus an anticipation lead
+ * - Predictive:     work out in closed form which tick puts the block
+ *                   closest to the top block, then press on that tick,
+ *                   with an N(0, sigma) aim error and an N(0, reaction-sd)
+ *                   timing error
+ *
+ * WHY CLOSED FORM?
+ * - Within one block the moving block's speed is fixed, so after k ticks
+ *   it sits at x0 + j * step for an integer j that walks back and forth
+ *   between the two wall bounces of UpdateBlockMovement
+ * - The reachable positions, the best of them and the first tick that
+ *   reaches it are a few divisions away (PredictDropTick), so planning a
+ *   block costs the same however long it takes to arrive, and every tick
+ *   after that is a counter decrement
+ * - Stepping a copy of the game forward to search for the best tick would
+ *   cost O(ticks) per block, and thousands of bots per second would spend
+ *   most of their time simulating games twice
+ *
+ * The prediction is exact up to float rounding: the simulation adds the
+ * step once per tick, the plan multiplies it. Near a wall the two can
+ * bounce a tick apart, so a plan whose target lies beyond the next bounce
+ * waits for the real bounce (the policy applies the same wall check to the
+ * x it observes) and plans again from there, where the target is on the
+ * leg ahead.
+ */
+
+#pragma once
+
+#include "simulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+
+enum class DropPolicyKind {
+    FixedOffset,
+    GaussianJitter,
+    ReactionTime,
+    Predictive
+};
+
+struct DropPolicyConfig {
+    DropPolicyKind kind = DropPolicyKind::GaussianJitter;
+    float offset = 0.0f;           // Aim point relative to the top block (px)
+    float jitterSigma = 4.0f;      // GaussianJitter, Predictive: aim error std-dev (px)
+    float reactionMeanMs = 200.0f; // ReactionTime: mean press delay
+    float reactionSdMs = 40.0f;    // ReactionTime: delay std-dev; Predictive: timing error
+    float anticipationMs = 170.0f; // ReactionTime: how early the player commits
+};
+
+// Command-line name of a policy: fixed, gaussian, reaction or predictive
+inline bool ParseDropPolicyKind(const char* name, DropPolicyKind& kind) {
+    if (std::strcmp(name, "fixed") == 0) {
+        kind = DropPolicyKind::FixedOffset;
+    } else if (std::strcmp(name, "gaussian") == 0) {
+        kind = DropPolicyKind::GaussianJitter;
+    } else if (std::strcmp(name, "reaction") == 0) {
+        kind = DropPolicyKind::ReactionTime;
+    } else if (std::strcmp(name, "predictive") == 0) {
+        kind = DropPolicyKind::Predictive;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// SplitMix64 - spreads consecutive game indices into unrelated seeds
+inline std::uint64_t MixSeed(std::uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// Seed of game `game` in a run seeded with `runSeed`; shared by the batch
+// tools so the same run seed plays the same games in each of them
+inline std::uint64_t GameSeed(std::uint64_t runSeed, long long game) {
+    return MixSeed(runSeed ^ MixSeed(static_cast<std::uint64_t>(game)));
+}
+
+/**
+ * Closed-form motion of the moving block over whole ticks, mirroring
+ * Simulation::UpdateBlockMovement: every tick moves the block one `step`
+ * (blockSpeed * deltaTime) in its direction, then turns it around if it
+ * has reached a wall. Positions are lattice indices j, x = x0 + j * step.
+ */
+class BlockMotion {
+public:
+    BlockMotion(float x0, float width, float blockSpeed, int direction, float deltaTime)
+        : x0(x0),
+          step(static_cast<double>(blockSpeed) * deltaTime),
+          direction(direction >= 0 ? 1 : -1) {
+        if (!(step > 0.0)) {
+            step = 0.0;
+            return;
+        }
+        // Last lattice point at or past each wall, which is where the block
+        // turns when it reaches it travelling towards that wall
+        double travel = static_cast<double>(Simulation::SCREEN_WIDTH) - width;
+        high = static_cast<long long>(std::ceil((travel - x0) / step));
+        low = static_cast<long long>(std::floor(-x0 / step));
+
+        // The wall the first leg ends at. A block spawned on or past a wall,
+        // moving into it, still takes one step before the check turns it.
+        firstTurn = this->direction > 0 ? std::max(1LL, high) : std::min(-1LL, low);
+    }
+
+    bool IsMoving() const { return step > 0.0; }
+
+    // Ticks until the first turn at a wall
+    long long GetTurnTicks() const {
+        return IsMoving() ? firstTurn * direction : std::numeric_limits<long long>::max();
+    }
+
+    // Lattice index after `ticks` ticks
+    long long IndexAt(long long ticks) const {
+        if (!IsMoving() || ticks <= 0) return 0;
+
+        long long firstLeg = firstTurn * direction;  // |firstTurn - 0|
+        if (ticks <= firstLeg) return direction * ticks;
+
+        // Then back and forth between the walls, starting back from firstTurn
+        long long back = firstTurn - (direction > 0 ? low : high);  // Signed length of leg 2
+        long long remaining = ticks - firstLeg;
+        long long secondLeg = back < 0 ? -back : back;
+        if (remaining <= secondLeg) return firstTurn - direction * remaining;
+
+        long long span = high - low;
+        long long phase = (remaining - secondLeg) % (2 * span);
+        long long wall = direction > 0 ? low : high;
+        long long away = phase <= span ? phase : 2 * span - phase;
+        return wall + direction * away;
+    }
+
+    // x after `ticks` ticks
+    float XAt(long long ticks) const {
+        return static_cast<float>(x0 + static_cast<double>(IndexAt(ticks)) * step);
+    }
+
+    /**
+     * First tick (at least 1) after which the block is as close to `aimX`
+     * as it can get. Dropping at the end of that tick maximizes overlap
+     * with a top block whose left edge is aimX.
+     */
+    long long PredictDropTick(float aimX) const {
+        if (!IsMoving()) return 1;
+
+        double ideal = std::round((aimX - x0) / step);
+        long long target = static_cast<long long>(std::clamp(ideal, static_cast<double>(low),
+                                                             static_cast<double>(high)));
+
+        // On the first leg, ahead of the block
+        long long ahead = target * direction;
+        long long firstLeg = firstTurn * direction;
+        if (ahead >= 1 && ahead <= firstLeg) return ahead;
+
+        // Otherwise on the way back, which covers every point between walls
+        long long back = (firstTurn - target) * direction;
+        return firstLeg + back;
+    }
+
+private:
+    double x0;
+    double step;      // Distance per tick, px
+    int direction;    // At tick 0
+    long long high = 0;       // Turning index at the right wall
+    long long low = 0;        // Turning index at the left wall
+    long long firstTurn = 0;  // Where the first leg turns
+};
+
+class DropPolicy {
+public:
+    DropPolicy(const DropPolicyConfig& config, std::uint64_t seed)
+        : config(config), rng(seed), targetX(0), previousX(0),
+          pressDelay(0), noticed(false) {}
+
+    // Call after Reset() and after every successful stack
+    void BeginBlock(const Simulation& simulation) {
+        BeginBlock(simulation.GetCurrentBlock().GetLeft(),
+                   simulation.GetCurrentBlock().rect.width,
+                   simulation.GetTower().Top().GetLeft(),
+                   simulation.GetBlockSpeed(), simulation.GetDirection());
+    }
+
+    // Call once per tick, after the previous Step()
+    bool ShouldDrop(const Simulation& simulation, float deltaTime) {
+        return ShouldDrop(simulation.GetCurrentBlock().GetLeft(), deltaTime);
+    }
+
+    // Engine-neutral forms, used directly by BatchSimulation lanes
+    void BeginBlock(float currentX, float currentWidth, float topX,
+                    float blockSpeed, int direction) {
+        float aim = topX + config.offset;
+        if (config.kind == DropPolicyKind::Predictive) {
+            BeginPredictive(currentX, currentWidth, aim, blockSpeed, direction);
+            return;
+        }
+        if (config.kind == DropPolicyKind::GaussianJitter) {
+            std::normal_distribution<float> jitter(0.0f, config.jitterSigma);
+            aim += jitter(rng);
+        }
+
+        // Keep the aim point inside the block's travel so it is always crossed
+        float maxX = Simulation::SCREEN_WIDTH - currentWidth;
+        targetX = std::clamp(aim, 0.0f, std::max(0.0f, maxX));
+        previousX = currentX;
+        noticed = false;
+        pressDelay = 0.0f;
+    }
+
+    bool ShouldDrop(float x, float deltaTime) {
+        if (config.kind == DropPolicyKind::Predictive) {
+            return ShouldDropPredictive(x, deltaTime);
+        }
+
+        bool crossed = (previousX <= targetX && x >= targetX) ||
+                       (previousX >= targetX && x <= targetX);
+        previousX = x;
+
+        if (config.kind != DropPolicyKind::ReactionTime) {
+            return crossed;
+        }
+
+        if (!noticed) {
+            if (!crossed) return false;
+            std::normal_distribution<float> reaction(config.reactionMeanMs,
+                                                     config.reactionSdMs);
+            pressDelay = std::max(0.0f, reaction(rng) - config.anticipationMs) / 1000.0f;
+            noticed = true;
+        }
+
+        pressDelay -= deltaTime;
+        return pressDelay <= 0.0f;
+    }
+
+private:
+    DropPolicyConfig config;
+    std::mt19937_64 rng;
+    float targetX;      // Left edge position the player aims for
+    float previousX;    // Block position last tick, to detect crossing
+    float pressDelay;   // ReactionTime: seconds left before the press lands
+    bool noticed;       // ReactionTime: player has seen the alignment
+
+    // Predictive: the moving block, and the plan for it
+    float blockWidth = 0.0f;
+    float speed = 0.0f;
+    int blockDirection = 1;      // Mirrors the simulation's direction
+    float timingError = 0.0f;    // Seconds the press lands off the plan
+    bool planned = false;
+    bool committed = false;      // The target is on the current leg
+    long long ticksToDrop = 0;
+
+    void BeginPredictive(float currentX, float currentWidth, float aim,
+                         float blockSpeed, int direction) {
+        std::normal_distribution<float> aimError(0.0f, config.jitterSigma);
+        std::normal_distribution<float> pressError(0.0f, config.reactionSdMs);
+        targetX = aim + aimError(rng);
+        timingError = pressError(rng) / 1000.0f;
+        previousX = currentX;
+        blockWidth = currentWidth;
+        speed = blockSpeed;
+        blockDirection = direction;
+        planned = false;
+    }
+
+    bool ShouldDropPredictive(float x, float deltaTime) {
+        // The plan needs the tick length, which arrives with the first tick
+        if (!planned) {
+            planned = true;
+            Plan(x, deltaTime);
+        } else if (!committed) {
+            // Same wall check as UpdateBlockMovement, on the same floats
+            int direction = blockDirection;
+            if (x + blockWidth >= Simulation::SCREEN_WIDTH) {
+                direction = -1;
+            } else if (x <= 0) {
+                direction = 1;
+            }
+            if (direction == blockDirection) return false;
+            blockDirection = direction;
+            Plan(x, deltaTime);
+        }
+        return committed && --ticksToDrop == 0;
+    }
+
+    void Plan(float x, float deltaTime) {
+        BlockMotion motion(x, blockWidth, speed, blockDirection, deltaTime);
+        long long tick = motion.PredictDropTick(targetX);
+        committed = tick <= motion.GetTurnTicks();
+        if (!committed) return;  // Plan again after the bounce
+
+        long long offset = static_cast<long long>(std::lround(timingError / deltaTime));
+        ticksToDrop = std::max(1LL, tick + offset);
+    }
+};
@@ -0,0 +1,58 @@
+/**
+ * FixedTimestep - Turns variable frame times into whole simulation ticks
+ *
+ * WHY A FIXED TIMESTEP?
+ * - Stepping the simulation with GetFrameTime() made block positions, and
+ *   with them trims, scores and game outcomes, depend on the frame rate
+ * - Accumulating frame time and stepping in constant ticks makes the game
+ *   follow exactly the same float arithmetic as the headless tools at the
+ *   same tick rate, whatever the render rate is
+ * - The remainder left in the accumulator (GetAlpha) lets the renderer
+ *   interpolate between the last two ticks, so motion stays smooth when
+ *   the frame rate and the tick rate do not line up
+ *
+ * Usage, once per rendered frame:
+ *
+ *     timestep.AddFrameTime(GetFrameTime());
+ *     while (timestep.ConsumeTick()) simulation.Step({timestep.GetTickSeconds(), ...});
+ *     Draw(timestep.GetAlpha());
+ */
+
+#pragma once
+
+class FixedTimestep {
+public:
+    static constexpr float DEFAULT_TICK_RATE = 240.0f;  // Same default as the headless tools
+    static constexpr float MAX_FRAME_TIME = 0.25f;      // Longer stalls are dropped, not replayed
+
+    explicit FixedTimestep(float tickRate = DEFAULT_TICK_RATE)
+        : tickSeconds(1.0f / tickRate), accumulator(0.0f) {}
+
+    // Bank one frame's worth of real time. Clamped so a long stall (window
+    // drag, debugger) does not trigger a burst of catch-up ticks.
+    void AddFrameTime(float seconds) {
+        accumulator += seconds < MAX_FRAME_TIME ? seconds : MAX_FRAME_TIME;
+    }
+
+    // True if a whole tick is banked; removes it from the accumulator
+    bool ConsumeTick() {
+        if (accumulator < tickSeconds) return false;
+        accumulator -= tickSeconds;
+        return true;
+    }
+
+    // Fraction of the next tick already elapsed, in [0, 1)
+    float GetAlpha() const { return accumulator / tickSeconds; }
+
+    // Real time banked but not yet simulated (seconds)
+    float GetAccumulated() const { return accumulator; }
+
+    // Simulation delta per tick; pass this exact value to Simulation::Step
+    float GetTickSeconds() const { return tickSeconds; }
+
+    void Reset() { accumulator = 0.0f; }
+
+private:
+    float tickSeconds;
+    float accumulator;  // Real time not yet simulated
+};
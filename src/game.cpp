@@ -1,12 +1,16 @@
 /**
  * Tower Builder - C++ Game with Data Structures
- * Single-file implementation
+ * raylib front-end
  *
  * This game demonstrates three fundamental data structures:
  *
- * 1. STACK - Used for the tower of blocks (LIFO structure)
- * 2. QUEUE - Used for upcoming block preview (FIFO structure)
- * 3. LINKED LIST - Used for game score history (dynamic size)
+ * 1. STACK - Used for the tower of blocks (LIFO structure)        -> tower.h
+ * 2. QUEUE - Used for upcoming block preview (FIFO structure)     -> simulation.h
+ * 3. LINKED LIST - Used for game score history (dynamic size)     -> score_history.h
+ *
+ * The game rules live in the raylib-free Simulation (simulation.h) so they
+ * can also run headless. This file reads input, steps the simulation and
+ * draws the result.
  *
  * How to Play:
  * - Blocks move horizontally across the screen
@@ -16,530 +20,1119 @@
  * - Game ends when you miss completely
  *
  * Controls:
- * - SPACE: Drop block
+ * - SPACE: Drop block (split-screen: SPACE / ENTER / A / L for players 1-4)
  * - P: Pause/Unpause
  * - R: Restart (when game over)
+ * - Z / Y / X: Undo / Redo / Rewind 10 blocks (practice mode)
+ * - F3 / F4: Profiler overlay / Chrome trace capture (non-Release builds)
+ *
+ * Run with --players N (1-4) for local split-screen: every player gets
+ * their own Simulation (tower and moving block) in a viewport, and
+ * all towers are drawn in one shared batch.
+ *
+ * --spectate [PORT] streams every player's game to spectators;
+ * --watch HOST[:PORT] [--stream N] turns this window into such a
+ * spectator, mirroring player N's game (see spectator.h).
+ *
+ * --leaderboard HOST[:PORT] [--player ID] submits every finished game's
+ * replay to a TowerBuilderLeaderboard server and shows the world best and
+ * this player's global rank under "Best" (see leaderboard_net.h). The id
+ * defaults to one generated once and kept in player_id.txt.
+ *
+ * --bots N hands the last N players to the predictive bot (see
+ * drop_policy.h) as AI opponents; --autoplay hands it every player and
+ * restarts each match by itself, as an attract-mode demo. Bot games are
+ * not scored, logged or replayed.
+ *
+ * --telemetry [FILE] writes per-drop and per-game metrics and frame-time
+ * histograms to a columnar file from a background thread (see telemetry.h).
+ *
+ * --practice starts a single-player practice game: every stacked block
+ * can be undone and redone, and misses can be taken back (see
+ * timeline.h). Practice games are not scored, logged or replayed.
+ *
+ * Assets (sounds, fonts, textures) come from the assets.tbab bundle and
+ * stream in after the first frame (see asset_loader.h); the game runs
+ * without them until they arrive, or without a bundle at all.
  */
 
 #include "raylib.h"
-#include <stack>
-#include <queue>
-#include <vector>
-#include <string>
-#include <sstream>
+#include "asset_loader.h"
+#include "block.h"
+#include "tower.h"
+#include "score_history.h"
+#include "score_log.h"
+#include "simulation.h"
+#include "palette.h"
+#include "tower_renderer.h"
+#include "particle_system.h"
+#include "render_layer.h"
+#include "fixed_timestep.h"
+#include "input_sampler.h"
+#include "drop_policy.h"
+#include "replay.h"
+#include "spectator_net.h"
+#include "leaderboard_net.h"
+#include "timeline.h"
+#include "telemetry.h"
+#include "profiler.h"
+
 #include <algorithm>
-#include <cmath>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <random>
 
 // ============================================================================
-// BLOCK STRUCTURE
+// GAME CLASS - INTEGRATES ALL DATA STRUCTURES
 // ============================================================================
 
 /**
- * Block Structure
- * Represents a single building block in the tower
- * Used in STACK data structure for tower management
+ * Game Class - Main Game Controller
+ *
+ * Integrates all three data structures:
+ * 1. STACK - Tower management (one per player)
+ * 2. QUEUE - Upcoming blocks preview (one per player)
+ * 3. LINKED LIST - Score history (shared)
+ *
+ * Split-screen players share the clock, the score history and the cached
+ * layers; everything a game needs on its own lives in Player.
  */
-struct Block {
-    Rectangle rect;      // Position and dimensions (x, y, width, height)
-    Color color;         // Block color for visual distinction
-    float speed;         // Horizontal movement speed
-    bool isMoving;       // Whether block is currently moving horizontally
+class Game {
+public:
+    static constexpr int MAX_PLAYERS = 4;
 
-    // Constructors
-    Block() : rect{0, 0, 0, 0}, color(WHITE), speed(0), isMoving(false) {}
+private:
+    /**
+     * One local player: an independent game with its own drop key,
+     * viewport camera and replay
+     */
+    struct Player {
+        Simulation simulation;        // STACK + QUEUE: Tower and upcoming blocks
+        ReplayRecorder replay;        // Drops of the current game, for verification
+        SpectatorFeed spectatorFeed;  // Deltas of the current game for spectators
+        TowerRenderer towerRenderer;  // Cached, batched geometry of the STACK
+        Timeline timeline;            // Undo/redo snapshots (practice mode only)
+        ParticleSystem particles;     // Trim debris and perfect-placement sparkles
+        DropPolicy bot{DropPolicyConfig(), 0};  // Presses drop when isBot
+
+        bool isBot = false;           // Played by the predictive bot
+
+        int dropKey = KEY_SPACE;
+        const char* dropKeyName = "SPACE";
+        bool dropPending = false;     // Drop key seen, waiting for its tick
+        double dropPressTime = 0.0;   // GetTime() of the pending press
+        float previousBlockX = 0.0f;  // Moving block x one tick ago, for interpolation
+        float cameraScroll = 0.0f;    // World pixels the view has moved up
+
+        double blockSpawnTime = 0.0;  // Simulation seconds the moving block appeared at
+        TelemetryGame gameStats{};    // Counted during the game, recorded at game over
+    };
 
-    Block(float x, float y, float width, float height, Color color, float speed = 200.0f)
-        : rect{x, y, width, height}, color(color), speed(speed), isMoving(true) {}
+    // Drop keys by player; SPACE for a single player
+    static constexpr int DROP_KEYS[MAX_PLAYERS] = { KEY_SPACE, KEY_ENTER, KEY_A, KEY_L };
+    static constexpr const char* DROP_KEY_NAMES[MAX_PLAYERS] = { "SPACE", "ENTER", "A", "L" };
 
-    // Methods
-    void Draw() const {
-        DrawRectangleRec(rect, color);
-        DrawRectangleLinesEx(rect, 2.0f, BLACK);
-    }
+    std::array<Player, MAX_PLAYERS> players;
+    int playerCount;
+    bool practice;                    // Undo/redo enabled, games not recorded
+    bool autoplay;                    // Every player is a bot; matches restart themselves
+    double autoplayRestartTime;       // When the finished match restarts; < 0 = not set
 
-    void SetPosition(float x, float y) {
-        rect.x = x;
-        rect.y = y;
-    }
+    // Shared data structures
+    ScoreHistory scoreHistory;        // LINKED LIST: Game history
+    ScoreLog scoreLog;                // On-disk history, survives restarts
+    std::uint64_t gameTick;           // Simulation ticks since the match started
+    std::uint64_t matchSeed;          // Block sequence every player of the match shares
+    std::mt19937_64 seedSource;       // Picks each match's seed
+    SpectatorServer spectators;       // Displays mirroring the games (--spectate)
+    LeaderboardClient leaderboard;    // Global ranking of verified replays (--leaderboard)
+
+    // Off-screen layers, redrawn only when their content changes
+    RenderLayer towerLayer;           // Every settled tower (all but the moving blocks)
+    RenderLayer staticHudLayer;       // Text that never changes
+    RenderLayer hudLayer;             // Score text, redrawn when a value changes
+    RenderLayer gameOverLayer;        // Game over overlay, redrawn once per game
+
+    /**
+     * Everything the HUD text shows. Formatting and glyph layout happen
+     * only when this changes (a drop, game over, pause, restart); other
+     * frames just composite the cached layer.
+     */
+    struct PlayerHud {
+        int score = -1;
+        int height = -1;
+        int consecutivePerfects = -1;
+        bool gameOver = false;
+
+        bool operator==(const PlayerHud& other) const {
+            return score == other.score && height == other.height &&
+                   consecutivePerfects == other.consecutivePerfects &&
+                   gameOver == other.gameOver;
+        }
+    };
 
-    float GetLeft() const { return rect.x; }
-    float GetRight() const { return rect.x + rect.width; }
-    float GetTop() const { return rect.y; }
-    float GetBottom() const { return rect.y + rect.height; }
-};
+    struct HudValues {
+        std::array<PlayerHud, MAX_PLAYERS> players;
+        int bestScore = -1;
+        int games = -1;
+        int worldBest = -1;             // Leaderboard values, -1 until the server answers
+        long long worldRank = -1;
+        long long worldPlayers = -1;
+        int latencySamples = -1;    // Latency stats change only with a new sample
+        bool paused = false;
+
+        bool operator==(const HudValues& other) const {
+            return players == other.players && bestScore == other.bestScore &&
+                   games == other.games && worldBest == other.worldBest &&
+                   worldRank == other.worldRank && worldPlayers == other.worldPlayers &&
+                   latencySamples == other.latencySamples &&
+                   paused == other.paused;
+        }
+        bool operator!=(const HudValues& other) const { return !(*this == other); }
+    };
+    HudValues hudValues;              // Values the cached HUD layers were drawn with
 
-// ============================================================================
-// TOWER CLASS - STACK DATA STRUCTURE
-// ============================================================================
+    // Front-end state
+    FixedTimestep timestep;           // Real time -> constant simulation ticks
+    InputSampler input;               // Timestamped key presses, sampled ~1 kHz
+    bool isPaused;
 
-/**
- * Tower Class - Demonstrates STACK Data Structure
- *
- * WHY STACK?
- * - Blocks are stacked on top of each other (LIFO - Last In, First Out)
- * - The most recently placed block is at the top
- * - We only interact with the top block for comparison
- * - Natural fit for a tower building game
- *
- * Time Complexity:
- * - Push: O(1) - Add block to top
- * - Pop: O(1) - Remove block from top
- * - Peek: O(1) - View top block
- */
-class Tower {
-private:
-    std::stack<Block> towerStack;  // STACK: Core data structure for tower
-    int height;                     // Number of blocks in tower
+    /**
+     * Input-to-present latency: time from a drop press to the end of the
+     * first frame that shows its result (EndDrawing has swapped buffers).
+     * Display scan-out comes on top of this.
+     */
+    struct LatencyStats {
+        double last = 0.0;
+        double worst = 0.0;
+        double sum = 0.0;
+        int count = 0;
+
+        void Add(double seconds) {
+            last = seconds;
+            if (seconds > worst) worst = seconds;
+            sum += seconds;
+            count++;
+        }
+        double GetMean() const { return count > 0 ? sum / count : 0.0; }
+    };
+    LatencyStats dropLatency;
+    bool latencyPending;              // A drop was simulated, not yet presented
+    double latencyPressTime;          // Press time of that drop
+    double lastUpdateTime;            // GetTime() at the previous Update
+    AssetLoader* assets;              // Streamed-in assets; nullptr = none
 
-public:
-    Tower() : height(0) {}
+#ifdef TOWERBUILDER_PROFILER
+    bool showProfiler = false;        // F3: frame time overlay
+    static constexpr const char* PROFILE_TRACE_PATH = "profile_trace.json";
+#endif
 
-    // STACK OPERATION: Push - O(1)
-    void Push(const Block& block) {
-        towerStack.push(block);  // LIFO: Last block in is on top
-        height++;
+    // Game constants
+    static constexpr size_t MAX_STORED_GAMES = 1000;  // Ring size for the history list
+    static constexpr const char* SCORE_LOG_PATH = "score_history.bin";
+    static constexpr const char* REPLAY_DIR = "replays";  // One .tbr file per game
+
+    // Optional bundle assets, played once they have streamed in
+    static constexpr const char* SOUND_DROP = "sounds/drop.wav";
+    static constexpr const char* SOUND_PERFECT = "sounds/perfect.wav";
+    static constexpr const char* SOUND_GAME_OVER = "sounds/gameover.wav";
+    static constexpr const char* MUSIC_TRACK = "sounds/music.ogg";
+    static constexpr float BLOCK_HEIGHT = Simulation::BLOCK_HEIGHT;
+    static constexpr float SCREEN_WIDTH = Simulation::SCREEN_WIDTH;
+    static constexpr float SCREEN_HEIGHT = Simulation::SCREEN_HEIGHT;
+
+    // Camera: once the moving block climbs above CAMERA_LEAD_Y the view
+    // scrolls with it, so it never spawns off-screen
+    static constexpr float CAMERA_LEAD_Y = 200.0f;
+
+    // STACK: Blocks kept in memory; older ones are compacted into a summary.
+    // Several screens' worth, so compaction never touches a visible block.
+    static constexpr size_t TOWER_RETAINED_BLOCKS = 512;
+
+    // Practice mode: X rewinds this many blocks
+    static constexpr int PRACTICE_REWIND_BLOCKS = 10;
+
+    // Bots: a good human's aim and timing error (see DropPolicy::Predictive)
+    static constexpr float BOT_AIM_SIGMA = 2.0f;                 // px
+    static constexpr float BOT_TIMING_SD_MS = 10.0f;
+    static constexpr double AUTOPLAY_RESTART_SECONDS = 3.0;     // Game over screen, then again
+
+    // Particle effects
+    static constexpr double MAX_EFFECT_STEP_SECONDS = 0.1;    // Longest particle step per frame
+    static constexpr std::uint32_t SPARKLE_COLOR = 0xFFF5C0FF;  // Pale gold, 0xRRGGBBAA
+
+    // ------------------------------------------------------------------------
+    // Viewports
+    // ------------------------------------------------------------------------
+
+    /**
+     * Where player `index` is drawn. Every player sees the whole
+     * single-player screen, scaled into a cell: full screen for one
+     * player, side by side for two, a 2x2 grid for three or four.
+     */
+    ViewTransform GetViewport(int index) const {
+        ViewTransform view;
+        if (playerCount == 1) return view;
+
+        int columns = 2;
+        int rows = playerCount > 2 ? 2 : 1;
+        float cellWidth = SCREEN_WIDTH / columns;
+        float cellHeight = SCREEN_HEIGHT / rows;
+
+        view.scale = std::min(cellWidth / SCREEN_WIDTH, cellHeight / SCREEN_HEIGHT);
+        view.offsetX = (index % columns) * cellWidth
+                     + (cellWidth - SCREEN_WIDTH * view.scale) / 2;
+        view.offsetY = (index / columns) * cellHeight
+                     + (cellHeight - SCREEN_HEIGHT * view.scale) / 2;
+        return view;
     }
 
-    // STACK OPERATION: Pop - O(1)
-    void Pop() {
-        if (!towerStack.empty()) {
-            towerStack.pop();
-            height--;
-        }
+    // The viewport with the player's camera scroll folded in, for world space
+    ViewTransform GetWorldView(int index) const {
+        ViewTransform view = GetViewport(index);
+        view.offsetY += players[index].cameraScroll * view.scale;
+        return view;
     }
 
-    // STACK OPERATION: Top - O(1)
-    Block& Top() { return towerStack.top(); }
-    const Block& Top() const { return towerStack.top(); }
-
-    // STACK OPERATION: IsEmpty - O(1)
-    bool IsEmpty() const { return towerStack.empty(); }
+    // Screen-space counterparts of DrawText / DrawRectangleRec for a
+    // position given in the (unscrolled) single-player screen
+    static void DrawViewText(const ViewTransform& view, const char* text,
+                             float x, float y, int fontSize, Color color) {
+        DrawText(text, static_cast<int>(x * view.scale + view.offsetX),
+                 static_cast<int>(y * view.scale + view.offsetY),
+                 std::max(1, static_cast<int>(fontSize * view.scale)), color);
+    }
 
-    int GetHeight() const { return height; }
+    static Rectangle ToViewRectangle(const ViewTransform& view, float x, float y,
+                                     float width, float height) {
+        return Rectangle{x * view.scale + view.offsetX, y * view.scale + view.offsetY,
+                         width * view.scale, height * view.scale};
+    }
 
-    // Draw all blocks in the tower
-    void Draw() const {
-        if (towerStack.empty()) return;
+    bool AllGamesOver() const {
+        for (int i = 0; i < playerCount; i++) {
+            if (!players[i].simulation.IsGameOver()) return false;
+        }
+        return true;
+    }
 
-        // Copy stack to vector for drawing
-        std::vector<Block> blocks;
-        std::stack<Block> tempStack = towerStack;
+    // Lock-step camera: follows the moving block in the same frame the
+    // simulation moves it, with no easing, so the world never lags the block
+    void UpdateCamera(Player& player) {
+        float scroll = std::max(0.0f, CAMERA_LEAD_Y - player.simulation.GetCurrentBlock().GetTop());
+        if (scroll != player.cameraScroll) {
+            player.cameraScroll = scroll;
+            towerLayer.Invalidate();  // Cached tower was drawn at the old scroll
+        }
+    }
 
-        while (!tempStack.empty()) {
-            blocks.push_back(tempStack.top());
-            tempStack.pop();
+    // World rows visible in a player's viewport
+    static float GetViewTop(const Player& player) { return -player.cameraScroll; }
+    static float GetViewBottom(const Player& player) { return SCREEN_HEIGHT - player.cameraScroll; }
+
+    // Re-render cached layers that were invalidated by a push, pop,
+    // scroll, restart or window resize
+    void UpdateLayers() {
+        int width = GetScreenWidth();
+        int height = GetScreenHeight();
+        towerLayer.EnsureSize(width, height);
+        staticHudLayer.EnsureSize(width, height);
+
+        // STACK: Sync reports blocks stacked or popped since last frame
+        for (int i = 0; i < playerCount; i++) {
+            if (players[i].towerRenderer.Sync(players[i].simulation.GetTower())) {
+                towerLayer.Invalidate();
+            }
         }
 
-        // Draw blocks from bottom to top
-        for (int i = blocks.size() - 1; i >= 0; i--) {
-            blocks[i].Draw();
+        // STACK: Every player's on-screen blocks, clipped to their viewport,
+        // stream into the same batch: one draw call for all towers
+        towerLayer.Update([&]() {
+            for (int i = 0; i < playerCount; i++) {
+                const Player& player = players[i];
+                player.towerRenderer.Draw(player.simulation.GetTower(), GetViewTop(player),
+                                          GetViewBottom(player), GetWorldView(i));
+            }
+        });
+        staticHudLayer.Update([&]() { DrawStaticHud(); });
+
+        // HUD text: compare a few ints instead of formatting every frame
+        hudLayer.EnsureSize(width, height);
+        gameOverLayer.EnsureSize(width, height);
+        HudValues values = CurrentHudValues();
+        if (values != hudValues) {
+            hudValues = values;
+            hudLayer.Invalidate();
+            gameOverLayer.Invalidate();
         }
+        hudLayer.Update([&]() { DrawUI(); });
+        gameOverLayer.Update([&]() { DrawGameOverScreens(); });
     }
 
-    void Clear() {
-        while (!towerStack.empty()) {
-            towerStack.pop();
+    HudValues CurrentHudValues() const {
+        HudValues values;
+        for (int i = 0; i < playerCount; i++) {
+            const Simulation& simulation = players[i].simulation;
+            values.players[i].score = simulation.GetScore();
+            values.players[i].height = simulation.GetTowerHeight();
+            values.players[i].consecutivePerfects = simulation.GetConsecutivePerfects();
+            values.players[i].gameOver = simulation.IsGameOver();
+        }
+        values.bestScore = scoreHistory.GetBestScore();
+        values.games = scoreHistory.GetCount();
+        if (leaderboard.HasStanding()) {
+            const LeaderboardStandingReply& standing = leaderboard.GetStanding();
+            values.worldBest = standing.topScore;
+            values.worldRank = standing.found ? static_cast<long long>(standing.rank) : 0;
+            values.worldPlayers = static_cast<long long>(standing.playerCount);
         }
-        height = 0;
+        values.latencySamples = dropLatency.count;
+        values.paused = isPaused;
+        return values;
     }
-};
 
-// ============================================================================
-// SCORE HISTORY - LINKED LIST DATA STRUCTURE
-// ============================================================================
+    // Dynamic HUD text - cached in hudLayer, redrawn when HudValues change
+    void DrawUI() {
+        int bestScore = scoreHistory.GetBestScore();
 
-/**
- * Score Node - Building block of Linked List
- *
- * WHY LINKED LIST?
- * - Dynamic size - don't need to pre-allocate array
- * - Easy insertion at head - O(1)
- * - Memory efficient for keeping game history
- */
-struct ScoreNode {
-    int score;              // Points earned in this game
-    int height;             // Tower height achieved
-    ScoreNode* next;        // Pointer to next node (LINKED LIST concept)
+        for (int i = 0; i < playerCount; i++) {
+            const Simulation& simulation = players[i].simulation;
+            ViewTransform view = GetViewport(i);
 
-    ScoreNode(int s, int h) : score(s), height(h), next(nullptr) {}
-};
+            DrawViewText(view, TextFormat("Score: %d", simulation.GetScore()),
+                         20, 20, 30, DARKBLUE);
+            DrawViewText(view, TextFormat("Height: %d", simulation.GetTowerHeight()),
+                         20, 60, 25, DARKGREEN);
 
-/**
- * ScoreHistory Class - Demonstrates LINKED LIST Data Structure
- *
- * Time Complexity:
- * - Insert at head: O(1)
- * - Get top N scores: O(n)
- * - Clear all: O(n)
- */
-class ScoreHistory {
-private:
-    ScoreNode* head;        // LINKED LIST: Head pointer
-    int count;              // Number of games played
+            if (bestScore > 0) {
+                DrawViewText(view, TextFormat("Best: %d", bestScore), 20, 95, 20, GRAY);
+            }
+            if (hudValues.worldRank > 0) {
+                DrawViewText(view, TextFormat("World best: %d  (you: #%lld of %lld)",
+                                              hudValues.worldBest, hudValues.worldRank,
+                                              hudValues.worldPlayers), 20, 120, 18, GRAY);
+            } else if (hudValues.worldBest >= 0) {
+                DrawViewText(view, TextFormat("World best: %d", hudValues.worldBest),
+                             20, 120, 18, GRAY);
+            }
 
-    // LINKED LIST: Free all allocated memory - O(n)
-    void DeleteList() {
-        ScoreNode* current = head;
-        while (current != nullptr) {
-            ScoreNode* next = current->next;
-            delete current;
-            current = next;
-        }
-    }
+            int consecutivePerfects = simulation.GetConsecutivePerfects();
+            if (consecutivePerfects > 0) {
+                DrawViewText(view, TextFormat("PERFECT x%d!", consecutivePerfects),
+                             SCREEN_WIDTH / 2 - 80, 100, 25, GOLD);
+            }
 
-public:
-    ScoreHistory() : head(nullptr), count(0) {}
+            DrawViewText(view, TextFormat("Games: %d", scoreHistory.GetCount()),
+                         SCREEN_WIDTH - 150, 20, 20, GRAY);
 
-    ~ScoreHistory() { DeleteList(); }
+            if (dropLatency.count > 0) {
+                DrawViewText(view, TextFormat("Input latency: %.1f ms (avg %.1f, worst %.1f)",
+                                              dropLatency.last * 1000.0,
+                                              dropLatency.GetMean() * 1000.0,
+                                              dropLatency.worst * 1000.0),
+                             SCREEN_WIDTH - 330, SCREEN_HEIGHT - 20, 14, GRAY);
+            }
+        }
 
-    // LINKED LIST OPERATION: Insert at Head - O(1)
-    void AddScore(int score, int height) {
-        ScoreNode* newNode = new ScoreNode(score, height);
-        newNode->next = head;  // New node points to old head
-        head = newNode;        // Head now points to new node
-        count++;
+        if (isPaused) {
+            DrawText("PAUSED", SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 20, 40, RED);
+        }
     }
 
-    // Find the best score by traversing the list - O(n)
-    int GetBestScore() const {
-        if (head == nullptr) return 0;
-
-        int best = 0;
-        ScoreNode* current = head;
-
-        // LINKED LIST TRAVERSAL: Follow next pointers
-        while (current != nullptr) {
-            if (current->score > best) {
-                best = current->score;
+    // Cached in gameOverLayer; the values shown are fixed once a game ends
+    void DrawGameOverScreens() {
+        bool allOver = AllGamesOver();
+        for (int i = 0; i < playerCount; i++) {
+            const Simulation& simulation = players[i].simulation;
+            if (!simulation.IsGameOver()) continue;
+
+            ViewTransform view = GetViewport(i);
+            DrawRectangleRec(ToViewRectangle(view, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT),
+                             Fade(BLACK, 0.7f));
+            DrawViewText(view, "GAME OVER!",
+                         SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 - 100, 50, RED);
+            DrawViewText(view, TextFormat("Final Score: %d", simulation.GetScore()),
+                         SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 - 30, 30, WHITE);
+            DrawViewText(view, TextFormat("Tower Height: %d", simulation.GetTowerHeight()),
+                         SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 + 10, 25, WHITE);
+            DrawViewText(view, TextFormat("Best Score: %d", scoreHistory.GetBestScore()),
+                         SCREEN_WIDTH / 2 - 110, SCREEN_HEIGHT / 2 + 45, 25, GOLD);
+            if (practice) {
+                DrawViewText(view, "Press Z to Undo or R to Restart",
+                             SCREEN_WIDTH / 2 - 190, SCREEN_HEIGHT / 2 + 100, 25, LIGHTGRAY);
+            } else if (allOver && autoplay) {
+                DrawViewText(view, "Next demo starting...",
+                             SCREEN_WIDTH / 2 - 135, SCREEN_HEIGHT / 2 + 100, 25, LIGHTGRAY);
+            } else if (allOver) {
+                DrawViewText(view, "Press R to Restart",
+                             SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 + 100, 25, LIGHTGRAY);
+            } else {
+                DrawViewText(view, "Waiting for other players",
+                             SCREEN_WIDTH / 2 - 160, SCREEN_HEIGHT / 2 + 100, 25, LIGHTGRAY);
             }
-            current = current->next;  // Move to next node
         }
-
-        return best;
     }
 
-    // Find the best height by traversing the list - O(n)
-    int GetBestHeight() const {
-        if (head == nullptr) return 0;
+    // QUEUE: Visualize upcoming blocks
+    void DrawNextBlockPreview(int index) {
+        // QUEUE: Peek(i) computes each upcoming block on demand
+        const Simulation& simulation = players[index].simulation;
+        ViewTransform view = GetViewport(index);
+        int yOffset = 100;
 
-        int best = 0;
-        ScoreNode* current = head;
+        for (int i = 0; i < 3; i++) {
+            Block previewBlock = simulation.GetUpcomingBlock(i);
 
-        while (current != nullptr) {
-            if (current->height > best) {
-                best = current->height;
-            }
-            current = current->next;
-        }
+            Rectangle previewRect = ToViewRectangle(
+                view,
+                SCREEN_WIDTH - 170,
+                static_cast<float>(yOffset + i * 40),
+                previewBlock.rect.width * 0.4f,
+                BLOCK_HEIGHT * 0.6f
+            );
 
-        return best;
+            DrawRectangleRec(previewRect, GetBlockColor(previewBlock.colorIndex));
+            DrawRectangleLinesEx(previewRect, 1.0f, BLACK);
+        }
     }
 
-    int GetCount() const { return count; }
+    // Labels, instructions and viewport borders - cached in staticHudLayer
+    void DrawStaticHud() {
+        for (int i = 0; i < playerCount; i++) {
+            ViewTransform view = GetViewport(i);
+            DrawViewText(view, "Next Blocks:", SCREEN_WIDTH - 180, 60, 20, DARKGRAY);
+
+            if (players[i].isBot) {
+                DrawViewText(view, autoplay ? "DEMO" : "CPU",
+                             SCREEN_WIDTH / 2 - 35, 20, 25, PURPLE);
+            } else {
+                DrawViewText(view, TextFormat("%s - Drop Block", players[i].dropKeyName),
+                             20, SCREEN_HEIGHT - 80, 20, DARKGRAY);
+            }
+            DrawViewText(view, "P - Pause", 20, SCREEN_HEIGHT - 50, 20, DARKGRAY);
+            DrawViewText(view, "R - Restart (when game over)",
+                         20, SCREEN_HEIGHT - 20, 18, DARKGRAY);
+
+            if (practice) {
+                DrawViewText(view, "PRACTICE", SCREEN_WIDTH / 2 - 55, 20, 25, ORANGE);
+                DrawViewText(view, TextFormat("Z - Undo   Y - Redo   X - Rewind %d",
+                                              PRACTICE_REWIND_BLOCKS),
+                             20, SCREEN_HEIGHT - 110, 20, DARKGRAY);
+            }
 
-    void Clear() {
-        DeleteList();
-        head = nullptr;
-        count = 0;
+            if (playerCount > 1) {
+                DrawRectangleLinesEx(ToViewRectangle(view, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT),
+                                     1.0f, LIGHTGRAY);
+            }
+        }
     }
-};
 
-// ============================================================================
-// GAME CLASS - INTEGRATES ALL DATA STRUCTURES
-// ============================================================================
-
-/**
- * Game Class - Main Game Controller
- *
- * Integrates all three data structures:
- * 1. STACK - Tower management
- * 2. QUEUE - Upcoming blocks preview
- * 3. LINKED LIST - Score history
- */
-class Game {
-private:
-    // Data Structures
-    Tower tower;                      // STACK: Main tower
-    std::queue<Block> blockQueue;     // QUEUE: Upcoming blocks (FIFO)
-    ScoreHistory scoreHistory;        // LINKED LIST: Game history
+public:
+    // Practice mode is single-player and has no bots; the last `botCount`
+    // players are bots, and a match of only bots plays itself on repeat
+    explicit Game(int playerCount = 1, bool practice = false, AssetLoader* assets = nullptr,
+                  int botCount = 0)
+        : playerCount(practice ? 1 : std::clamp(playerCount, 1, MAX_PLAYERS)), practice(practice),
+          autoplay(false), autoplayRestartTime(-1.0),
+          scoreHistory(MAX_STORED_GAMES), gameTick(0), matchSeed(0),
+          seedSource(std::random_device{}()), isPaused(false),
+          latencyPending(false), latencyPressTime(0), lastUpdateTime(GetTime()),
+          assets(assets) {
+        for (int i = 0; i < this->playerCount; i++) {
+            Player& player = players[i];
+            player.dropKey = DROP_KEYS[i];
+            player.dropKeyName = DROP_KEY_NAMES[i];
+            player.spectatorFeed = SpectatorFeed(static_cast<std::uint8_t>(i));
+            player.simulation.SetTowerRetention(TOWER_RETAINED_BLOCKS);
+            player.simulation.EnableHistory(practice);
+            player.isBot = !practice && i >= this->playerCount - botCount;
+            input.Track(player.dropKey);
+        }
+        autoplay = !practice && botCount >= this->playerCount;
+        input.Track(KEY_P);
+        input.Track(KEY_R);
+        if (practice) {
+            input.Track(KEY_Z);
+            input.Track(KEY_Y);
+            input.Track(KEY_X);
+        }
+#ifdef TOWERBUILDER_PROFILER
+        input.Track(KEY_F3);
+        input.Track(KEY_F4);
+#endif
+
+        // Saved aggregates make "Best" correct on the first frame
+        if (scoreLog.Open(SCORE_LOG_PATH)) {
+            scoreLog.LoadInto(scoreHistory, MAX_STORED_GAMES);
+        } else {
+            TraceLog(LOG_WARNING, "Could not open %s, scores will not be saved", SCORE_LOG_PATH);
+        }
+        InitializeGame();
+    }
 
-    // Game state
-    Block currentBlock;
-    bool gameOver;
-    bool isPaused;
-    int score;
-    int consecutivePerfects;
-    float blockSpeed;
-    int direction;  // 1 = right, -1 = left
+    // Start a new match: every player restarts on the same tick
+    void InitializeGame() {
+        matchSeed = seedSource() | 1;  // Never 0, the unseeded classic sequence
+        for (int i = 0; i < playerCount; i++) {
+            Player& player = players[i];
+            player.simulation.Reset(matchSeed);
+            player.towerRenderer.Invalidate();  // New tower, cached blocks no longer apply
+            if (practice) player.timeline.Start(player.simulation);
+            UpdateCamera(player);
+            player.particles.Clear();
+            if (player.isBot) {
+                player.bot = DropPolicy(BotPolicy(), GameSeed(matchSeed, i));
+                player.bot.BeginBlock(player.simulation);
+            }
 
-    // Game constants
-    static constexpr float BLOCK_HEIGHT = 30.0f;
-    static constexpr float INITIAL_BLOCK_WIDTH = 200.0f;
-    static constexpr float INITIAL_SPEED = 150.0f;
-    static constexpr float SPEED_INCREMENT = 15.0f;
-    static constexpr float SCREEN_WIDTH = 800.0f;
-    static constexpr float SCREEN_HEIGHT = 600.0f;
-    static constexpr float PERFECT_THRESHOLD = 5.0f;
-
-    Color blockColors[10] = {
-        SKYBLUE, PINK, GOLD, LIME, ORANGE,
-        PURPLE, BEIGE, VIOLET, MAROON, DARKBLUE
-    };
+            player.replay.Begin(player.simulation.GetParams(), FixedTimestep::DEFAULT_TICK_RATE,
+                                matchSeed);
+            player.spectatorFeed.BeginGame();
+            player.dropPending = false;
+            player.previousBlockX = player.simulation.GetCurrentBlock().rect.x;
+            player.blockSpawnTime = 0.0;
+            player.gameStats = TelemetryGame{};
+        }
+        towerLayer.Invalidate();
 
-    Color GetBlockColor(int index) {
-        return blockColors[index % 10];
+        timestep.Reset();
+        gameTick = 0;
+        autoplayRestartTime = -1.0;
     }
 
-    // QUEUE OPERATION: Enqueue - O(1)
-    void GenerateUpcomingBlocks(int count = 3) {
-        for (int i = 0; i < count; i++) {
-            float width = tower.IsEmpty() ? INITIAL_BLOCK_WIDTH : tower.Top().rect.width;
-
-            Block newBlock(
-                0, 0, width, BLOCK_HEIGHT,
-                GetBlockColor(tower.GetHeight() + blockQueue.size()),
-                blockSpeed
-            );
-
-            blockQueue.push(newBlock);  // QUEUE: Add to back of queue
-        }
+    static DropPolicyConfig BotPolicy() {
+        DropPolicyConfig config;
+        config.kind = DropPolicyKind::Predictive;
+        config.jitterSigma = BOT_AIM_SIGMA;
+        config.reactionSdMs = BOT_TIMING_SD_MS;
+        return config;
     }
 
-    // QUEUE OPERATION: Dequeue - O(1)
-    void SpawnNextBlock() {
-        if (blockQueue.empty()) {
-            GenerateUpcomingBlocks(1);
+    // Listen for spectators on `port`; false if it cannot be bound
+    bool StartSpectatorServer(std::uint16_t port) { return spectators.Open(port); }
+
+    // Once per frame: answer catch-up requests, then send every game's
+    // delta. One encode per game, whatever the number of spectators.
+    void PublishToSpectators(double now) {
+        if (!spectators.IsOpen()) return;
+        PROFILE_SCOPE("Spectators");
+
+        spectators.Poll(now);
+        for (const SpectatorServer::ResyncRequest& request : spectators.GetResyncRequests()) {
+            if (request.stream >= playerCount) continue;
+            Player& player = players[request.stream];
+            spectators.Send(request.address, player.spectatorFeed.EncodeCatchUp(
+                player.simulation, gameTick, request.fromIndex));
         }
 
-        currentBlock = blockQueue.front();  // QUEUE: Get front element (FIFO)
-        blockQueue.pop();                   // QUEUE: Remove from front
-
-        float yPos = SCREEN_HEIGHT - 100 - (tower.GetHeight() * BLOCK_HEIGHT);
-        currentBlock.SetPosition(0, yPos);
-        currentBlock.isMoving = true;
-        currentBlock.speed = blockSpeed;
+        if (spectators.GetSpectatorCount() == 0) return;  // Joiners catch up on their own
+        for (int i = 0; i < playerCount; i++) {
+            Player& player = players[i];
+            spectators.Broadcast(player.spectatorFeed.EncodeUpdate(player.simulation, gameTick));
+        }
+    }
 
-        GenerateUpcomingBlocks(1);
+    // Connect to a leaderboard server; false if it cannot be resolved
+    bool StartLeaderboard(const char* host, std::uint16_t port, std::uint64_t playerId) {
+        return leaderboard.Connect(host, port, playerId);
     }
 
-    void UpdateBlockMovement(float deltaTime) {
-        if (!currentBlock.isMoving) return;
+    // Once per frame: send queued replays and refresh the global standing
+    void SyncLeaderboard(double now) {
+        if (!leaderboard.IsConnected()) return;
+        PROFILE_SCOPE("Leaderboard");
+        leaderboard.Poll(now);
+    }
 
-        currentBlock.rect.x += blockSpeed * direction * deltaTime;
+    // Poll-time hook: latch presses since the last raylib input poll
+    void SampleInput() { input.Sample(); }
 
-        if (currentBlock.GetRight() >= SCREEN_WIDTH) {
-            direction = -1;
-        } else if (currentBlock.GetLeft() <= 0) {
-            direction = 1;
+    // Called right after EndDrawing, i.e. once the frame has been presented
+    void OnFramePresented(double now) {
+        if (latencyPending) {
+            dropLatency.Add(now - latencyPressTime);
+            latencyPending = false;
         }
     }
 
-    bool CheckOverlap(const Block& current, const Block& below,
-                      float& overlapStart, float& overlapEnd) {
-        float currentLeft = current.GetLeft();
-        float currentRight = current.GetRight();
-        float belowLeft = below.GetLeft();
-        float belowRight = below.GetRight();
+    void Update(double now) {
+        PROFILE_SCOPE("Update");
 
-        overlapStart = std::max(currentLeft, belowLeft);
-        overlapEnd = std::min(currentRight, belowRight);
+        double elapsed = now - lastUpdateTime;
+        lastUpdateTime = now;
+        Telemetry::RecordFrame(elapsed);
+        UpdateMusic();
 
-        return overlapEnd > overlapStart;
-    }
+        // Effects run on frame time, not ticks: they never feed back into
+        // the simulation. Clamped so a stall does not fling them away.
+        if (!isPaused) {
+            float effectSeconds = static_cast<float>(std::min(elapsed, MAX_EFFECT_STEP_SECONDS));
+            for (int i = 0; i < playerCount; i++) {
+                players[i].particles.Update(effectSeconds);
+            }
+        }
+
+#ifdef TOWERBUILDER_PROFILER
+        UpdateProfilerKeys();
+#endif
+        if (practice) {
+            UpdatePracticeKeys();
+        }
 
-    void TrimAndStackBlock() {
-        if (tower.IsEmpty()) {
-            tower.Push(currentBlock);  // STACK: Push
-            score += 10;
-            SpawnNextBlock();
+        if (AllGamesOver()) {
+            for (int i = 0; i < playerCount; i++) {
+                input.Discard(players[i].dropKey);
+            }
+            if (autoplay && autoplayRestartTime < 0.0) {
+                autoplayRestartTime = now + AUTOPLAY_RESTART_SECONDS;
+            }
+            if (input.ConsumePress(KEY_R) || (autoplay && now >= autoplayRestartTime)) {
+                InitializeGame();
+            }
             return;
         }
 
-        // STACK: Peek at top block for comparison
-        const Block& topBlock = tower.Top();  // O(1) operation
+        if (input.ConsumePress(KEY_P)) {
+            isPaused = !isPaused;
+        }
 
-        float overlapStart, overlapEnd;
-        if (!CheckOverlap(currentBlock, topBlock, overlapStart, overlapEnd)) {
-            gameOver = true;
-            scoreHistory.AddScore(score, tower.GetHeight() - 1);  // LINKED LIST: Add to history
-            return;
+        // A press is held until the tick whose time span contains it
+        for (int i = 0; i < playerCount; i++) {
+            Player& player = players[i];
+            double pressTime = 0.0;
+            if (isPaused || player.simulation.IsGameOver() || player.isBot) {
+                input.Discard(player.dropKey);
+            } else if (!player.dropPending && input.ConsumePress(player.dropKey, &pressTime)) {
+                player.dropPending = true;
+                player.dropPressTime = pressTime;
+            }
         }
 
-        float overlapWidth = overlapEnd - overlapStart;
-        float originalWidth = currentBlock.rect.width;
+        if (isPaused) return;
 
-        if (overlapWidth < originalWidth * 0.1f) {
-            gameOver = true;
-            scoreHistory.AddScore(score, tower.GetHeight() - 1);
-            return;
+        // Translate real time into fixed simulation ticks. The banked time
+        // covers [now - accumulated, now], so each tick maps back to the
+        // real-time span it simulates. Players step one after another
+        // within a tick; each is a few nanoseconds of work.
+        timestep.AddFrameTime(static_cast<float>(elapsed));
+        for (;;) {
+            double tickStart = now - timestep.GetAccumulated();
+            if (!timestep.ConsumeTick()) break;
+
+            for (int i = 0; i < playerCount; i++) {
+                StepPlayer(players[i], tickStart, timestep.GetTickSeconds());
+            }
+            gameTick++;
+
+            if (AllGamesOver()) break;
         }
+    }
 
-        // Create trimmed block
-        Block trimmedBlock = currentBlock;
-        trimmedBlock.rect.x = overlapStart;
-        trimmedBlock.rect.width = overlapWidth;
+    // Z / Y / X: move the practice game along its timeline. Runs before
+    // drops are latched, so a drop pressed with an undo is not applied to
+    // the restored block.
+    void UpdatePracticeKeys() {
+        Player& player = players[0];
+        Timeline& timeline = player.timeline;
+        bool restored = false;
 
-        // STACK: Push trimmed block onto tower
-        tower.Push(trimmedBlock);  // O(1) operation
+        if (input.ConsumePress(KEY_Z)) {
+            restored |= timeline.Undo(player.simulation);
+        }
+        if (input.ConsumePress(KEY_Y)) {
+            restored |= timeline.Redo(player.simulation);
+        }
+        if (input.ConsumePress(KEY_X)) {
+            timeline.RewindToHeight(player.simulation,
+                                    timeline.GetHeight() - PRACTICE_REWIND_BLOCKS);
+            restored = true;
+        }
+        if (!restored) return;
+
+        // STACK: The tower was popped and pushed; the cached geometry,
+        // the camera and the interpolation all start over, and spectators
+        // are resent the blocks that may have changed
+        player.towerRenderer.Invalidate();
+        towerLayer.Invalidate();
+        player.spectatorFeed.MarkRewritten(
+            static_cast<std::uint64_t>(player.simulation.ConsumeRewriteFloor()));
+        UpdateCamera(player);
+        player.particles.Clear();
+        player.previousBlockX = player.simulation.GetCurrentBlock().rect.x;
+        player.blockSpawnTime = gameTick * static_cast<double>(timestep.GetTickSeconds());
+        player.dropPending = false;
+        input.Discard(player.dropKey);
+    }
 
-        // Calculate score
-        float accuracy = overlapWidth / originalWidth;
-        bool isPerfect = std::abs(overlapWidth - originalWidth) < PERFECT_THRESHOLD;
+    // Advance one player by one tick, landing a pending drop at its press time
+    void StepPlayer(Player& player, double tickStart, float tickSeconds) {
+        if (player.simulation.IsGameOver()) return;
+
+        SimInput step;
+        step.deltaTime = tickSeconds;
+
+        if (player.isBot) {
+            // Bots press at the end of a tick, like the batch tools
+            step.drop = player.bot.ShouldDrop(player.simulation, tickSeconds);
+        } else if (player.dropPending && player.dropPressTime < tickStart + tickSeconds) {
+            // Land the block where it was at the press, not at the tick.
+            // Quantized to the replay's sub-tick steps so a replay
+            // reproduces exactly what was simulated here.
+            float offset = static_cast<float>(player.dropPressTime - tickStart);
+            std::uint8_t subTick = EncodeSubTick(std::clamp(offset, 0.0f, tickSeconds),
+                                                 tickSeconds);
+            step.drop = true;
+            step.dropTime = DecodeSubTick(subTick, tickSeconds);
+            player.dropPending = false;
+            player.replay.RecordDrop(ReplayDrop{gameTick, true, subTick});
+
+            latencyPending = true;
+            latencyPressTime = player.dropPressTime;
+        }
 
-        if (isPerfect) {
-            consecutivePerfects++;
-            score += 50 + (consecutivePerfects * 10);
-        } else {
-            consecutivePerfects = 0;
-            score += 10 + static_cast<int>(accuracy * 10);
+        player.previousBlockX = player.simulation.GetCurrentBlock().rect.x;
+        SimDelta delta = player.simulation.Step(step);
+        if (delta.dropped) RecordDropTelemetry(player, step, delta);
+
+        if (delta.stacked) {
+            PlayEffect(delta.perfect ? SOUND_PERFECT : SOUND_DROP);
+            SpawnStackEffects(player, delta);
+            // New block: nothing to interpolate from
+            player.previousBlockX = player.simulation.GetCurrentBlock().rect.x;
+            UpdateCamera(player);
+            if (practice) player.timeline.OnStacked(player.simulation);
+            if (player.isBot) player.bot.BeginBlock(player.simulation);
         }
 
-        // Increase difficulty
-        if (tower.GetHeight() % 5 == 0) {
-            blockSpeed += SPEED_INCREMENT;
+        if (delta.gameOver) {
+            PlayEffect(SOUND_GAME_OVER);
+            RecordGameTelemetry(player);
+            OnGameOver(player);
         }
+    }
 
-        SpawnNextBlock();
+    // TELEMETRY: measured by TrimAndStackBlock (SimDelta), timed here. A
+    // thread-local ring push; nothing if telemetry is off.
+    void RecordDropTelemetry(Player& player, const SimInput& step, const SimDelta& delta) {
+        double tickSeconds = step.deltaTime;
+        double dropTime = gameTick * tickSeconds
+                        + (step.dropTime >= 0.0f ? step.dropTime : tickSeconds);
+
+        TelemetryDrop drop;
+        drop.game = matchSeed;
+        drop.player = static_cast<std::uint32_t>(&player - players.data());
+        drop.tick = static_cast<std::uint32_t>(gameTick);
+        drop.height = static_cast<std::uint32_t>(player.simulation.GetTowerHeight());
+        drop.offset = delta.dropOffset;
+        drop.overlapRatio = delta.overlapRatio;
+        drop.timeToDrop = static_cast<float>(dropTime - player.blockSpawnTime);
+        drop.streak = static_cast<std::uint32_t>(player.simulation.GetConsecutivePerfects());
+        drop.flags = (delta.perfect ? TELEMETRY_PERFECT : 0) |
+                     (delta.gameOver ? TELEMETRY_GAME_OVER : 0) |
+                     GetTelemetryFlags(player);
+        Telemetry::RecordDrop(drop);
+
+        // The next block moves for the rest of this tick
+        player.blockSpawnTime = dropTime;
+        TelemetryGame& stats = player.gameStats;
+        stats.drops++;
+        if (delta.perfect) stats.perfects++;
+        stats.bestStreak = std::max(stats.bestStreak, drop.streak);
     }
 
-    void DropBlock() {
-        if (!currentBlock.isMoving) return;
-        currentBlock.isMoving = false;
-        TrimAndStackBlock();
+    void RecordGameTelemetry(Player& player) {
+        TelemetryGame& stats = player.gameStats;
+        stats.game = matchSeed;
+        stats.player = static_cast<std::uint32_t>(&player - players.data());
+        stats.ticks = static_cast<std::uint32_t>(gameTick + 1);
+        stats.score = player.simulation.GetScore();
+        stats.height = static_cast<std::uint32_t>(player.simulation.GetTowerHeight());
+        stats.flags = GetTelemetryFlags(player);
+        Telemetry::RecordGame(stats);
     }
 
-    void DrawUI() {
-        DrawText(TextFormat("Score: %d", score), 20, 20, 30, DARKBLUE);
-        DrawText(TextFormat("Height: %d", tower.GetHeight() - 1), 20, 60, 25, DARKGREEN);
+    std::uint32_t GetTelemetryFlags(const Player& player) const {
+        return (player.isBot ? TELEMETRY_BOT : 0) | (practice ? TELEMETRY_PRACTICE : 0);
+    }
 
-        int bestScore = scoreHistory.GetBestScore();
-        if (bestScore > 0) {
-            DrawText(TextFormat("Best: %d", bestScore), 20, 95, 20, GRAY);
+    // Debris for the trimmed overhang, sparkles for a perfect placement
+    void SpawnStackEffects(Player& player, const SimDelta& delta) {
+        const Block& top = player.simulation.GetTower().Top();
+        Color color = GetBlockColor(top.colorIndex);
+        std::uint32_t rgba = (static_cast<std::uint32_t>(color.r) << 24) |
+                             (static_cast<std::uint32_t>(color.g) << 16) |
+                             (static_cast<std::uint32_t>(color.b) << 8) | color.a;
+
+        if (delta.trimmedWidth > 0.0f) {
+            int side = delta.trimmedX < top.rect.x ? -1 : 1;
+            player.particles.SpawnDebris(delta.trimmedX, top.rect.y, delta.trimmedWidth,
+                                         top.rect.height, side, rgba);
         }
-
-        if (consecutivePerfects > 0) {
-            DrawText(TextFormat("PERFECT x%d!", consecutivePerfects),
-                     SCREEN_WIDTH / 2 - 80, 100, 25, GOLD);
+        if (delta.perfect) {
+            player.particles.SpawnSparkles(top.rect.x, top.rect.y, top.rect.width, SPARKLE_COLOR);
         }
+    }
 
-        DrawText(TextFormat("Games: %d", scoreHistory.GetCount()),
-                 SCREEN_WIDTH - 150, 20, 20, GRAY);
+    // Sounds are skipped until (and unless) the bundle delivers them
+    void PlayEffect(const char* name) {
+        const Sound* sound = assets != nullptr ? assets->GetSound(name) : nullptr;
+        if (sound != nullptr) PlaySound(*sound);
     }
 
-    void DrawGameOverScreen() {
-        DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.7f));
-        DrawText("GAME OVER!", SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 - 100, 50, RED);
-        DrawText(TextFormat("Final Score: %d", score),
-                 SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 - 30, 30, WHITE);
-        DrawText(TextFormat("Tower Height: %d", tower.GetHeight() - 1),
-                 SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 + 10, 25, WHITE);
-        DrawText(TextFormat("Best Score: %d", scoreHistory.GetBestScore()),
-                 SCREEN_WIDTH / 2 - 110, SCREEN_HEIGHT / 2 + 45, 25, GOLD);
-        DrawText("Press R to Restart", SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 + 100, 25, LIGHTGRAY);
+    void UpdateMusic() {
+        Music* music = assets != nullptr ? assets->GetMusic(MUSIC_TRACK) : nullptr;
+        if (music == nullptr) return;
+        if (!IsMusicStreamPlaying(*music)) PlayMusicStream(*music);
+        UpdateMusicStream(*music);
     }
 
-    // QUEUE: Visualize upcoming blocks
-    void DrawNextBlockPreview() {
-        DrawText("Next Blocks:", SCREEN_WIDTH - 180, 60, 20, DARKGRAY);
+    void OnGameOver(Player& player) {
+        if (practice || player.isBot) return;  // Undone or bot games would skew the history
+        const Simulation& simulation = player.simulation;
+
+        // LINKED LIST: Add to history
+        scoreHistory.AddScore(simulation.GetScore(), simulation.GetTowerHeight());
+        scoreLog.Append(ScoreRecord{
+            simulation.GetScore(),
+            simulation.GetTowerHeight(),
+            static_cast<std::int64_t>(std::time(nullptr)),
+            simulation.GetSeed()
+        });
+        SaveReplay(player);
+    }
 
-        std::queue<Block> tempQueue = blockQueue;
-        int yOffset = 100;
+    // Write the finished game to REPLAY_DIR for TowerBuilderReplay. The
+    // tick just stepped is the game's last, hence gameTick + 1.
+    void SaveReplay(Player& player) {
+        player.replay.Finish(player.simulation.GetScore(), player.simulation.GetTowerHeight(),
+                             gameTick + 1);
 
-        for (int i = 0; i < 3 && !tempQueue.empty(); i++) {
-            Block previewBlock = tempQueue.front();
-            tempQueue.pop();
+        std::error_code error;
+        std::filesystem::create_directories(REPLAY_DIR, error);
 
-            Rectangle previewRect = {
-                SCREEN_WIDTH - 170,
-                static_cast<float>(yOffset + i * 40),
-                previewBlock.rect.width * 0.4f,
-                BLOCK_HEIGHT * 0.6f
-            };
+        char path[256];
+        std::snprintf(path, sizeof(path), "%s/game_%lld_%d.tbr", REPLAY_DIR,
+                      static_cast<long long>(std::time(nullptr)), scoreHistory.GetCount());
+        if (!player.replay.Save(path)) {
+            TraceLog(LOG_WARNING, "Could not save replay %s", path);
+        }
 
-            DrawRectangleRec(previewRect, previewBlock.color);
-            DrawRectangleLinesEx(previewRect, 1.0f, BLACK);
+        // The server re-simulates it; only the drops have to be trusted
+        if (leaderboard.IsConnected()) {
+            leaderboard.Submit(player.replay.GetBytes());
         }
     }
 
-    void DrawInstructions() {
-        DrawText("SPACE - Drop Block", 20, SCREEN_HEIGHT - 80, 20, DARKGRAY);
-        DrawText("P - Pause", 20, SCREEN_HEIGHT - 50, 20, DARKGRAY);
-        DrawText("R - Restart (when game over)", 20, SCREEN_HEIGHT - 20, 18, DARKGRAY);
-    }
+    void Draw() {
+        {
+            PROFILE_SCOPE("UpdateLayers");
+            UpdateLayers();     // Off-screen work first, then compose the frame
+        }
 
-public:
-    Game() : gameOver(false), isPaused(false), score(0),
-             consecutivePerfects(0), blockSpeed(INITIAL_SPEED), direction(1) {
-        InitializeGame();
+        PROFILE_SCOPE("Draw");
+        ClearBackground(RAYWHITE);
+
+        towerLayer.Draw();      // Draw every STACK (cached, on-screen blocks only)
+
+        // Draw each moving block between its last two ticks, so motion is
+        // smooth at any frame rate. All of them share one batch.
+        for (int i = 0; i < playerCount; i++) {
+            const Player& player = players[i];
+            if (player.simulation.IsGameOver()) continue;
+
+            Block block = player.simulation.GetCurrentBlock();
+            block.rect.x = player.previousBlockX +
+                           (block.rect.x - player.previousBlockX) * timestep.GetAlpha();
+            TowerRenderer::DrawBlock(block, GetViewTop(player), GetViewBottom(player),
+                                     GetWorldView(i));
+        }
+        for (int i = 0; i < playerCount; i++) {
+            const Player& player = players[i];
+            TowerRenderer::DrawParticles(player.particles, GetViewTop(player),
+                                         GetViewBottom(player), GetWorldView(i));
+        }
+
+        {
+            PROFILE_SCOPE("DrawUI");
+            hudLayer.Draw();         // Cached score text
+            for (int i = 0; i < playerCount; i++) {
+                DrawNextBlockPreview(i);  // Draw QUEUE preview
+            }
+            staticHudLayer.Draw();
+        }
+
+        gameOverLayer.Draw();
+
+#ifdef TOWERBUILDER_PROFILER
+        if (showProfiler) {
+            DrawProfilerOverlay();
+        }
+#endif
     }
 
-    void InitializeGame() {
-        tower.Clear();
-        score = 0;
-        consecutivePerfects = 0;
-        blockSpeed = INITIAL_SPEED;
-        direction = 1;
-        gameOver = false;
-
-        // Create base block
-        Block baseBlock(
-            SCREEN_WIDTH / 2 - INITIAL_BLOCK_WIDTH / 2,
-            SCREEN_HEIGHT - 100,
-            INITIAL_BLOCK_WIDTH,
-            BLOCK_HEIGHT,
-            GetBlockColor(0),
-            0
-        );
-        baseBlock.isMoving = false;
-        tower.Push(baseBlock);  // STACK: Push base block
-
-        // QUEUE: Generate upcoming blocks
-        GenerateUpcomingBlocks(3);
-        SpawnNextBlock();
-    }
-
-    void Update() {
-        if (gameOver) {
-            if (IsKeyPressed(KEY_R)) {
-                InitializeGame();
+#ifdef TOWERBUILDER_PROFILER
+    void UpdateProfilerKeys() {
+        FrameProfiler& profiler = FrameProfiler::Get();
+        if (input.ConsumePress(KEY_F3)) {
+            showProfiler = !showProfiler;
+        }
+        if (input.ConsumePress(KEY_F4)) {
+            if (profiler.IsCapturing()) {
+                profiler.StopCapture();
+                TraceLog(LOG_INFO, "Profiler trace written to %s", PROFILE_TRACE_PATH);
+            } else if (!profiler.StartCapture(PROFILE_TRACE_PATH)) {
+                TraceLog(LOG_WARNING, "Could not open %s", PROFILE_TRACE_PATH);
             }
-            return;
         }
+    }
 
-        if (IsKeyPressed(KEY_P)) {
-            isPaused = !isPaused;
+    // Frame time percentiles, per-zone averages and allocations, top left
+    void DrawProfilerOverlay() {
+        static const char* const zones[] = {
+            "Update", "UpdateLayers", "Draw", "DrawUI", "EndDrawing", "InputWait"
+        };
+        const FrameProfiler& profiler = FrameProfiler::Get();
+
+        int x = 20, y = 130;
+        DrawRectangle(x - 8, y - 8, 280, 40 + 18 * 7, Fade(BLACK, 0.75f));
+        DrawText(TextFormat("Frame  p50 %.2f ms  p99 %.2f ms",
+                            profiler.GetFrameTimePercentile(0.50),
+                            profiler.GetFrameTimePercentile(0.99)), x, y, 16, GREEN);
+        y += 22;
+
+        for (const char* zone : zones) {
+            DrawText(TextFormat("%-13s %7.3f ms", zone, profiler.GetZoneAverageMs(zone)),
+                     x, y, 14, RAYWHITE);
+            y += 18;
         }
+        DrawText(TextFormat("Allocations/frame %u", profiler.GetLastFrame().allocations),
+                 x, y, 14, RAYWHITE);
+        y += 18;
 
-        if (isPaused) return;
+        if (profiler.IsCapturing()) {
+            DrawText(TextFormat("Capturing to %s (F4 stops)", PROFILE_TRACE_PATH), x, y, 14, RED);
+        } else {
+            DrawText("F4: capture Chrome trace", x, y, 14, GRAY);
+        }
+    }
+#endif
+};
+
+// ============================================================================
+// SPECTATOR SCREEN - MIRRORS A GAME STREAMED BY ANOTHER INSTANCE
+// ============================================================================
 
-        float deltaTime = GetFrameTime();
-        UpdateBlockMovement(deltaTime);
+/**
+ * SpectatorScreen - Draws a SpectatorView, for tournament displays
+ *
+ * Uses the game's own drawing path: the mirrored STACK goes through a
+ * TowerRenderer into a cached layer, redrawn only when a block arrives or
+ * the view scrolls, and the HUD text is cached until the score changes.
+ */
+class SpectatorScreen {
+private:
+    SpectatorClient client;
+    SpectatorView view;
+    TowerRenderer towerRenderer;
+    RenderLayer towerLayer;
+    RenderLayer hudLayer;
+
+    std::uint64_t drawnRevision = ~0ull;  // View revision in the tower layer
+    float cameraScroll = 0.0f;
+    int hudScore = -1;
+    std::uint64_t hudHeight = ~0ull;
+    bool hudGameOver = false;
+    bool hudWaiting = false;
+
+    static constexpr float SCREEN_HEIGHT = Simulation::SCREEN_HEIGHT;
+    static constexpr float CAMERA_LEAD_Y = 200.0f;   // Same lead as the game
+    static constexpr double WAITING_SECONDS = 2.0;   // Silence before "waiting"
+
+    bool IsWaiting(double now) const {
+        return !view.HasGame() || client.GetSilence(now) > WAITING_SECONDS;
+    }
 
-        if (IsKeyPressed(KEY_SPACE)) {
-            DropBlock();
+    void DrawHud(double now) {
+        if (IsWaiting(now)) {
+            DrawText("Waiting for the game...", 20, 20, 30, GRAY);
+            return;
+        }
+        DrawText(TextFormat("Score: %d", view.GetScore()), 20, 20, 30, DARKBLUE);
+        // Stacked blocks, not counting the base block
+        DrawText(TextFormat("Height: %llu", static_cast<unsigned long long>(
+                     view.GetHeight() > 0 ? view.GetHeight() - 1 : 0)), 20, 60, 25, DARKGREEN);
+        DrawText(TextFormat("Watching player %d", view.GetStream() + 1), 20, 95, 20, GRAY);
+        if (view.IsGameOver()) {
+            DrawText("GAME OVER!", Simulation::SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 - 100,
+                     50, RED);
         }
     }
 
-    void Draw() {
-        ClearBackground(RAYWHITE);
+public:
+    explicit SpectatorScreen(std::uint8_t stream) : view(stream) {}
+
+    bool Connect(const char* host, std::uint16_t port) { return client.Connect(host, port); }
 
-        tower.Draw();           // Draw STACK
+    void Update(double now) {
+        client.Poll(now, view);
 
-        if (!gameOver) {
-            currentBlock.Draw();
+        // Same lock-step camera as the game, led by the moving block
+        float top = view.HasMovingBlock() ? view.GetMovingBlock().GetTop()
+                  : (view.GetTower().IsEmpty() ? SCREEN_HEIGHT : view.GetTower().Top().GetTop());
+        float scroll = std::max(0.0f, CAMERA_LEAD_Y - top);
+        if (scroll != cameraScroll) {
+            cameraScroll = scroll;
+            towerLayer.Invalidate();
         }
 
-        DrawUI();
-        DrawNextBlockPreview();  // Draw QUEUE preview
-        DrawInstructions();
+        // STACK: Blocks below the top can change (catch-up, server rewind),
+        // so rebuild the vertex cache when the view says the tower changed
+        if (view.GetRevision() != drawnRevision) {
+            drawnRevision = view.GetRevision();
+            towerRenderer.Invalidate();
+            towerRenderer.Sync(view.GetTower());
+            towerLayer.Invalidate();
+        }
 
-        if (gameOver) {
-            DrawGameOverScreen();
+        std::uint64_t height = view.GetHeight();
+        bool waiting = IsWaiting(now);
+        if (view.GetScore() != hudScore || height != hudHeight ||
+            view.IsGameOver() != hudGameOver || waiting != hudWaiting) {
+            hudScore = view.GetScore();
+            hudHeight = height;
+            hudGameOver = view.IsGameOver();
+            hudWaiting = waiting;
+            hudLayer.Invalidate();
         }
+    }
 
-        if (isPaused) {
-            DrawText("PAUSED", SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 20, 40, RED);
+    void Draw(double now) {
+        int width = GetScreenWidth();
+        int height = GetScreenHeight();
+        towerLayer.EnsureSize(width, height);
+        hudLayer.EnsureSize(width, height);
+
+        ViewTransform world;
+        world.offsetY = cameraScroll;
+        float viewTop = -cameraScroll;
+        float viewBottom = SCREEN_HEIGHT - cameraScroll;
+
+        towerLayer.Update([&]() {
+            towerRenderer.Draw(view.GetTower(), viewTop, viewBottom, world);
+        });
+        hudLayer.Update([&]() { DrawHud(now); });
+
+        ClearBackground(RAYWHITE);
+        towerLayer.Draw();
+        if (view.HasMovingBlock() && !view.IsGameOver()) {
+            TowerRenderer::DrawBlock(view.GetMovingBlock(), viewTop, viewBottom, world);
         }
+        hudLayer.Draw();
     }
 };
 
@@ -547,23 +1140,242 @@ public:
 // MAIN FUNCTION
 // ============================================================================
 
-int main() {
-    const int screenWidth = 800;
-    const int screenHeight = 600;
+namespace {
+
+constexpr const char* ASSET_BUNDLE_PATH = "assets.tbab";
+constexpr const char* PLAYER_ID_PATH = "player_id.txt";  // Leaderboard identity
+constexpr const char* TELEMETRY_PATH = "telemetry.tbtm";  // Default for --telemetry
+constexpr double ASSET_UPLOAD_BUDGET_SECONDS = 0.004;  // Per frame, of ~16.7 ms
+
+struct LaunchOptions {
+    int playerCount = 1;                 // --players N
+    int spectatePort = -1;               // --spectate [PORT]; -1 = not streaming
+    const char* watchHost = nullptr;     // --watch HOST[:PORT]
+    std::uint16_t watchPort = SpectatorServer::DEFAULT_PORT;
+    int watchStream = 0;                 // --stream N (1-based on the command line)
+    bool practice = false;               // --practice
+    int botCount = 0;                    // --bots N, or every player with --autoplay
+    bool autoplay = false;               // --autoplay
+    const char* leaderboardHost = nullptr;  // --leaderboard HOST[:PORT]
+    std::uint16_t leaderboardPort = LeaderboardClient::DEFAULT_PORT;
+    std::uint64_t playerId = 0;          // --player ID; 0 = the one in PLAYER_ID_PATH
+    const char* telemetryPath = nullptr; // --telemetry [FILE]
+};
 
-    InitWindow(screenWidth, screenHeight, "Tower Builder - Data Structures Demo");
+// Copy HOST or HOST:PORT into `host`, setting `port` if one is given
+void ParseHostPort(const char* value, char* host, std::size_t size, std::uint16_t& port) {
+    std::snprintf(host, size, "%s", value);
+    if (char* colon = std::strrchr(host, ':')) {
+        *colon = '\0';
+        port = static_cast<std::uint16_t>(std::atoi(colon + 1));
+    }
+}
+
+// This install's leaderboard id: read from PLAYER_ID_PATH, or drawn at
+// random and saved there on first use
+std::uint64_t LoadPlayerId() {
+    unsigned long long id = 0;
+    if (std::FILE* file = std::fopen(PLAYER_ID_PATH, "r")) {
+        if (std::fscanf(file, "%llu", &id) != 1) id = 0;
+        std::fclose(file);
+    }
+    if (id != 0) return id;
+
+    std::random_device device;
+    id = ((static_cast<unsigned long long>(device()) << 32) | device()) | 1;
+    if (std::FILE* file = std::fopen(PLAYER_ID_PATH, "w")) {
+        std::fprintf(file, "%llu\n", id);
+        std::fclose(file);
+    }
+    return id;
+}
+
+LaunchOptions ParseLaunchOptions(int argc, char** argv) {
+    LaunchOptions options;
+    static char watchHost[256];
+    static char leaderboardHost[256];
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool hasNumber = value != nullptr && value[0] >= '0' && value[0] <= '9';
+
+        if (std::strcmp(argv[i], "--players") == 0 && hasNumber) {
+            options.playerCount = std::clamp(std::atoi(value), 1, Game::MAX_PLAYERS);
+            i++;
+        } else if (std::strcmp(argv[i], "--spectate") == 0) {
+            options.spectatePort = hasNumber ? std::atoi(value) : SpectatorServer::DEFAULT_PORT;
+            if (hasNumber) i++;
+        } else if (std::strcmp(argv[i], "--watch") == 0 && value != nullptr) {
+            ParseHostPort(value, watchHost, sizeof(watchHost), options.watchPort);
+            options.watchHost = watchHost;
+            i++;
+        } else if (std::strcmp(argv[i], "--leaderboard") == 0 && value != nullptr) {
+            ParseHostPort(value, leaderboardHost, sizeof(leaderboardHost), options.leaderboardPort);
+            options.leaderboardHost = leaderboardHost;
+            i++;
+        } else if (std::strcmp(argv[i], "--player") == 0 && hasNumber) {
+            options.playerId = std::strtoull(value, nullptr, 10);
+            i++;
+        } else if (std::strcmp(argv[i], "--telemetry") == 0) {
+            bool hasPath = value != nullptr && std::strncmp(value, "--", 2) != 0;
+            options.telemetryPath = hasPath ? value : TELEMETRY_PATH;
+            if (hasPath) i++;
+        } else if (std::strcmp(argv[i], "--practice") == 0) {
+            options.practice = true;
+        } else if (std::strcmp(argv[i], "--bots") == 0 && hasNumber) {
+            options.botCount = std::clamp(std::atoi(value), 0, Game::MAX_PLAYERS);
+            i++;
+        } else if (std::strcmp(argv[i], "--autoplay") == 0) {
+            options.autoplay = true;
+        } else if (std::strcmp(argv[i], "--stream") == 0 && hasNumber) {
+            options.watchStream = std::clamp(std::atoi(value), 1, Game::MAX_PLAYERS) - 1;
+            i++;
+        }
+    }
+    if (options.autoplay) options.botCount = Game::MAX_PLAYERS;
+    return options;
+}
+
+void RunSpectator(const LaunchOptions& options) {
     SetTargetFPS(60);
 
-    Game game;
+    SpectatorScreen screen(static_cast<std::uint8_t>(options.watchStream));
+    if (!screen.Connect(options.watchHost, options.watchPort)) {
+        TraceLog(LOG_WARNING, "Could not reach %s:%d", options.watchHost, options.watchPort);
+        return;
+    }
+
+    while (!WindowShouldClose()) {
+        double now = GetTime();
+        screen.Update(now);
+        BeginDrawing();
+        screen.Draw(now);
+        EndDrawing();
+    }
+}
+
+void RunGame(const LaunchOptions& options, AssetLoader& assets,
+             std::chrono::steady_clock::time_point launchTime) {
+    const double frameSeconds = 1.0 / 60.0;       // Render rate
+    const double inputPollSeconds = 1.0 / 1000.0; // Input sampling while waiting
+
+    // Frames are paced here instead of by raylib, so the wait for the next
+    // frame can poll input at ~1 kHz and timestamp presses precisely
+    SetTargetFPS(0);
+
+    Game game(options.playerCount, options.practice, &assets, options.botCount);
+    if (options.spectatePort >= 0) {
+        if (game.StartSpectatorServer(static_cast<std::uint16_t>(options.spectatePort))) {
+            TraceLog(LOG_INFO, "Streaming to spectators on UDP port %d", options.spectatePort);
+        } else {
+            TraceLog(LOG_WARNING, "Could not open UDP port %d for spectators",
+                     options.spectatePort);
+        }
+    }
+    if (options.leaderboardHost != nullptr) {
+        std::uint64_t playerId = options.playerId != 0 ? options.playerId : LoadPlayerId();
+        if (game.StartLeaderboard(options.leaderboardHost, options.leaderboardPort, playerId)) {
+            TraceLog(LOG_INFO, "Submitting to the leaderboard at %s:%d as player %llu",
+                     options.leaderboardHost, options.leaderboardPort,
+                     static_cast<unsigned long long>(playerId));
+        } else {
+            TraceLog(LOG_WARNING, "Could not reach leaderboard %s:%d",
+                     options.leaderboardHost, options.leaderboardPort);
+        }
+    }
+    // The ring is allocated here, so the frame loop only ever pushes
+    if (options.telemetryPath != nullptr) {
+        if (Telemetry::Get().Start(options.telemetryPath)) {
+            Telemetry::Get().AttachThread();
+            TraceLog(LOG_INFO, "Writing telemetry to %s", options.telemetryPath);
+        } else {
+            TraceLog(LOG_WARNING, "Could not open %s for telemetry", options.telemetryPath);
+        }
+    }
+    double nextFrame = GetTime();
+    bool firstFrame = true;
 
     while (!WindowShouldClose()) {
-        game.Update();
+#ifdef TOWERBUILDER_PROFILER
+        FrameProfiler::Get().BeginFrame();
+#endif
+        game.Update(GetTime());
+        game.PublishToSpectators(GetTime());
+        game.SyncLeaderboard(GetTime());
 
         BeginDrawing();
         game.Draw();
-        EndDrawing();
+        {
+            PROFILE_SCOPE("EndDrawing");
+            EndDrawing();        // Presents the frame, then polls input once
+        }
+
+        game.OnFramePresented(GetTime());
+        game.SampleInput();
+
+        if (firstFrame) {
+            std::chrono::duration<double, std::milli> startup =
+                std::chrono::steady_clock::now() - launchTime;
+            TraceLog(LOG_INFO, "First frame presented %.1f ms after launch", startup.count());
+            firstFrame = false;
+        }
+
+        // Upload whatever the loader decoded, then wait out the frame
+        assets.Pump(ASSET_UPLOAD_BUDGET_SECONDS);
+
+        // Wait out the rest of the frame, sampling input as we go
+        {
+            PROFILE_SCOPE("InputWait");
+            nextFrame += frameSeconds;
+            double now = GetTime();
+            if (nextFrame < now) nextFrame = now;  // Fell behind: don't try to catch up
+            while (now < nextFrame) {
+                WaitTime(std::min(inputPollSeconds, nextFrame - now));
+                PollInputEvents();
+                game.SampleInput();
+                now = GetTime();
+            }
+        }
+#ifdef TOWERBUILDER_PROFILER
+        FrameProfiler::Get().EndFrame();
+#endif
+    }
+
+    if (Telemetry::Get().IsRunning()) {
+        Telemetry::Get().Stop();
+        TraceLog(LOG_INFO, "Telemetry: %llu events written, %llu dropped",
+                 static_cast<unsigned long long>(Telemetry::Get().GetWrittenEvents()),
+                 static_cast<unsigned long long>(Telemetry::Get().GetDroppedEvents()));
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto launchTime = std::chrono::steady_clock::now();
+    LaunchOptions options = ParseLaunchOptions(argc, argv);
+
+    // Start decoding before the window opens, so the two overlap; nothing
+    // waits for the assets
+    AssetLoader assets;
+    if (options.watchHost == nullptr && !assets.Start(ASSET_BUNDLE_PATH)) {
+        TraceLog(LOG_INFO, "No asset bundle at %s, running without assets", ASSET_BUNDLE_PATH);
+    }
+
+    const int screenWidth = 800;
+    const int screenHeight = 600;
+    InitWindow(screenWidth, screenHeight, options.watchHost != nullptr
+               ? "Tower Builder - Spectator" : "Tower Builder - Data Structures Demo");
+
+    // Run inside functions so render layers are unloaded while the GL
+    // context still exists
+    if (options.watchHost != nullptr) {
+        RunSpectator(options);
+    } else {
+        RunGame(options, assets, launchTime);
     }
 
+    assets.Unload();  // Textures and sounds go before their context does
     CloseWindow();
     return 0;
 }
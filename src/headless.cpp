@@ -0,0 +1,148 @@
+/**
+ * Tower Builder - Headless simulator
+ *
+ * Plays games back to back with no window, stepping the Simulation at a
+ * fixed tick rate as fast as the CPU allows. A simple aiming bot drops the
+ * block once its left edge comes within a tolerance of the tower top.
+ *
+ * Usage:
+ *   TowerBuilderHeadless [--games N] [--tick-rate HZ] [--tolerance PX]
+ *                        [--max-ticks N] [--seed S] [--record DIR]
+ *
+ * Game n uses the block sequence seeded by (--seed, n); only the block
+ * colours depend on it. With --record, every finished game is saved as DIR/game_<n>.tbr for
+ * TowerBuilderReplay.
+ */
+
+#include "drop_policy.h"
+#include "replay.h"
+#include "score_history.h"
+#include "simulation.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+struct HeadlessOptions {
+    int games = 1000;
+    float tickRate = 240.0f;        // Simulation steps per simulated second
+    float tolerance = 3.0f;         // Bot drops when |x - top.x| <= tolerance
+    long long maxTicks = 1000000;   // Per-game cap so perfect bots terminate
+    std::uint64_t seed = 1;         // Run seed; game n plays GameSeed(seed, n)
+    const char* recordDir = nullptr; // Save a replay of each finished game here
+};
+
+void PrintUsage(const char* program) {
+    std::printf("Usage: %s [--games N] [--tick-rate HZ] [--tolerance PX] [--max-ticks N]\n"
+                "          [--seed S] [--record DIR]\n",
+                program);
+}
+
+bool ParseOptions(int argc, char** argv, HeadlessOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--help") == 0) {
+            return false;
+        } else if (value == nullptr) {
+            std::fprintf(stderr, "Missing value for %s\n", arg);
+            return false;
+        } else if (std::strcmp(arg, "--games") == 0) {
+            options.games = std::atoi(value);
+        } else if (std::strcmp(arg, "--tick-rate") == 0) {
+            options.tickRate = static_cast<float>(std::atof(value));
+        } else if (std::strcmp(arg, "--tolerance") == 0) {
+            options.tolerance = static_cast<float>(std::atof(value));
+        } else if (std::strcmp(arg, "--max-ticks") == 0) {
+            options.maxTicks = std::atoll(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--record") == 0) {
+            options.recordDir = value;
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+        i++;
+    }
+    return options.games > 0 && options.tickRate > 0.0f && options.maxTicks > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    HeadlessOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    Simulation simulation;
+    ScoreHistory scoreHistory;  // LINKED LIST: One node per finished game
+    ReplayRecorder recorder;
+    int recordFailures = 0;
+
+    SimInput input;
+    input.deltaTime = 1.0f / options.tickRate;
+
+    long long totalTicks = 0;
+    long long totalHeight = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int game = 0; game < options.games; game++) {
+        simulation.Reset(GameSeed(options.seed, game));
+        if (options.recordDir != nullptr) {
+            recorder.Begin(simulation.GetParams(), options.tickRate, simulation.GetSeed());
+        }
+
+        long long ticks = 0;
+        while (!simulation.IsGameOver() && ticks < options.maxTicks) {
+            const Block& current = simulation.GetCurrentBlock();
+            const Block& top = simulation.GetTower().Top();
+            input.drop = std::fabs(current.GetLeft() - top.GetLeft()) <= options.tolerance;
+
+            if (input.drop && options.recordDir != nullptr) {
+                recorder.RecordDrop(ReplayDrop{static_cast<std::uint64_t>(ticks), false, 0});
+            }
+
+            simulation.Step(input);
+            ticks++;
+        }
+
+        // Only finished games make valid replays
+        if (options.recordDir != nullptr && simulation.IsGameOver()) {
+            recorder.Finish(simulation.GetScore(), simulation.GetTowerHeight(),
+                            static_cast<std::uint64_t>(ticks));
+            char path[1024];
+            std::snprintf(path, sizeof(path), "%s/game_%d.tbr", options.recordDir, game);
+            if (!recorder.Save(path)) recordFailures++;
+        }
+
+        totalTicks += ticks;
+        totalHeight += simulation.GetTowerHeight();
+        scoreHistory.AddScore(simulation.GetScore(), simulation.GetTowerHeight());
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count();
+
+    std::printf("Games:        %d\n", scoreHistory.GetCount());
+    std::printf("Ticks:        %lld\n", totalTicks);
+    std::printf("Elapsed:      %.3f s\n", seconds);
+    std::printf("Ticks/s:      %.0f\n", seconds > 0 ? totalTicks / seconds : 0.0);
+    std::printf("Mean height:  %.2f\n", static_cast<double>(totalHeight) / options.games);
+    std::printf("Best height:  %d\n", scoreHistory.GetBestHeight());
+    std::printf("Best score:   %d\n", scoreHistory.GetBestScore());
+    if (recordFailures > 0) {
+        std::fprintf(stderr, "Could not write %d replays to %s\n", recordFailures,
+                     options.recordDir);
+        return 1;
+    }
+    return 0;
+}
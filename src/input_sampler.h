@@ -0,0 +1,79 @@
+/**
+ * InputSampler - Timestamps key presses between frames
+ *
+ * WHY SAMPLE BETWEEN FRAMES?
+ * - raylib polls input once per frame, so IsKeyPressed() only says that a
+ *   key went down at some point during the last ~16 ms
+ * - The main loop paces frames itself and calls PollInputEvents() about
+ *   every millisecond while it waits; Sample() runs after each poll and
+ *   stamps new presses with that poll's time
+ * - A press is stamped with the midpoint between the poll that saw it and
+ *   the one before, so its timestamp error is half a poll interval
+ *
+ * Every extra poll resets raylib's "pressed this frame" edge, so all keys
+ * the game reacts to must be read from here rather than IsKeyPressed().
+ *
+ * Time Complexity:
+ * - Sample: O(tracked keys)
+ * - ConsumePress: O(tracked keys)
+ */
+
+#pragma once
+
+#include "raylib.h"
+
+class InputSampler {
+public:
+    static constexpr int MAX_KEYS = 16;
+
+    // Start latching presses of `key`
+    void Track(int key) {
+        if (keyCount < MAX_KEYS) {
+            keys[keyCount++] = KeyLatch{key, false, 0.0};
+        }
+    }
+
+    // Call after every PollInputEvents() (EndDrawing() polls once itself)
+    void Sample() {
+        double now = GetTime();
+        double pressTime = lastSampleTime > 0.0 ? (lastSampleTime + now) / 2 : now;
+        lastSampleTime = now;
+
+        for (int i = 0; i < keyCount; i++) {
+            if (!keys[i].pressed && IsKeyPressed(keys[i].key)) {
+                keys[i].pressed = true;
+                keys[i].time = pressTime;
+            }
+        }
+    }
+
+    // True once per press; `time` receives the GetTime() estimate of the press
+    bool ConsumePress(int key, double* time = nullptr) {
+        KeyLatch* latch = Find(key);
+        if (latch == nullptr || !latch->pressed) return false;
+        latch->pressed = false;
+        if (time != nullptr) *time = latch->time;
+        return true;
+    }
+
+    // Drop a latched press of `key` that should not be acted on
+    void Discard(int key) { ConsumePress(key); }
+
+private:
+    struct KeyLatch {
+        int key;
+        bool pressed;   // Seen down since last consumed
+        double time;    // Estimated press time (GetTime() clock)
+    };
+
+    KeyLatch keys[MAX_KEYS] = {};
+    int keyCount = 0;
+    double lastSampleTime = 0.0;
+
+    KeyLatch* Find(int key) {
+        for (int i = 0; i < keyCount; i++) {
+            if (keys[i].key == key) return &keys[i];
+        }
+        return nullptr;
+    }
+};
@@ -0,0 +1,312 @@
+/**
+ * Leaderboard - Sharded global ranking of players' best verified scores
+ * See leaderboard.h for an overview.
+ */
+
+#include "leaderboard.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+
+namespace {
+
+// Player ids are often sequential; mix them so shards fill evenly
+std::uint64_t MixPlayerId(std::uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+LeaderboardLogHeader MakeLogHeader() {
+    return LeaderboardLogHeader{LeaderboardLogHeader::MAGIC, LeaderboardLogHeader::VERSION,
+                                static_cast<std::uint32_t>(sizeof(LeaderboardEntry)), 0};
+}
+
+// Append every entry of the log at `path` to `entries`. A missing file is
+// an empty log; a torn last entry (crash mid-write) is ignored.
+bool ReadLog(const std::string& path, std::vector<LeaderboardEntry>& entries) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) return true;
+
+    LeaderboardLogHeader header;
+    LeaderboardLogHeader expected = MakeLogHeader();
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+              header.magic == expected.magic && header.version == expected.version &&
+              header.entrySize == expected.entrySize;
+    LeaderboardEntry entry;
+    while (ok && std::fread(&entry, sizeof(entry), 1, file) == 1) {
+        entries.push_back(entry);
+    }
+    std::fclose(file);
+    return ok;
+}
+
+}  // namespace
+
+Leaderboard::Leaderboard(int shardCount, int producerCount)
+    : shardCount(std::clamp(shardCount, 1, MAX_SHARDS)),
+      producerCount(std::max(producerCount, 1)) {
+    for (int s = 0; s < this->shardCount; s++) {
+        shards.push_back(std::make_unique<Shard>());
+        shards.back()->batch.reserve(BATCH_SIZE);
+        shards.back()->improved.reserve(BATCH_SIZE);
+        shards.back()->taken.assign(static_cast<std::size_t>(this->producerCount), 0);
+    }
+    std::size_t laneCount = static_cast<std::size_t>(this->producerCount) * this->shardCount;
+    lanes = std::make_unique<Lane[]>(laneCount);
+}
+
+int Leaderboard::ShardOf(std::uint64_t playerId) const {
+    return static_cast<int>(MixPlayerId(playerId) % static_cast<std::uint64_t>(shardCount));
+}
+
+std::string Leaderboard::LogPath(int shard) const {
+    return directory + "/shard-" + std::to_string(shard) + ".tblb";
+}
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+bool Leaderboard::Open(const char* path) {
+    Close();
+    directory = path != nullptr ? path : "";
+
+    if (!directory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (!LoadAndCompact()) return false;
+    }
+
+    running.store(true, std::memory_order_release);
+    for (int s = 0; s < shardCount; s++) {
+        shards[s]->worker = std::thread(&Leaderboard::RunWorker, this, s);
+    }
+    return true;
+}
+
+bool Leaderboard::LoadAndCompact() {
+    // Any shard count may have written these, so read every shard file
+    // there could be and route each entry by the current count
+    std::vector<LeaderboardEntry> entries;
+    for (int s = 0; s < MAX_SHARDS; s++) {
+        if (!ReadLog(LogPath(s), entries)) return false;
+    }
+    for (const LeaderboardEntry& entry : entries) {
+        Apply(*shards[ShardOf(entry.playerId)], entry);
+    }
+
+    // Rewrite each shard's log with one entry per player; the temporary
+    // file replaces the old one only once it is complete
+    LeaderboardLogHeader header = MakeLogHeader();
+    for (int s = 0; s < shardCount; s++) {
+        Shard& shard = *shards[s];
+        std::string path = LogPath(s);
+        std::string temporary = path + ".tmp";
+
+        std::FILE* file = std::fopen(temporary.c_str(), "wb");
+        if (file == nullptr) return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        for (const auto& player : shard.best) {
+            ok = ok && std::fwrite(&player.second, sizeof(LeaderboardEntry), 1, file) == 1;
+        }
+        ok = std::fclose(file) == 0 && ok;
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (!ok || error) return false;
+
+        shard.log = std::fopen(path.c_str(), "ab");
+        if (shard.log == nullptr) return false;
+        shard.appliedTotal = 0;
+    }
+    for (int s = shardCount; s < MAX_SHARDS; s++) {
+        std::error_code error;
+        std::filesystem::remove(LogPath(s), error);  // Rerouted into the shards above
+    }
+    return true;
+}
+
+void Leaderboard::Close() {
+    if (running.exchange(false, std::memory_order_acq_rel)) {
+        for (auto& shard : shards) {
+            if (shard->worker.joinable()) shard->worker.join();
+        }
+    }
+    for (auto& shard : shards) {
+        if (shard->log != nullptr) {
+            std::fclose(shard->log);
+            shard->log = nullptr;
+        }
+    }
+}
+
+// ============================================================================
+// INGESTION
+// ============================================================================
+
+bool Leaderboard::Submit(int producer, const LeaderboardEntry& entry) {
+    Lane& lane = GetLane(producer, ShardOf(entry.playerId));
+    if (!lane.ring.TryPush(entry)) return false;
+    // Only this producer writes `pushed`, so a plain load and store is
+    // enough; release orders it after the push for Flush
+    lane.pushed.store(lane.pushed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    return true;
+}
+
+bool Leaderboard::Apply(Shard& shard, const LeaderboardEntry& entry) {
+    shard.appliedTotal++;
+    auto found = shard.best.find(entry.playerId);
+    if (found != shard.best.end()) {
+        if (entry.score <= found->second.score) return false;  // Ties keep the earlier entry
+        shard.ranking.Erase(KeyOf(found->second));
+        found->second = entry;
+    } else {
+        shard.best.emplace(entry.playerId, entry);
+    }
+    shard.ranking.Insert(KeyOf(entry));
+    return true;
+}
+
+void Leaderboard::RunWorker(int shardIndex) {
+    Shard& shard = *shards[shardIndex];
+
+    for (;;) {
+        // Read the flag before draining, so a Close() issued before this
+        // drain still gets everything submitted before it
+        bool stopping = !running.load(std::memory_order_acquire);
+
+        // QUEUE: take up to a batch, spread across every producer's lane
+        shard.batch.clear();
+        std::size_t share = std::max<std::size_t>(BATCH_SIZE / producerCount, 1);
+        for (int p = 0; p < producerCount; p++) {
+            Lane& lane = GetLane(p, shardIndex);
+            std::size_t taken = 0;
+            LeaderboardEntry entry;
+            while (taken < share && lane.ring.TryPop(entry)) {
+                shard.batch.push_back(entry);
+                taken++;
+            }
+            shard.taken[p] = taken;
+        }
+
+        if (shard.batch.empty()) {
+            if (stopping) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // One exclusive lock for the whole batch
+        shard.improved.clear();
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            for (const LeaderboardEntry& entry : shard.batch) {
+                if (Apply(shard, entry)) shard.improved.push_back(entry);
+            }
+        }
+
+        // One write per batch; the log is only read back on Open()
+        if (shard.log != nullptr && !shard.improved.empty()) {
+            std::fwrite(shard.improved.data(), sizeof(LeaderboardEntry), shard.improved.size(),
+                        shard.log);
+            std::fflush(shard.log);
+        }
+
+        for (int p = 0; p < producerCount; p++) {
+            if (shard.taken[p] == 0) continue;
+            Lane& lane = GetLane(p, shardIndex);
+            lane.applied.store(lane.applied.load(std::memory_order_relaxed) + shard.taken[p],
+                               std::memory_order_release);
+        }
+    }
+}
+
+void Leaderboard::Flush() const {
+    for (int p = 0; p < producerCount; p++) {
+        for (int s = 0; s < shardCount; s++) {
+            const Lane& lane = GetLane(p, s);
+            std::uint64_t target = lane.pushed.load(std::memory_order_acquire);
+            while (lane.applied.load(std::memory_order_acquire) < target) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+std::uint64_t Leaderboard::GetRankForScore(std::int32_t score) const {
+    // Sorts before every entry with this score and after every higher one
+    RankKey key{score, INT64_MIN, 0};
+    std::uint64_t ahead = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        ahead += shard->ranking.CountBefore(key);
+    }
+    return ahead + 1;
+}
+
+LeaderboardStanding Leaderboard::GetStanding(std::uint64_t playerId) const {
+    LeaderboardStanding standing;
+    {
+        const Shard& home = *shards[ShardOf(playerId)];
+        std::shared_lock<std::shared_mutex> lock(home.mutex);
+        auto found = home.best.find(playerId);
+        if (found != home.best.end()) {
+            standing.found = true;
+            standing.best = found->second;
+        }
+    }
+
+    RankKey key = KeyOf(standing.best);
+    std::uint64_t ahead = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        if (standing.found) ahead += shard->ranking.CountBefore(key);
+        standing.playerCount += shard->ranking.GetSize();
+    }
+    if (standing.found) standing.rank = ahead + 1;
+    return standing;
+}
+
+std::vector<LeaderboardEntry> Leaderboard::GetTop(std::size_t count) const {
+    // The global top k is among the union of every shard's top k
+    std::vector<LeaderboardEntry> top;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        shard->ranking.VisitFirst(count, [&](const RankKey& key) {
+            top.push_back(shard->best.at(key.playerId));
+        });
+    }
+
+    std::sort(top.begin(), top.end(), [](const LeaderboardEntry& a, const LeaderboardEntry& b) {
+        return RankOrder()(KeyOf(a), KeyOf(b));
+    });
+    if (top.size() > count) top.resize(count);
+    return top;
+}
+
+std::uint64_t Leaderboard::GetPlayerCount() const {
+    std::uint64_t count = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        count += shard->ranking.GetSize();
+    }
+    return count;
+}
+
+std::uint64_t Leaderboard::GetAppliedCount() const {
+    std::uint64_t count = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        count += shard->appliedTotal;
+    }
+    return count;
+}
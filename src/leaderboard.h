@@ -0,0 +1,199 @@
+/**
+ * Leaderboard - Sharded global ranking of players' best verified scores
+ *
+ * ScoreHistory is one player's games on one machine. The leaderboard
+ * server (leaderboard_server.cpp) collects every player's best instead,
+ * fed by receive threads that have already re-simulated each replay:
+ *
+ *     receive thread p  --Submit-->  lane (p, s)  -->  shard s worker
+ *                                  (SpscRing)          apply batch, log
+ *
+ * WHY SHARDS?
+ * - A player always hashes to the same shard, so a shard alone decides
+ *   whether a submission beats that player's best; shards never
+ *   coordinate on writes
+ * - Each shard has its own worker, skip list and log file, so ingestion
+ *   scales with cores instead of serializing on one structure
+ *
+ * WHY ONE RING PER (PRODUCER, SHARD)?
+ * - Every ring has exactly one producer and one consumer, so Submit is a
+ *   wait-free SpscRing push (see spsc_ring.h) with no lock and no shared
+ *   counter; a full ring is reported, never waited on
+ * - The worker drains each of its rings into a batch and applies the
+ *   whole batch under a single exclusive lock, so queries contend with
+ *   one lock per batch rather than one per submission
+ *
+ * Rank queries take each shard's lock shared and sum
+ * RankSkipList::CountBefore over the shards: one O(log n) walk per shard,
+ * a few microseconds even with millions of players.
+ *
+ * Persistence: each shard appends the entries that improved a best to
+ * its own log, once per batch. Open() replays every log (keeping each
+ * player's best) and rewrites them compacted, one entry per player, so
+ * the files stay as large as the leaderboard and a change in shard count
+ * just reroutes players.
+ *
+ * Log layout (native endianness, fixed-width fields):
+ *
+ *     LeaderboardLogHeader   magic, version, entry size
+ *     LeaderboardEntry[...]  in the order they were applied
+ *
+ * Time Complexity:
+ * - Submit: O(1), wait-free
+ * - Applying a submission: O(log n) expected
+ * - GetRankForScore / GetStanding: O(shards x log n)
+ * - GetTop(k): O(shards x (log n + k))
+ */
+
+#pragma once
+
+#include "rank_skiplist.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * One player's result, as submitted and as stored
+ */
+struct LeaderboardEntry {
+    std::uint64_t playerId = 0;
+    std::int32_t score = 0;
+    std::int32_t height = 0;
+    std::uint64_t seed = 0;      // Block sequence the score was set on
+    std::int64_t timestamp = 0;  // Unix time in seconds it was accepted
+};
+
+struct LeaderboardLogHeader {
+    static constexpr std::uint32_t MAGIC = 0x424C4254;  // "TBLB"
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t entrySize;
+    std::uint32_t reserved;
+};
+
+// Where one player stands
+struct LeaderboardStanding {
+    bool found = false;
+    std::uint64_t rank = 0;         // 1 = best; 0 if not found
+    LeaderboardEntry best;          // The player's best entry
+    std::uint64_t playerCount = 0;
+};
+
+class Leaderboard {
+public:
+    static constexpr int MAX_SHARDS = 64;
+    static constexpr std::size_t LANE_CAPACITY = 2048;  // Submissions in flight per lane
+    static constexpr std::size_t BATCH_SIZE = 1024;     // Most a worker applies per lock
+
+    // `producerCount` threads may call Submit, each with its own index
+    Leaderboard(int shardCount, int producerCount);
+    ~Leaderboard() { Close(); }
+
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+
+    /**
+     * Load and compact the logs in `directory` (created if missing), then
+     * start the shard workers. nullptr keeps the leaderboard in memory
+     * only. Returns false on I/O error.
+     */
+    bool Open(const char* directory);
+
+    // Apply everything submitted, stop the workers and close the logs
+    void Close();
+    bool IsOpen() const { return running.load(std::memory_order_acquire); }
+
+    /**
+     * Queue `entry` from producer thread `producer`. Returns false (and
+     * drops the entry) if that producer's lane to the shard is full;
+     * the caller reports it to the client, which may resend.
+     */
+    bool Submit(int producer, const LeaderboardEntry& entry);
+
+    // Wait until every entry submitted so far is applied and logged
+    void Flush() const;
+
+    // 1 + players whose best is strictly higher than `score`
+    std::uint64_t GetRankForScore(std::int32_t score) const;
+
+    LeaderboardStanding GetStanding(std::uint64_t playerId) const;
+
+    // The best `count` entries, best first
+    std::vector<LeaderboardEntry> GetTop(std::size_t count) const;
+
+    std::uint64_t GetPlayerCount() const;
+    int GetShardCount() const { return shardCount; }
+    int GetProducerCount() const { return producerCount; }
+
+    // Total submissions each worker has applied, improving or not
+    std::uint64_t GetAppliedCount() const;
+
+private:
+    // Ranking key: higher score first, then whoever got there first, then
+    // player id, so every entry has a distinct place
+    struct RankKey {
+        std::int32_t score;
+        std::int64_t timestamp;
+        std::uint64_t playerId;
+    };
+    struct RankOrder {
+        bool operator()(const RankKey& a, const RankKey& b) const {
+            if (a.score != b.score) return a.score > b.score;
+            if (a.timestamp != b.timestamp) return a.timestamp < b.timestamp;
+            return a.playerId < b.playerId;
+        }
+    };
+
+    // QUEUE: one producer's submissions to one shard
+    struct Lane {
+        SpscRing<LeaderboardEntry, LANE_CAPACITY> ring;
+        alignas(64) std::atomic<std::uint64_t> pushed{0};   // Written by the producer
+        alignas(64) std::atomic<std::uint64_t> applied{0};  // Written by the worker
+    };
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;  // Exclusive per batch, shared per query
+        RankSkipList<RankKey, RankOrder> ranking;
+        std::unordered_map<std::uint64_t, LeaderboardEntry> best;
+        std::FILE* log = nullptr;
+        std::thread worker;
+        std::uint64_t appliedTotal = 0;   // Guarded by mutex
+
+        // Worker scratch, reused every batch
+        std::vector<LeaderboardEntry> batch;
+        std::vector<LeaderboardEntry> improved;
+        std::vector<std::uint64_t> taken;  // Entries popped per lane this batch
+    };
+
+    int shardCount;
+    int producerCount;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::unique_ptr<Lane[]> lanes;  // producerCount x shardCount, row per producer
+    std::atomic<bool> running{false};
+    std::string directory;
+
+    static RankKey KeyOf(const LeaderboardEntry& entry) {
+        return RankKey{entry.score, entry.timestamp, entry.playerId};
+    }
+
+    int ShardOf(std::uint64_t playerId) const;
+    Lane& GetLane(int producer, int shard) const { return lanes[producer * shardCount + shard]; }
+    std::string LogPath(int shard) const;
+
+    // Caller holds the shard's lock exclusively; true if `entry` is a new best
+    static bool Apply(Shard& shard, const LeaderboardEntry& entry);
+
+    bool LoadAndCompact();
+    void RunWorker(int shardIndex);
+};
@@ -0,0 +1,186 @@
+/**
+ * Leaderboard protocol - Replay submissions and rank queries over UDP
+ * See leaderboard_net.h for an overview.
+ */
+
+#include "leaderboard_net.h"
+#include "byte_io.h"
+
+#include <algorithm>
+
+namespace {
+
+// Replies are tiny; only the server receives replays
+constexpr std::size_t REPLY_CAPACITY = 256;
+
+// Refresh the standing this soon after an ack, once the shard worker has
+// applied the submission
+constexpr double STANDING_AFTER_ACK = 0.25;
+
+std::uint64_t PutScore(std::int32_t score) {
+    return static_cast<std::uint64_t>(std::max(score, 0));
+}
+
+std::vector<std::uint8_t> BeginPacket(std::uint8_t type) {
+    return std::vector<std::uint8_t>{type, LEADERBOARD_PROTOCOL_VERSION};
+}
+
+bool IsPacket(const std::uint8_t* data, std::size_t size, std::uint8_t type) {
+    return size >= 2 && data[0] == type && data[1] == LEADERBOARD_PROTOCOL_VERSION;
+}
+
+}  // namespace
+
+// ============================================================================
+// CODEC
+// ============================================================================
+
+std::vector<std::uint8_t> EncodeLeaderboardSubmit(std::uint64_t playerId, std::uint64_t requestId,
+                                                  const std::vector<std::uint8_t>& replay) {
+    std::vector<std::uint8_t> bytes = BeginPacket(LEADERBOARD_SUBMIT);
+    PutVarint(bytes, playerId);
+    PutVarint(bytes, requestId);
+    bytes.insert(bytes.end(), replay.begin(), replay.end());
+    return bytes;
+}
+
+std::vector<std::uint8_t> EncodeLeaderboardQuery(std::uint64_t playerId) {
+    std::vector<std::uint8_t> bytes = BeginPacket(LEADERBOARD_QUERY);
+    PutVarint(bytes, playerId);
+    bytes.resize(LEADERBOARD_MIN_REQUEST, 0);  // Padding: never smaller than the reply
+    return bytes;
+}
+
+std::vector<std::uint8_t> EncodeLeaderboardAck(const LeaderboardAck& ack) {
+    std::vector<std::uint8_t> bytes = BeginPacket(LEADERBOARD_ACK);
+    PutVarint(bytes, ack.requestId);
+    bytes.push_back(static_cast<std::uint8_t>(ack.status));
+    PutVarint(bytes, PutScore(ack.score));
+    PutVarint(bytes, ack.rank);
+    PutVarint(bytes, ack.playerCount);
+    return bytes;
+}
+
+std::vector<std::uint8_t> EncodeLeaderboardStanding(const LeaderboardStandingReply& standing) {
+    std::vector<std::uint8_t> bytes = BeginPacket(LEADERBOARD_STANDING);
+    PutVarint(bytes, standing.playerId);
+    bytes.push_back(standing.found ? 1 : 0);
+    PutVarint(bytes, standing.rank);
+    PutVarint(bytes, PutScore(standing.bestScore));
+    PutVarint(bytes, standing.playerCount);
+    PutVarint(bytes, PutScore(standing.topScore));
+    return bytes;
+}
+
+bool ParseLeaderboardSubmit(const std::uint8_t* data, std::size_t size, LeaderboardSubmit& submit) {
+    if (!IsPacket(data, size, LEADERBOARD_SUBMIT) || size < LEADERBOARD_MIN_REQUEST) return false;
+    ByteReader reader{data, size, 2};
+    submit.playerId = reader.Varint();
+    submit.requestId = reader.Varint();
+    submit.replay = data + reader.offset;
+    submit.replaySize = size - reader.offset;
+    return reader.ok;
+}
+
+bool ParseLeaderboardQuery(const std::uint8_t* data, std::size_t size, std::uint64_t& playerId) {
+    if (!IsPacket(data, size, LEADERBOARD_QUERY) || size < LEADERBOARD_MIN_REQUEST) return false;
+    ByteReader reader{data, size, 2};
+    playerId = reader.Varint();
+    return reader.ok;
+}
+
+bool ParseLeaderboardAck(const std::uint8_t* data, std::size_t size, LeaderboardAck& ack) {
+    if (!IsPacket(data, size, LEADERBOARD_ACK)) return false;
+    ByteReader reader{data, size, 2};
+    ack.requestId = reader.Varint();
+    std::uint64_t status = reader.Fixed(1);
+    ack.score = static_cast<std::int32_t>(reader.Varint());
+    ack.rank = reader.Varint();
+    ack.playerCount = reader.Varint();
+    if (status > static_cast<std::uint64_t>(LeaderboardStatus::Busy)) return false;
+    ack.status = static_cast<LeaderboardStatus>(status);
+    return reader.ok;
+}
+
+bool ParseLeaderboardStanding(const std::uint8_t* data, std::size_t size,
+                              LeaderboardStandingReply& standing) {
+    if (!IsPacket(data, size, LEADERBOARD_STANDING)) return false;
+    ByteReader reader{data, size, 2};
+    standing.playerId = reader.Varint();
+    standing.found = reader.Fixed(1) != 0;
+    standing.rank = reader.Varint();
+    standing.bestScore = static_cast<std::int32_t>(reader.Varint());
+    standing.playerCount = reader.Varint();
+    standing.topScore = static_cast<std::int32_t>(reader.Varint());
+    return reader.ok;
+}
+
+// ============================================================================
+// LeaderboardClient
+// ============================================================================
+
+bool LeaderboardClient::Connect(const char* host, std::uint16_t port, std::uint64_t playerId) {
+    this->playerId = playerId;
+    return ResolveUdpAddress(host, port, server) && socket.Open(0);
+}
+
+void LeaderboardClient::Submit(const std::vector<std::uint8_t>& replay) {
+    std::vector<std::uint8_t> packet = EncodeLeaderboardSubmit(playerId, nextRequestId, replay);
+    if (packet.size() > LEADERBOARD_MAX_DATAGRAM) return;  // Hours long; can't be sent in one
+    if (packet.size() < LEADERBOARD_MIN_REQUEST) packet.resize(LEADERBOARD_MIN_REQUEST, 0);
+
+    if (queue.size() == MAX_QUEUED) {
+        queue.erase(queue.begin());
+        attempts = 0;
+    }
+    queue.push_back(PendingSubmit{nextRequestId++, std::move(packet)});
+}
+
+void LeaderboardClient::SendFront(double now) {
+    const std::vector<std::uint8_t>& packet = queue.front().packet;
+    socket.SendTo(server, packet.data(), packet.size());
+    lastSend = now;
+    attempts++;
+}
+
+void LeaderboardClient::Poll(double now) {
+    if (!socket.IsOpen()) return;
+
+    std::uint8_t buffer[REPLY_CAPACITY];
+    UdpAddress address;
+    long size;
+    while ((size = socket.ReceiveFrom(address, buffer, sizeof(buffer))) >= 0) {
+        if (!(address == server)) continue;
+
+        LeaderboardAck ack;
+        LeaderboardStandingReply reply;
+        if (ParseLeaderboardAck(buffer, static_cast<std::size_t>(size), ack)) {
+            if (queue.empty() || ack.requestId != queue.front().requestId) continue;  // Stale
+            lastAck = ack;
+            if (ack.status == LeaderboardStatus::Busy) continue;  // Resent on schedule
+
+            queue.erase(queue.begin());
+            attempts = 0;
+            lastQuery = std::min(lastQuery, now - QUERY_INTERVAL + STANDING_AFTER_ACK);
+        } else if (ParseLeaderboardStanding(buffer, static_cast<std::size_t>(size), reply) &&
+                   reply.playerId == playerId) {
+            standing = reply;
+            standingReceived = true;
+        }
+    }
+
+    // QUEUE: one submission in flight, the next goes once it is answered
+    if (!queue.empty() && attempts >= MAX_ATTEMPTS) {
+        queue.erase(queue.begin());  // Server unreachable; give this one up
+        attempts = 0;
+    }
+    if (!queue.empty() && (attempts == 0 || now - lastSend >= RESEND_INTERVAL)) {
+        SendFront(now);
+    }
+
+    if (now - lastQuery >= QUERY_INTERVAL) {
+        std::vector<std::uint8_t> query = EncodeLeaderboardQuery(playerId);
+        socket.SendTo(server, query.data(), query.size());
+        lastQuery = now;
+    }
+}
@@ -0,0 +1,149 @@
+/**
+ * Leaderboard protocol - Replay submissions and rank queries over UDP
+ *
+ * The game submits each finished replay to the leaderboard server, which
+ * re-simulates it (replay.h) before it counts; a client can claim any
+ * score, but only the drops it sends are trusted, and only under the
+ * shipped rules. Rank queries are
+ * answered from the sharded Leaderboard in microseconds.
+ *
+ * Packet layout (varint = LEB128 unsigned):
+ *
+ *     u8      'U' submit, 'Q' standing query (client -> server),
+ *             'A' submit ack, 'K' standing (server -> client)
+ *     u8      LEADERBOARD_PROTOCOL_VERSION
+ *
+ *   submit:   varint player id, varint request id, then the replay bytes
+ *   ack:      varint request id, u8 LeaderboardStatus, varint verified
+ *             score, varint rank that score earns, varint player count
+ *   query:    varint player id, zero padding
+ *   standing: varint player id, u8 found, varint rank, varint best score,
+ *             varint player count, varint top score
+ *
+ * Every client packet is at least LEADERBOARD_MIN_REQUEST bytes, padded
+ * if need be, and every reply is shorter, so the server can't be used to
+ * amplify traffic at a spoofed address.
+ *
+ * UDP may lose either direction. The client resends a submission until it
+ * is acknowledged; submitting the same replay again never changes the
+ * board, because only a strictly better score replaces a player's best.
+ */
+
+#pragma once
+
+#include "udp_socket.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+constexpr std::uint8_t LEADERBOARD_PROTOCOL_VERSION = 1;
+constexpr std::uint8_t LEADERBOARD_SUBMIT = 'U';
+constexpr std::uint8_t LEADERBOARD_ACK = 'A';
+constexpr std::uint8_t LEADERBOARD_QUERY = 'Q';
+constexpr std::uint8_t LEADERBOARD_STANDING = 'K';
+
+constexpr std::size_t LEADERBOARD_MIN_REQUEST = 64;       // Longer than any reply
+constexpr std::size_t LEADERBOARD_MAX_DATAGRAM = 65507;   // Largest IPv4 UDP payload
+
+enum class LeaderboardStatus : std::uint8_t {
+    Accepted = 0,   // Verified and queued for the board
+    Rejected = 1,   // Not a replay, or re-simulation disagrees with its claim
+    Busy = 2,       // Verified, but the server's queue was full; resend later
+};
+
+struct LeaderboardSubmit {
+    std::uint64_t playerId = 0;
+    std::uint64_t requestId = 0;
+    const std::uint8_t* replay = nullptr;  // Points into the parsed packet
+    std::size_t replaySize = 0;
+};
+
+struct LeaderboardAck {
+    std::uint64_t requestId = 0;
+    LeaderboardStatus status = LeaderboardStatus::Rejected;
+    std::int32_t score = 0;          // Verified score (0 if rejected)
+    std::uint64_t rank = 0;          // Place that score earns, 1 = best
+    std::uint64_t playerCount = 0;
+};
+
+struct LeaderboardStandingReply {
+    std::uint64_t playerId = 0;
+    bool found = false;
+    std::uint64_t rank = 0;
+    std::int32_t bestScore = 0;
+    std::uint64_t playerCount = 0;
+    std::int32_t topScore = 0;       // Best score on the board
+};
+
+std::vector<std::uint8_t> EncodeLeaderboardSubmit(std::uint64_t playerId, std::uint64_t requestId,
+                                                  const std::vector<std::uint8_t>& replay);
+std::vector<std::uint8_t> EncodeLeaderboardQuery(std::uint64_t playerId);
+std::vector<std::uint8_t> EncodeLeaderboardAck(const LeaderboardAck& ack);
+std::vector<std::uint8_t> EncodeLeaderboardStanding(const LeaderboardStandingReply& standing);
+
+// Each returns false if `data` is not a well-formed packet of that type
+bool ParseLeaderboardSubmit(const std::uint8_t* data, std::size_t size, LeaderboardSubmit& submit);
+bool ParseLeaderboardQuery(const std::uint8_t* data, std::size_t size, std::uint64_t& playerId);
+bool ParseLeaderboardAck(const std::uint8_t* data, std::size_t size, LeaderboardAck& ack);
+bool ParseLeaderboardStanding(const std::uint8_t* data, std::size_t size,
+                              LeaderboardStandingReply& standing);
+
+/**
+ * LeaderboardClient - Game side: submits replays and keeps the player's
+ * standing fresh
+ *
+ * Polled from the frame loop and never blocks. Replays wait in a small
+ * FIFO and go out one at a time, resent every RESEND_INTERVAL until
+ * acknowledged (or MAX_ATTEMPTS is reached).
+ *
+ * Time Complexity:
+ * - Submit: O(replay bytes) - one copy into the packet
+ * - Poll: O(datagrams received)
+ */
+class LeaderboardClient {
+public:
+    static constexpr std::uint16_t DEFAULT_PORT = 47810;
+    static constexpr double RESEND_INTERVAL = 1.0;   // Seconds between unanswered submits
+    static constexpr int MAX_ATTEMPTS = 10;
+    static constexpr double QUERY_INTERVAL = 5.0;    // Standing refresh period
+    static constexpr std::size_t MAX_QUEUED = 8;     // Replays waiting to be sent
+
+    // Resolve the server and bind a local port; false on failure
+    bool Connect(const char* host, std::uint16_t port, std::uint64_t playerId);
+    bool IsConnected() const { return socket.IsOpen(); }
+
+    // Queue a finished replay; the oldest is dropped if MAX_QUEUED wait
+    void Submit(const std::vector<std::uint8_t>& replay);
+
+    // Send what is due and apply replies. `now` is in seconds.
+    void Poll(double now);
+
+    // The latest standing the server reported; found = false until then
+    const LeaderboardStandingReply& GetStanding() const { return standing; }
+    bool HasStanding() const { return standingReceived; }
+
+    // The last submission's acknowledgement; status Rejected until one arrives
+    const LeaderboardAck& GetLastAck() const { return lastAck; }
+
+private:
+    UdpSocket socket;
+    UdpAddress server;
+    std::uint64_t playerId = 0;
+
+    struct PendingSubmit {
+        std::uint64_t requestId;
+        std::vector<std::uint8_t> packet;
+    };
+    std::vector<PendingSubmit> queue;  // QUEUE: encoded submits, oldest first
+    std::uint64_t nextRequestId = 1;
+    double lastSend = 0.0;             // When queue.front() last went out
+    int attempts = 0;                  // Sends of queue.front() so far
+
+    double lastQuery = -QUERY_INTERVAL;
+    bool standingReceived = false;
+    LeaderboardStandingReply standing;
+    LeaderboardAck lastAck;
+
+    void SendFront(double now);
+};
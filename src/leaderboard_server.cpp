@@ -0,0 +1,251 @@
+/**
+ * Tower Builder - Global leaderboard server
+ *
+ * Receives replays from game clients (leaderboard_net.h), re-simulates
+ * each one headless and ranks the players' best verified scores on a
+ * sharded Leaderboard (leaderboard.h). Only games played under the
+ * shipped rules count: a replay naming any other SimParams or tick rate
+ * (say, a perfect threshold wide enough to never miss) is rejected.
+ *
+ * Every receive thread reads the same UDP socket, verifies what it
+ * receives and submits it through its own lock-free lanes, so it is both
+ * the verifier and one of the board's producers; verification dominates
+ * the cost of a submission, and it runs on all the threads at once.
+ *
+ * Usage:
+ *   TowerBuilderLeaderboard [--port N] [--threads N] [--shards N]
+ *                           [--data DIR] [--max-ticks N] [--seconds N]
+ *
+ * Runs until interrupted (Ctrl+C), or for --seconds, then prints the top
+ * of the board.
+ */
+
+#include "leaderboard.h"
+#include "leaderboard_net.h"
+#include "replay.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct ServerOptions {
+    unsigned port = LeaderboardClient::DEFAULT_PORT;
+    unsigned threads = 0;                                // 0 = all hardware threads
+    int shards = 0;                                      // 0 = one per receive thread
+    const char* data = "leaderboard";                    // Log directory; "" = memory only
+    unsigned long long maxTicks = 240ull * 60 * 60 * 4;  // Four hours at 240 Hz
+    double seconds = 0.0;                                // 0 = until interrupted
+};
+
+// Per receive thread, read by the status line
+struct alignas(64) ReceiveStats {
+    std::atomic<std::uint64_t> accepted{0};
+    std::atomic<std::uint64_t> rejected{0};
+    std::atomic<std::uint64_t> busy{0};
+    std::atomic<std::uint64_t> queries{0};
+};
+
+constexpr int WAIT_TIMEOUT_MS = 50;        // Receive threads re-check the stop flag this often
+constexpr double STATUS_INTERVAL = 5.0;    // Seconds between status lines
+constexpr std::size_t TOP_PRINTED = 10;
+
+std::atomic<bool> stopRequested{false};
+
+void OnInterrupt(int) { stopRequested.store(true); }
+
+void PrintUsage(const char* program) {
+    std::printf("Usage: %s [--port N] [--threads N] [--shards N] [--data DIR]\n"
+                "       %*s [--max-ticks N] [--seconds N]\n",
+                program, static_cast<int>(std::strlen(program)), "");
+}
+
+bool ParseOptions(int argc, char** argv, ServerOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--help") == 0) {
+            return false;
+        } else if (value == nullptr) {
+            std::fprintf(stderr, "Missing value for %s\n", arg);
+            return false;
+        } else if (std::strcmp(arg, "--port") == 0) {
+            options.port = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strcmp(arg, "--shards") == 0) {
+            options.shards = std::atoi(value);
+        } else if (std::strcmp(arg, "--data") == 0) {
+            options.data = value;
+        } else if (std::strcmp(arg, "--max-ticks") == 0) {
+            options.maxTicks = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--seconds") == 0) {
+            options.seconds = std::atof(value);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+        i++;
+    }
+    return options.port > 0 && options.port <= 65535 && options.maxTicks > 0;
+}
+
+/**
+ * One receive thread: verify submissions, answer queries. `producer` is
+ * this thread's lane index into the board.
+ */
+void Receive(int producer, UdpSocket& socket, Leaderboard& board,
+             unsigned long long maxTicks, ReceiveStats& stats) {
+    std::vector<std::uint8_t> buffer(LEADERBOARD_MAX_DATAGRAM);
+    Replay replay;  // Reused, so its drop vector stops reallocating
+    const ReplayRules shippedRules;  // Default SimParams at the game's tick rate
+    UdpAddress address;
+
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        long size = socket.ReceiveFrom(address, buffer.data(), buffer.size());
+        if (size < 0) {
+            socket.WaitReadable(WAIT_TIMEOUT_MS);
+            continue;
+        }
+
+        LeaderboardSubmit submit;
+        std::uint64_t playerId;
+        if (ParseLeaderboardSubmit(buffer.data(), static_cast<std::size_t>(size), submit)) {
+            LeaderboardAck ack;
+            ack.requestId = submit.requestId;
+
+            // The params and tick rate in the file are the client's claim;
+            // VerifyReplay rejects any but the shipped ones before simulating
+            ReplayVerdict verdict;
+            if (ParseReplay(submit.replay, submit.replaySize, replay)) {
+                verdict = VerifyReplay(replay, maxTicks, shippedRules);
+            }
+            if (verdict.valid) {
+                LeaderboardEntry entry;
+                entry.playerId = submit.playerId;
+                entry.score = verdict.score;
+                entry.height = verdict.height;
+                entry.seed = replay.seed;
+                entry.timestamp = static_cast<std::int64_t>(std::time(nullptr));
+
+                bool queued = board.Submit(producer, entry);
+                ack.status = queued ? LeaderboardStatus::Accepted : LeaderboardStatus::Busy;
+                ack.score = verdict.score;
+                ack.rank = board.GetRankForScore(verdict.score);
+                (queued ? stats.accepted : stats.busy).fetch_add(1, std::memory_order_relaxed);
+            } else {
+                stats.rejected.fetch_add(1, std::memory_order_relaxed);
+            }
+            ack.playerCount = board.GetPlayerCount();
+
+            std::vector<std::uint8_t> reply = EncodeLeaderboardAck(ack);
+            socket.SendTo(address, reply.data(), reply.size());
+        } else if (ParseLeaderboardQuery(buffer.data(), static_cast<std::size_t>(size), playerId)) {
+            LeaderboardStanding standing = board.GetStanding(playerId);
+            std::vector<LeaderboardEntry> top = board.GetTop(1);
+
+            LeaderboardStandingReply reply;
+            reply.playerId = playerId;
+            reply.found = standing.found;
+            reply.rank = standing.rank;
+            reply.bestScore = standing.best.score;
+            reply.playerCount = standing.playerCount;
+            reply.topScore = top.empty() ? 0 : top[0].score;
+
+            std::vector<std::uint8_t> bytes = EncodeLeaderboardStanding(reply);
+            socket.SendTo(address, bytes.data(), bytes.size());
+            stats.queries.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ServerOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    unsigned threads = options.threads > 0 ? options.threads : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    int shards = options.shards > 0 ? options.shards : static_cast<int>(threads);
+
+    UdpSocket socket;
+    if (!socket.Open(static_cast<std::uint16_t>(options.port))) {
+        std::fprintf(stderr, "Could not open UDP port %u\n", options.port);
+        return 1;
+    }
+
+    Leaderboard board(shards, static_cast<int>(threads));
+    if (!board.Open(options.data[0] != '\0' ? options.data : nullptr)) {
+        std::fprintf(stderr, "Could not open leaderboard data in %s\n", options.data);
+        return 1;
+    }
+
+    std::printf("Leaderboard on UDP port %u: %u receive threads, %d shards, %llu players loaded\n",
+                options.port, threads, board.GetShardCount(),
+                static_cast<unsigned long long>(board.GetPlayerCount()));
+    std::fflush(stdout);
+
+    std::signal(SIGINT, OnInterrupt);
+    std::signal(SIGTERM, OnInterrupt);
+
+    std::vector<ReceiveStats> stats(threads);
+    std::vector<std::thread> receivers;
+    for (unsigned t = 0; t < threads; t++) {
+        receivers.emplace_back(Receive, static_cast<int>(t), std::ref(socket), std::ref(board),
+                               options.maxTicks, std::ref(stats[t]));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    double nextStatus = STATUS_INTERVAL;
+    std::uint64_t previousAccepted = 0;
+    while (!stopRequested.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (options.seconds > 0.0 && elapsed.count() >= options.seconds) break;
+        if (elapsed.count() < nextStatus) continue;
+
+        std::uint64_t accepted = 0, rejected = 0, busy = 0, queries = 0;
+        for (const ReceiveStats& s : stats) {
+            accepted += s.accepted.load(std::memory_order_relaxed);
+            rejected += s.rejected.load(std::memory_order_relaxed);
+            busy += s.busy.load(std::memory_order_relaxed);
+            queries += s.queries.load(std::memory_order_relaxed);
+        }
+        std::printf("[%6.0f s] players %llu  accepted %llu (%.0f/s)  rejected %llu  busy %llu"
+                    "  queries %llu\n",
+                    elapsed.count(), static_cast<unsigned long long>(board.GetPlayerCount()),
+                    static_cast<unsigned long long>(accepted),
+                    (accepted - previousAccepted) / STATUS_INTERVAL,
+                    static_cast<unsigned long long>(rejected),
+                    static_cast<unsigned long long>(busy),
+                    static_cast<unsigned long long>(queries));
+        std::fflush(stdout);
+        previousAccepted = accepted;
+        nextStatus += STATUS_INTERVAL;
+    }
+
+    stopRequested.store(true);
+    for (std::thread& receiver : receivers) receiver.join();
+    board.Close();  // Applies and logs everything still queued
+
+    std::vector<LeaderboardEntry> top = board.GetTop(TOP_PRINTED);
+    std::printf("Players: %llu  top %zu:\n",
+                static_cast<unsigned long long>(board.GetPlayerCount()), top.size());
+    for (std::size_t i = 0; i < top.size(); i++) {
+        std::printf("  %2zu. player %llu  score %d  height %d\n", i + 1,
+                    static_cast<unsigned long long>(top[i].playerId), top[i].score, top[i].height);
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * MappedFile - Read-only memory map of a whole file
+ * See mapped_file.h for an overview.
+ */
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char* path) {
+    Close();
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The mapping keeps the file open; the file handle is no longer needed
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (fileMapping == nullptr) return false;
+
+    void* view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(fileMapping);
+        return false;
+    }
+
+    data = static_cast<const std::uint8_t*>(view);
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    mapping = fileMapping;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data == nullptr) return;
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(mapping));
+    data = nullptr;
+    size = 0;
+    mapping = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const char* path) {
+    Close();
+
+    int file = open(path, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size <= 0) {
+        close(file);
+        return false;
+    }
+
+    // The mapping keeps the file alive; the descriptor is no longer needed
+    std::size_t fileSize = static_cast<std::size_t>(status.st_size);
+    void* view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (view == MAP_FAILED) return false;
+
+    data = static_cast<const std::uint8_t*>(view);
+    size = fileSize;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data == nullptr) return;
+    munmap(const_cast<std::uint8_t*>(data), size);
+    data = nullptr;
+    size = 0;
+}
+
+#endif
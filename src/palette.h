@@ -0,0 +1,19 @@
+/**
+ * Block palette - maps a Block's colorIndex to a raylib Color
+ *
+ * The simulation only stores palette indices; everything that draws blocks
+ * (the game, the tower renderer) turns them into colours here.
+ */
+
+#pragma once
+
+#include "block.h"
+#include "raylib.h"
+
+inline Color GetBlockColor(int index) {
+    static const Color blockColors[BLOCK_PALETTE_SIZE] = {
+        SKYBLUE, PINK, GOLD, LIME, ORANGE,
+        PURPLE, BEIGE, VIOLET, MAROON, DARKBLUE
+    };
+    return blockColors[index % BLOCK_PALETTE_SIZE];
+}
@@ -0,0 +1,118 @@
+/**
+ * ParticleSystem - Pooled, structure-of-arrays particles
+ * See particle_system.h for an overview.
+ */
+
+#include "particle_system.h"
+#include "simd.h"
+
+#include <algorithm>
+
+namespace {
+
+// Every live lane advances the same way: one pass, WIDTH particles per
+// step. Lanes past `count` are padding and harmless to integrate.
+template <typename S>
+void Integrate(float* x, float* y, float* vx, float* vy, float* life,
+               std::size_t count, float deltaTime) {
+    using F = typename S::F;
+    const F dt = S::Set(deltaTime);
+    const F gravityStep = S::Set(ParticleSystem::GRAVITY * deltaTime);
+
+    for (std::size_t i = 0; i < count; i += S::WIDTH) {
+        F newVy = S::Add(S::Load(vy + i), gravityStep);
+        S::Store(vy + i, newVy);
+        S::Store(x + i, S::Add(S::Load(x + i), S::Mul(S::Load(vx + i), dt)));
+        S::Store(y + i, S::Add(S::Load(y + i), S::Mul(newVy, dt)));
+        S::Store(life + i, S::Sub(S::Load(life + i), dt));
+    }
+}
+
+}  // namespace
+
+ParticleSystem::ParticleSystem(std::size_t capacity) : capacity(capacity) {
+    // Pad so the last SIMD step never reads past the arrays
+    std::size_t padded = (capacity + SimdNative::WIDTH - 1) / SimdNative::WIDTH * SimdNative::WIDTH;
+    x.assign(padded, 0.0f);
+    y.assign(padded, 0.0f);
+    vx.assign(padded, 0.0f);
+    vy.assign(padded, 0.0f);
+    life.assign(padded, 0.0f);
+    inverseLifetime.assign(padded, 0.0f);
+    size.assign(padded, 0.0f);
+    color.assign(padded, 0);
+}
+
+float ParticleSystem::Random(float low, float high) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return low + (high - low) * static_cast<float>(rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::SpawnDebris(float left, float top, float width, float height,
+                                 int side, std::uint32_t rgba) {
+    // Tile the overhang with square chunks, each thrown a little outwards.
+    // A sub-pixel trim would otherwise tile into thousands of invisible
+    // chunks, filling the pool before the perfect-drop sparkles spawn.
+    if (width < DEBRIS_MIN_OVERHANG || height < DEBRIS_MIN_OVERHANG) return;
+    float chunk = std::max(DEBRIS_MIN_CHUNK, std::min(DEBRIS_CHUNK_WIDTH, std::min(width, height)));
+
+    for (float cy = top; cy < top + height; cy += chunk) {
+        for (float cx = left; cx < left + width; cx += chunk) {
+            std::size_t i = Allocate();
+            if (i == capacity) return;
+
+            x[i] = cx;
+            y[i] = cy;
+            vx[i] = side * Random(20.0f, 160.0f);
+            vy[i] = Random(-180.0f, 0.0f);
+            float lifetime = DEBRIS_LIFETIME * Random(0.7f, 1.0f);
+            life[i] = lifetime;
+            inverseLifetime[i] = 1.0f / lifetime;
+            size[i] = chunk * Random(0.6f, 1.0f);
+            color[i] = rgba;
+        }
+    }
+}
+
+void ParticleSystem::SpawnSparkles(float left, float top, float width, std::uint32_t rgba) {
+    for (int n = 0; n < SPARKLES_PER_PERFECT; n++) {
+        std::size_t i = Allocate();
+        if (i == capacity) return;
+
+        x[i] = left + Random(0.0f, width);
+        y[i] = top;
+        vx[i] = Random(-140.0f, 140.0f);
+        vy[i] = Random(-520.0f, -180.0f);
+        float lifetime = SPARKLE_LIFETIME * Random(0.6f, 1.0f);
+        life[i] = lifetime;
+        inverseLifetime[i] = 1.0f / lifetime;
+        size[i] = Random(2.0f, 5.0f);
+        color[i] = rgba;
+    }
+}
+
+void ParticleSystem::Update(float deltaTime) {
+    if (count == 0) return;
+    Integrate<SimdNative>(x.data(), y.data(), vx.data(), vy.data(), life.data(), count, deltaTime);
+
+    // Retire expired particles: swap the last live one into the hole, so
+    // the live range stays packed. Order among particles does not matter.
+    std::size_t i = 0;
+    while (i < count) {
+        if (life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        count--;
+        x[i] = x[count];
+        y[i] = y[count];
+        vx[i] = vx[count];
+        vy[i] = vy[count];
+        life[i] = life[count];
+        inverseLifetime[i] = inverseLifetime[count];
+        size[i] = size[count];
+        color[i] = color[count];
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * ParticleSystem - Pooled, structure-of-arrays particles for trim debris
+ * and perfect-placement sparkles
+ *
+ * WHY STRUCTURE OF ARRAYS?
+ * - Every frame integrates every live particle the same way (gravity,
+ *   velocity, remaining life), which is a straight SIMD loop over x[],
+ *   y[], vx[]..., WIDTH particles per instruction (see simd.h)
+ * - Drawing only reads positions, sizes and colours, so velocities and
+ *   lifetimes never enter the cache while vertices are built
+ *
+ * WHY A FIXED POOL?
+ * - All arrays are allocated once, at construction; spawning writes the
+ *   next free slot and expiry swaps the last live particle into the hole,
+ *   so live particles stay packed at [0, count) and nothing is allocated
+ *   or freed while the game runs
+ * - A full pool drops new spawns rather than growing: effects are
+ *   cosmetic, the frame budget is not
+ *
+ * Raylib-free: the game draws it through TowerRenderer::DrawParticles,
+ * in the same batch as the towers' moving blocks.
+ *
+ * Time Complexity:
+ * - SpawnDebris / SpawnSparkles: O(particles spawned)
+ * - Update: O(live particles), WIDTH at a time
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ParticleSystem {
+public:
+    static constexpr float GRAVITY = 1400.0f;          // px/s^2, downward
+    static constexpr float DEBRIS_CHUNK_WIDTH = 10.0f; // Overhangs break into chunks this wide
+    static constexpr float DEBRIS_MIN_CHUNK = 2.0f;    // ...but never narrower than this
+    static constexpr float DEBRIS_MIN_OVERHANG = 1.0f; // Thinner slivers throw no debris
+    static constexpr float DEBRIS_LIFETIME = 1.4f;     // Seconds
+    static constexpr float SPARKLE_LIFETIME = 0.6f;
+    static constexpr int SPARKLES_PER_PERFECT = 48;
+
+    explicit ParticleSystem(std::size_t capacity = 4096);
+
+    /**
+     * Break the overhang [x, x + width) x [y, y + height) into falling
+     * chunks. `side` is -1 if it hung off the left of the tower, +1 if off
+     * the right; chunks drift that way. `rgba` is 0xRRGGBBAA.
+     */
+    void SpawnDebris(float x, float y, float width, float height, int side, std::uint32_t rgba);
+
+    // Burst of sparkles from the top edge of a perfectly placed block
+    void SpawnSparkles(float x, float y, float width, std::uint32_t rgba);
+
+    // Advance every live particle by `deltaTime` and retire expired ones
+    void Update(float deltaTime);
+
+    void Clear() { count = 0; }
+
+    // Live particles occupy indices [0, GetCount())
+    std::size_t GetCount() const { return count; }
+    std::size_t GetCapacity() const { return capacity; }
+
+    // SoA views for drawing; valid until the next Spawn or Update
+    const float* GetX() const { return x.data(); }
+    const float* GetY() const { return y.data(); }
+    const float* GetSize() const { return size.data(); }
+    const std::uint32_t* GetColor() const { return color.data(); }
+
+    // Remaining life in [0, 1], for fading out
+    float GetLifeFraction(std::size_t index) const { return life[index] * inverseLifetime[index]; }
+
+private:
+    std::size_t capacity;
+    std::size_t count = 0;
+
+    // One array per field, each padded to a whole number of SIMD widths
+    std::vector<float> x, y;        // Top-left corner
+    std::vector<float> vx, vy;
+    std::vector<float> life;        // Seconds left
+    std::vector<float> inverseLifetime;
+    std::vector<float> size;        // Square side, px
+    std::vector<std::uint32_t> color;
+
+    std::uint32_t rngState = 0x9E3779B9u;
+
+    // Uniform in [low, high); xorshift32, cosmetic only
+    float Random(float low, float high);
+
+    // Next free slot, or capacity if the pool is full
+    std::size_t Allocate() { return count < capacity ? count++ : capacity; }
+};
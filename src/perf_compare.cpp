@@ -0,0 +1,367 @@
+/**
+ * Tower Builder - Benchmark regression check (TowerBuilderPerfCompare)
+ *
+ * Reads two Google Benchmark JSON files (TowerBuilderBench
+ * --benchmark_out=FILE --benchmark_out_format=json), pairs their results by
+ * name and fails if any median got more than --threshold percent slower.
+ * The perf-regress build target runs it against the perf-baseline results.
+ *
+ * WHY MEDIANS?
+ * - One slow repetition (a context switch, a frequency dip) moves the mean
+ *   but not the median of --benchmark_repetitions runs; files without
+ *   repetitions fall back to the single run of each benchmark
+ * - Benchmarks that measure wall time (UseRealTime, "/real_time" in the
+ *   name) are compared on real time, every other one on CPU time
+ *
+ * Usage:
+ *   TowerBuilderPerfCompare [--threshold PERCENT] BASELINE.json CURRENT.json
+ *
+ * Exit status is 0 if nothing regressed, 1 on a regression or bad input.
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CompareOptions {
+    double threshold = 10.0;  // Percent
+    const char* baseline = nullptr;
+    const char* current = nullptr;
+};
+
+// ============================================================================
+// JSON (the subset Google Benchmark writes)
+// ============================================================================
+
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;                             // Array
+    std::vector<std::pair<std::string, JsonValue>> members;   // Object, in file order
+
+    const JsonValue* Find(const char* key) const {
+        for (const auto& member : members) {
+            if (member.first == key) return &member.second;
+        }
+        return nullptr;
+    }
+
+    std::string GetString(const char* key) const {
+        const JsonValue* value = Find(key);
+        return value != nullptr && value->type == Type::String ? value->string : std::string();
+    }
+
+    double GetNumber(const char* key) const {
+        const JsonValue* value = Find(key);
+        return value != nullptr && value->type == Type::Number ? value->number : 0.0;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text(text) {}
+
+    bool Parse(JsonValue& value) {
+        return ParseValue(value, 0) && (SkipSpace(), pos == text.size());
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    const std::string& text;
+    std::size_t pos = 0;
+
+    void SkipSpace() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+    }
+
+    bool Consume(char c) {
+        SkipSpace();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool ConsumeWord(const char* word) {
+        std::size_t length = std::strlen(word);
+        if (text.compare(pos, length, word) != 0) return false;
+        pos += length;
+        return true;
+    }
+
+    bool ParseValue(JsonValue& value, int depth) {
+        if (depth > MAX_DEPTH) return false;
+        SkipSpace();
+        if (pos >= text.size()) return false;
+
+        char c = text[pos];
+        if (c == '{') return ParseObject(value, depth);
+        if (c == '[') return ParseArray(value, depth);
+        if (c == '"') {
+            value.type = JsonValue::Type::String;
+            return ParseString(value.string);
+        }
+        if (ConsumeWord("true") || ConsumeWord("false")) {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = c == 't';
+            return true;
+        }
+        if (ConsumeWord("null")) return true;
+
+        const char* start = text.c_str() + pos;
+        char* end = nullptr;
+        value.number = std::strtod(start, &end);
+        if (end == start) return false;
+        value.type = JsonValue::Type::Number;
+        pos += static_cast<std::size_t>(end - start);
+        return true;
+    }
+
+    bool ParseObject(JsonValue& value, int depth) {
+        value.type = JsonValue::Type::Object;
+        pos++;
+        if (Consume('}')) return true;
+        do {
+            std::pair<std::string, JsonValue> member;
+            if (!(SkipSpace(), ParseString(member.first)) || !Consume(':') ||
+                !ParseValue(member.second, depth + 1)) {
+                return false;
+            }
+            value.members.push_back(std::move(member));
+        } while (Consume(','));
+        return Consume('}');
+    }
+
+    bool ParseArray(JsonValue& value, int depth) {
+        value.type = JsonValue::Type::Array;
+        pos++;
+        if (Consume(']')) return true;
+        do {
+            value.items.emplace_back();
+            if (!ParseValue(value.items.back(), depth + 1)) return false;
+        } while (Consume(','));
+        return Consume(']');
+    }
+
+    // Benchmark names are ASCII; \u escapes are kept only if they are too
+    bool ParseString(std::string& out) {
+        if (pos >= text.size() || text[pos] != '"') return false;
+        pos++;
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (pos >= text.size()) return false;
+            char escape = text[pos++];
+            switch (escape) {
+            case 'n': out.push_back('\n'); break;
+            case 't': out.push_back('\t'); break;
+            case 'r': out.push_back('\r'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'u': {
+                if (pos + 4 > text.size()) return false;
+                unsigned long code = std::strtoul(text.substr(pos, 4).c_str(), nullptr, 16);
+                out.push_back(code < 0x80 ? static_cast<char>(code) : '?');
+                pos += 4;
+                break;
+            }
+            default: out.push_back(escape); break;  // \" \\ \/
+            }
+        }
+        if (pos >= text.size()) return false;
+        pos++;
+        return true;
+    }
+};
+
+bool ReadFile(const char* path, std::string& text) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) return false;
+
+    char buffer[65536];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, read);
+    bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    return ok;
+}
+
+// ============================================================================
+// RESULTS
+// ============================================================================
+
+struct BenchResult {
+    double nanoseconds = 0.0;  // Median, or the only run
+    bool median = false;
+    std::size_t order = 0;     // Position in the file, for printing
+};
+
+struct BenchFile {
+    std::map<std::string, BenchResult> results;  // By run name
+    JsonValue context;
+};
+
+double ToNanoseconds(double time, const std::string& unit) {
+    if (unit == "us") return time * 1e3;
+    if (unit == "ms") return time * 1e6;
+    if (unit == "s") return time * 1e9;
+    return time;  // "ns"
+}
+
+bool LoadBenchFile(const char* path, BenchFile& file) {
+    std::string text;
+    JsonValue root;
+    if (!ReadFile(path, text)) {
+        std::fprintf(stderr, "Could not read %s\n", path);
+        return false;
+    }
+    if (!JsonParser(text).Parse(root) || root.type != JsonValue::Type::Object) {
+        std::fprintf(stderr, "%s is not benchmark JSON\n", path);
+        return false;
+    }
+    const JsonValue* benchmarks = root.Find("benchmarks");
+    if (benchmarks == nullptr || benchmarks->type != JsonValue::Type::Array) {
+        std::fprintf(stderr, "%s has no \"benchmarks\" array\n", path);
+        return false;
+    }
+    if (const JsonValue* context = root.Find("context")) file.context = *context;
+
+    for (const JsonValue& bench : benchmarks->items) {
+        if (!bench.GetString("error_message").empty()) continue;
+
+        std::string runType = bench.GetString("run_type");
+        bool median = runType == "aggregate" && bench.GetString("aggregate_name") == "median";
+        if (!median && runType == "aggregate") continue;  // mean, stddev, cv
+
+        std::string name = bench.GetString("run_name");
+        if (name.empty()) name = bench.GetString("name");
+        bool realTime = name.find("/real_time") != std::string::npos;
+        double time = bench.GetNumber(realTime ? "real_time" : "cpu_time");
+
+        // A median replaces the repetitions it summarizes
+        auto found = file.results.find(name);
+        if (found != file.results.end() && (found->second.median || !median)) continue;
+
+        std::size_t order = found != file.results.end() ? found->second.order : file.results.size();
+        BenchResult& result = file.results[name];
+        result.order = order;
+        result.nanoseconds = ToNanoseconds(time, bench.GetString("time_unit"));
+        result.median = median;
+    }
+    return true;
+}
+
+// Numbers from different machines or builds are not comparable; say so
+void WarnOnContextMismatch(const BenchFile& baseline, const BenchFile& current) {
+    for (const char* key : {"host_name", "num_cpus", "mhz_per_cpu", "library_build_type"}) {
+        const JsonValue* a = baseline.context.Find(key);
+        const JsonValue* b = current.context.Find(key);
+        if (a == nullptr || b == nullptr) continue;
+        bool same = a->type == JsonValue::Type::Number ? a->number == b->number
+                                                       : a->string == b->string;
+        if (!same) std::printf("Warning: %s differs from the baseline's\n", key);
+    }
+    if (current.context.GetString("library_build_type") == "debug") {
+        std::printf("Warning: the benchmark library is a debug build\n");
+    }
+}
+
+void FormatTime(double nanoseconds, char* out, std::size_t size) {
+    if (nanoseconds >= 1e9) std::snprintf(out, size, "%.3f s", nanoseconds / 1e9);
+    else if (nanoseconds >= 1e6) std::snprintf(out, size, "%.3f ms", nanoseconds / 1e6);
+    else if (nanoseconds >= 1e3) std::snprintf(out, size, "%.3f us", nanoseconds / 1e3);
+    else std::snprintf(out, size, "%.2f ns", nanoseconds);
+}
+
+void PrintUsage(const char* program) {
+    std::printf("Usage: %s [--threshold PERCENT] BASELINE.json CURRENT.json\n", program);
+}
+
+bool ParseOptions(int argc, char** argv, CompareOptions& options) {
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--help") == 0) {
+            return false;
+        } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            options.threshold = std::atof(argv[++i]);
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return false;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.size() != 2 || options.threshold < 0.0) return false;
+    options.baseline = files[0];
+    options.current = files[1];
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    CompareOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    BenchFile baseline;
+    BenchFile current;
+    if (!LoadBenchFile(options.baseline, baseline)) {
+        std::fprintf(stderr, "Record one with the perf-baseline target\n");
+        return 1;
+    }
+    if (!LoadBenchFile(options.current, current)) return 1;
+    WarnOnContextMismatch(baseline, current);
+
+    // Print in the order the current run measured them
+    std::vector<const std::pair<const std::string, BenchResult>*> byOrder(current.results.size());
+    for (const auto& entry : current.results) byOrder[entry.second.order] = &entry;
+
+    std::printf("%-48s %14s %14s %9s\n", "Benchmark", "Baseline", "Current", "Change");
+    int compared = 0;
+    int regressions = 0;
+    for (const auto* entry : byOrder) {
+        const std::string& name = entry->first;
+        char now[32];
+        FormatTime(entry->second.nanoseconds, now, sizeof(now));
+
+        auto base = baseline.results.find(name);
+        if (base == baseline.results.end() || base->second.nanoseconds <= 0.0) {
+            std::printf("%-48s %14s %14s %9s\n", name.c_str(), "-", now, "new");
+            continue;
+        }
+        char before[32];
+        FormatTime(base->second.nanoseconds, before, sizeof(before));
+        double change = (entry->second.nanoseconds / base->second.nanoseconds - 1.0) * 100.0;
+        bool regressed = change > options.threshold;
+        std::printf("%-48s %14s %14s %+8.1f%%%s\n", name.c_str(), before, now, change,
+                    regressed ? "  REGRESSED" : "");
+        compared++;
+        if (regressed) regressions++;
+    }
+    for (const auto& entry : baseline.results) {
+        if (current.results.count(entry.first) == 0) {
+            std::printf("%-48s %14s %14s %9s\n", entry.first.c_str(), "", "-", "missing");
+        }
+    }
+
+    std::printf("\n%d compared, %d regressed past %.1f%%\n", compared, regressions,
+                options.threshold);
+    return regressions > 0 ? 1 : 0;
+}
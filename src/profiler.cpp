@@ -0,0 +1,182 @@
+/**
+ * FrameProfiler - Scoped-timer instrumentation for the game loop
+ * See profiler.h for an overview.
+ */
+
+#include "profiler.h"
+
+#ifdef TOWERBUILDER_PROFILER
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// ============================================================================
+// ALLOCATION COUNTING
+// Replacing the global operator new lets the overlay show how many heap
+// allocations each frame makes. Array and nothrow forms forward here.
+// ============================================================================
+
+namespace {
+std::atomic<std::uint64_t> allocationCount{0};
+}
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size != 0 ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+std::uint64_t FrameProfiler::GetAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// FRAME SAMPLES
+// ============================================================================
+
+namespace {
+const auto profilerEpoch = std::chrono::steady_clock::now();
+}
+
+FrameProfiler& FrameProfiler::Get() {
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+FrameProfiler::FrameProfiler() : current{}, history{} {}
+
+double FrameProfiler::NowUs() const {
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - profilerEpoch;
+    return elapsed.count();
+}
+
+void FrameProfiler::BeginFrame() {
+    frameStartUs = NowUs();
+    frameAllocationsStart = GetAllocationCount();
+    current.frame = frameIndex++;
+    current.startUs = frameStartUs;
+    current.zoneCount = 0;
+}
+
+void FrameProfiler::AddZone(const char* name, double startUs, double endUs) {
+    if (current.zoneCount == FrameSample::MAX_ZONES) return;
+
+    ProfileZone& zone = current.zones[current.zoneCount++];
+    zone.name = name;
+    zone.startUs = static_cast<float>(startUs - frameStartUs);
+    zone.durationUs = static_cast<float>(endUs - startUs);
+}
+
+void FrameProfiler::EndFrame() {
+    current.durationUs = static_cast<float>(NowUs() - frameStartUs);
+    current.allocations = static_cast<std::uint32_t>(GetAllocationCount() - frameAllocationsStart);
+
+    history[historyNext] = current;
+    historyNext = (historyNext + 1) % HISTORY;
+    historyCount = std::min(historyCount + 1, HISTORY);
+
+    // QUEUE: Hand the frame to the writer thread; never wait for it
+    if (IsCapturing() && !captureRing.TryPush(current)) {
+        droppedFrames++;
+    }
+}
+
+float FrameProfiler::GetFrameTimePercentile(double q) const {
+    if (historyCount == 0) return 0.0f;
+
+    float times[HISTORY];
+    for (int i = 0; i < historyCount; i++) {
+        times[i] = history[i].durationUs;
+    }
+    int rank = static_cast<int>(q * (historyCount - 1));
+    std::nth_element(times, times + rank, times + historyCount);
+    return times[rank] / 1000.0f;
+}
+
+float FrameProfiler::GetZoneAverageMs(const char* name) const {
+    double total = 0.0;
+    for (int i = 0; i < historyCount; i++) {
+        const FrameSample& sample = history[i];
+        for (int z = 0; z < sample.zoneCount; z++) {
+            if (std::strcmp(sample.zones[z].name, name) == 0) {
+                total += sample.zones[z].durationUs;
+            }
+        }
+    }
+    return historyCount > 0 ? static_cast<float>(total / historyCount / 1000.0) : 0.0f;
+}
+
+// ============================================================================
+// CHROME TRACE CAPTURE
+// ============================================================================
+
+bool FrameProfiler::StartCapture(const char* path) {
+    if (IsCapturing()) return true;
+
+    captureFile = std::fopen(path, "w");
+    if (captureFile == nullptr) return false;
+
+    std::fputs("{\"traceEvents\":[\n", captureFile);
+    droppedFrames = 0;
+    writerStop.store(false);
+    writer = std::thread(&FrameProfiler::WriterLoop, this);
+    return true;
+}
+
+void FrameProfiler::StopCapture() {
+    if (!IsCapturing()) return;
+
+    writerStop.store(true);
+    writer.join();
+
+    std::fputs("\n]}\n", captureFile);
+    std::fclose(captureFile);
+    captureFile = nullptr;
+}
+
+void FrameProfiler::WriterLoop() {
+    bool first = true;
+    FrameSample sample;
+    for (;;) {
+        // Check the flag before draining, so frames pushed before Stop are kept
+        bool stopping = writerStop.load();
+        while (captureRing.TryPop(sample)) {
+            WriteFrame(sample, first);
+        }
+        if (stopping) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+void FrameProfiler::WriteFrame(const FrameSample& sample, bool& first) {
+    // Complete ("X") events in microseconds; one per frame and one per zone
+    std::fprintf(captureFile,
+                 "%s{\"name\":\"Frame %llu\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                 "\"pid\":1,\"tid\":1}",
+                 first ? "" : ",\n", static_cast<unsigned long long>(sample.frame),
+                 sample.startUs, sample.durationUs);
+    first = false;
+
+    for (int z = 0; z < sample.zoneCount; z++) {
+        const ProfileZone& zone = sample.zones[z];
+        std::fprintf(captureFile,
+                     ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                     "\"pid\":1,\"tid\":1}",
+                     zone.name, sample.startUs + zone.startUs, zone.durationUs);
+    }
+
+    // Counter track for heap allocations per frame
+    std::fprintf(captureFile,
+                 ",\n{\"name\":\"Allocations\",\"ph\":\"C\",\"ts\":%.3f,"
+                 "\"pid\":1,\"args\":{\"count\":%u}}",
+                 sample.startUs, sample.allocations);
+}
+
+#endif  // TOWERBUILDER_PROFILER
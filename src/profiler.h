@@ -0,0 +1,131 @@
+/**
+ * FrameProfiler - Scoped-timer instrumentation for the game loop
+ *
+ * PROFILE_SCOPE("Name") times the enclosing block. Every frame's zones are
+ * collected into a FrameSample, which feeds:
+ * - a history of recent frame times for the overlay (p50 / p99, per-zone
+ *   averages, heap allocations per frame)
+ * - while a capture is running, a lock-free SpscRing drained by a writer
+ *   thread into a Chrome trace JSON file (load it in chrome://tracing or
+ *   ui.perfetto.dev), so the frame loop never touches the disk
+ *
+ * Only built when TOWERBUILDER_PROFILER is defined (see CMakeLists.txt,
+ * which leaves it out of Release builds). Otherwise PROFILE_SCOPE expands
+ * to nothing and none of this code is compiled in.
+ *
+ * Time Complexity:
+ * - PROFILE_SCOPE: O(1) - two clock reads and an array append
+ * - EndFrame: O(zones) plus O(1) ring push
+ * - GetFrameTimePercentile: O(HISTORY log HISTORY), overlay only
+ */
+
+#pragma once
+
+#ifdef TOWERBUILDER_PROFILER
+
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+struct ProfileZone {
+    const char* name;   // String literal passed to PROFILE_SCOPE
+    float startUs;      // Offset from the frame start
+    float durationUs;
+};
+
+struct FrameSample {
+    static constexpr int MAX_ZONES = 32;
+
+    std::uint64_t frame;
+    double startUs;             // Since the profiler was created
+    float durationUs;
+    std::uint32_t allocations;  // Heap allocations during the frame
+    int zoneCount;
+    ProfileZone zones[MAX_ZONES];
+};
+
+class FrameProfiler {
+public:
+    static constexpr int HISTORY = 256;        // Frames kept for the overlay
+    static constexpr size_t CAPTURE_RING = 1024;
+
+    static FrameProfiler& Get();
+
+    ~FrameProfiler() { StopCapture(); }
+
+    void BeginFrame();
+    void EndFrame();
+
+    // Called by ProfileScope
+    double NowUs() const;
+    void AddZone(const char* name, double startUs, double endUs);
+
+    // Chrome trace capture; frames are written until StopCapture
+    bool StartCapture(const char* path);
+    void StopCapture();
+    bool IsCapturing() const { return captureFile != nullptr; }
+    std::uint64_t GetDroppedFrames() const { return droppedFrames; }
+
+    // Overlay queries over the last HISTORY frames
+    int GetHistoryCount() const { return historyCount; }
+    float GetFrameTimePercentile(double q) const;   // Milliseconds
+    const FrameSample& GetLastFrame() const {
+        return history[(historyNext + HISTORY - 1) % HISTORY];
+    }
+    float GetZoneAverageMs(const char* name) const;
+
+    // Total heap allocations since start (counted by the replaced operator new)
+    static std::uint64_t GetAllocationCount();
+
+private:
+    FrameProfiler();
+
+    FrameSample current;
+    double frameStartUs = 0.0;
+    std::uint64_t frameAllocationsStart = 0;
+    std::uint64_t frameIndex = 0;
+
+    FrameSample history[HISTORY];
+    int historyNext = 0;
+    int historyCount = 0;
+
+    // Capture: frame loop -> ring -> writer thread -> file
+    SpscRing<FrameSample, CAPTURE_RING> captureRing;
+    std::FILE* captureFile = nullptr;
+    std::thread writer;
+    std::atomic<bool> writerStop{false};
+    std::uint64_t droppedFrames = 0;
+
+    void WriterLoop();
+    void WriteFrame(const FrameSample& sample, bool& first);
+};
+
+/**
+ * RAII timer: records a zone from construction to destruction
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : name(name), startUs(FrameProfiler::Get().NowUs()) {}
+    ~ProfileScope() { FrameProfiler::Get().AddZone(name, startUs, FrameProfiler::Get().NowUs()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    double startUs;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+
+#endif  // TOWERBUILDER_PROFILER
@@ -0,0 +1,221 @@
+/**
+ * RankSkipList - Sorted set with O(log n) rank and k-th element queries
+ *
+ * An indexable skip list: every forward link also stores its width, the
+ * number of positions it skips. Summing widths along a search gives the
+ * rank of where it ends, and walking widths down from the top finds the
+ * k-th element, so "what place is score S" and "who is 10th" cost the same
+ * O(log n) as an insert.
+ *
+ * WHY A SKIP LIST (and not an order-statistic tree)?
+ * - Inserts and erases only rewrite the links of the nodes either side of
+ *   the change; there are no rotations to keep subtree counts right
+ * - The top-K walk is a plain linked-list traversal along level 0
+ * - Levels are drawn at random with p = 1/4, so no rebalancing ever runs
+ *   and the expected cost is still O(log n)
+ *
+ * Nodes live in one vector and are linked by index; erased nodes go on a
+ * free list and are reused, so a leaderboard of players improving their
+ * best does not allocate once it has seen each of them.
+ *
+ * Time Complexity (expected):
+ * - Insert / Erase / CountBefore / At: O(log n)
+ * - VisitFirst(k): O(log n + k)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+template <typename T, typename Compare = std::less<T>>
+class RankSkipList {
+public:
+    // 4^MAX_LEVEL elements before the expected search cost starts to grow
+    static constexpr int MAX_LEVEL = 12;
+
+    RankSkipList() { Clear(); }
+
+    void Clear() {
+        nodes.assign(1, Node());  // Node 0 is the head, before every element
+        nodes[HEAD].level = MAX_LEVEL;
+        for (Link& link : nodes[HEAD].links) link = Link{NIL, 1};
+        freeNodes.clear();
+        levels = 1;
+        count = 0;
+    }
+
+    std::size_t GetSize() const { return count; }
+    bool IsEmpty() const { return count == 0; }
+
+    // Add `value`. Equal values are kept side by side; callers that want a
+    // set erase the old value first.
+    void Insert(const T& value) {
+        std::uint32_t update[MAX_LEVEL];
+        std::size_t updatePosition[MAX_LEVEL];
+        std::size_t position = Search(value, update, updatePosition);
+
+        int level = RandomLevel();
+        if (level > levels) {
+            for (int l = levels; l < level; l++) {
+                update[l] = HEAD;
+                updatePosition[l] = 0;
+                nodes[HEAD].links[l] = Link{NIL, count + 1};  // Head to the end
+            }
+            levels = level;
+        }
+
+        std::uint32_t index = AllocateNode(value, level);
+        std::size_t newPosition = position + 1;
+        for (int l = 0; l < level; l++) {
+            Link& before = nodes[update[l]].links[l];
+            // `before` spanned to its old next; the new node splits the span
+            // and pushes everything after it back one position
+            nodes[index].links[l] = Link{before.next,
+                                         updatePosition[l] + before.width + 1 - newPosition};
+            before = Link{index, newPosition - updatePosition[l]};
+        }
+        for (int l = level; l < levels; l++) {
+            nodes[update[l]].links[l].width++;  // Spans over the new node
+        }
+        count++;
+    }
+
+    // Remove one element equal to `value`; false if there is none
+    bool Erase(const T& value) {
+        std::uint32_t update[MAX_LEVEL];
+        std::size_t updatePosition[MAX_LEVEL];
+        Search(value, update, updatePosition);
+
+        std::uint32_t index = nodes[update[0]].links[0].next;
+        if (index == NIL || compare(value, nodes[index].value)) return false;
+
+        for (int l = 0; l < levels; l++) {
+            Link& before = nodes[update[l]].links[l];
+            if (before.next == index) {
+                const Link& removed = nodes[index].links[l];
+                before = Link{removed.next, before.width + removed.width - 1};
+            } else {
+                before.width--;
+            }
+        }
+        freeNodes.push_back(index);
+        count--;
+
+        while (levels > 1 && nodes[HEAD].links[levels - 1].next == NIL) {
+            levels--;
+        }
+        return true;
+    }
+
+    // Number of elements ordered before `value` (which need not be present)
+    std::size_t CountBefore(const T& value) const {
+        std::uint32_t node = HEAD;
+        std::size_t position = 0;
+        for (int l = levels - 1; l >= 0; l--) {
+            for (;;) {
+                const Link& link = nodes[node].links[l];
+                if (link.next == NIL || !compare(nodes[link.next].value, value)) break;
+                position += link.width;
+                node = link.next;
+            }
+        }
+        return position;
+    }
+
+    // The element with `rank` elements before it; rank < GetSize()
+    const T& At(std::size_t rank) const {
+        std::size_t target = rank + 1;
+        std::uint32_t node = HEAD;
+        std::size_t position = 0;
+        for (int l = levels - 1; l >= 0; l--) {
+            for (;;) {
+                const Link& link = nodes[node].links[l];
+                if (link.next == NIL || position + link.width > target) break;
+                position += link.width;
+                node = link.next;
+            }
+        }
+        return nodes[node].value;
+    }
+
+    // visit(value) for the first `limit` elements, in order
+    template <typename Visit>
+    void VisitFirst(std::size_t limit, Visit visit) const {
+        std::uint32_t node = nodes[HEAD].links[0].next;
+        for (std::size_t i = 0; i < limit && node != NIL; i++) {
+            visit(nodes[node].value);
+            node = nodes[node].links[0].next;
+        }
+    }
+
+private:
+    static constexpr std::uint32_t HEAD = 0;
+    static constexpr std::uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Link {
+        std::uint32_t next;     // Node index, or NIL past the last element
+        std::size_t width;      // Positions from this node to `next`
+    };
+
+    struct Node {
+        T value{};
+        int level = 0;
+        Link links[MAX_LEVEL];
+    };
+
+    std::vector<Node> nodes;                 // Index 0 is the head
+    std::vector<std::uint32_t> freeNodes;    // Erased nodes, reused first
+    int levels = 1;                          // Levels in use by any node
+    std::size_t count = 0;
+    std::uint32_t rngState = 0x2545F491u;
+    Compare compare;
+
+    // Last node before `value` on every level, and its position (head = 0).
+    // Returns the level-0 position, i.e. CountBefore(value).
+    std::size_t Search(const T& value, std::uint32_t* update, std::size_t* updatePosition) const {
+        std::uint32_t node = HEAD;
+        std::size_t position = 0;
+        for (int l = levels - 1; l >= 0; l--) {
+            for (;;) {
+                const Link& link = nodes[node].links[l];
+                if (link.next == NIL || !compare(nodes[link.next].value, value)) break;
+                position += link.width;
+                node = link.next;
+            }
+            update[l] = node;
+            updatePosition[l] = position;
+        }
+        return position;
+    }
+
+    std::uint32_t AllocateNode(const T& value, int level) {
+        std::uint32_t index;
+        if (!freeNodes.empty()) {
+            index = freeNodes.back();
+            freeNodes.pop_back();
+        } else {
+            index = static_cast<std::uint32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        nodes[index].value = value;
+        nodes[index].level = level;
+        return index;
+    }
+
+    // 1 + number of heads before the first tail, with p(head) = 1/4
+    int RandomLevel() {
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        std::uint32_t bits = rngState;
+        int level = 1;
+        while (level < MAX_LEVEL && (bits & 3) == 0) {
+            level++;
+            bits >>= 2;
+        }
+        return level;
+    }
+};
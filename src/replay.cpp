@@ -0,0 +1,185 @@
+/**
+ * Replay - Compact binary record of one game and a headless verifier
+ * See replay.h for the byte layout.
+ */
+
+#include "replay.h"
+#include "byte_io.h"
+
+#include <cstdio>
+
+namespace {
+
+constexpr std::uint32_t REPLAY_MAGIC = 0x50524254;  // "TBRP"
+constexpr std::uint8_t REPLAY_FORMAT_VERSION = 1;
+
+// Exact float comparison: the rules either are the shipped ones or not
+bool SameParams(const SimParams& a, const SimParams& b) {
+    return a.initialSpeed == b.initialSpeed && a.speedIncrement == b.speedIncrement &&
+           a.perfectThreshold == b.perfectThreshold && a.minOverlapRatio == b.minOverlapRatio;
+}
+
+}  // namespace
+
+void ReplayRecorder::Begin(const SimParams& params, float tickRate, std::uint64_t seed) {
+    bytes.clear();
+    nextTick = 0;
+    finished = false;
+
+    PutFixed(bytes, REPLAY_MAGIC, 4);
+    bytes.push_back(REPLAY_FORMAT_VERSION);
+    PutVarint(bytes, Simulation::RULES_VERSION);
+    PutFixed(bytes, seed, 8);
+    PutFloat(bytes, tickRate);
+    PutFloat(bytes, params.initialSpeed);
+    PutFloat(bytes, params.speedIncrement);
+    PutFloat(bytes, params.perfectThreshold);
+    PutFloat(bytes, params.minOverlapRatio);
+}
+
+void ReplayRecorder::RecordDrop(const ReplayDrop& drop) {
+    if (finished || drop.tick < nextTick) return;  // At most one drop per tick
+
+    std::uint64_t tickDelta = drop.tick - nextTick + 1;  // >= 1; 0 ends the list
+    PutVarint(bytes, (tickDelta << 1) | (drop.hasSubTick ? 1 : 0));
+    if (drop.hasSubTick) {
+        bytes.push_back(drop.subTick);
+    }
+    nextTick = drop.tick + 1;
+}
+
+void ReplayRecorder::Finish(int score, int height, std::uint64_t totalTicks) {
+    if (finished) return;
+    PutVarint(bytes, 0);
+    PutVarint(bytes, static_cast<std::uint64_t>(score < 0 ? 0 : score));
+    PutVarint(bytes, static_cast<std::uint64_t>(height < 0 ? 0 : height));
+    PutVarint(bytes, totalTicks);
+    finished = true;
+}
+
+bool ReplayRecorder::Save(const char* path) const {
+    if (!finished) return false;
+
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) return false;
+    bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && written;
+}
+
+bool ParseReplay(const std::uint8_t* data, std::size_t size, Replay& replay) {
+    ByteReader reader{data, size};
+
+    if (reader.Fixed(4) != REPLAY_MAGIC || reader.Fixed(1) != REPLAY_FORMAT_VERSION) {
+        return false;
+    }
+    replay.rulesVersion = static_cast<std::uint32_t>(reader.Varint());
+    replay.seed = reader.Fixed(8);
+    replay.tickRate = reader.Float();
+    replay.params.initialSpeed = reader.Float();
+    replay.params.speedIncrement = reader.Float();
+    replay.params.perfectThreshold = reader.Float();
+    replay.params.minOverlapRatio = reader.Float();
+
+    replay.drops.clear();
+    std::uint64_t nextTick = 0;
+    while (reader.ok) {
+        std::uint64_t code = reader.Varint();
+        if (code == 0) break;  // End of drops
+
+        ReplayDrop drop;
+        drop.tick = nextTick + (code >> 1) - 1;
+        drop.hasSubTick = (code & 1) != 0;
+        drop.subTick = drop.hasSubTick ? static_cast<std::uint8_t>(reader.Fixed(1)) : 0;
+        if (drop.tick < nextTick) return false;  // Tick counter wrapped: corrupt
+
+        replay.drops.push_back(drop);
+        nextTick = drop.tick + 1;
+    }
+
+    std::uint64_t score = reader.Varint();
+    std::uint64_t height = reader.Varint();
+    replay.totalTicks = reader.Varint();
+    if (!reader.ok || score > INT32_MAX || height > INT32_MAX) return false;
+
+    replay.claimedScore = static_cast<std::int32_t>(score);
+    replay.claimedHeight = static_cast<std::int32_t>(height);
+    return true;
+}
+
+bool LoadReplay(const char* path, Replay& replay) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) return false;
+
+    std::vector<std::uint8_t> bytes;
+    std::uint8_t buffer[4096];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + read);
+    }
+    std::fclose(file);
+
+    return ParseReplay(bytes.data(), bytes.size(), replay);
+}
+
+ReplayVerdict VerifyReplay(const Replay& replay, std::uint64_t maxTicks, const ReplayRules& rules) {
+    ReplayVerdict verdict;
+
+    if (replay.rulesVersion != Simulation::RULES_VERSION) {
+        verdict.reason = "recorded under different rules";
+        return verdict;
+    }
+    if (!(replay.tickRate > 0.0f)) {
+        verdict.reason = "invalid tick rate";
+        return verdict;
+    }
+    if (!rules.anyRules &&
+        (replay.tickRate != rules.tickRate || !SameParams(replay.params, rules.params))) {
+        verdict.reason = "not played under the expected rules";
+        return verdict;
+    }
+    if (replay.totalTicks == 0 || replay.totalTicks > maxTicks) {
+        verdict.reason = "tick count out of range";
+        return verdict;
+    }
+    if (replay.drops.empty() || replay.drops.back().tick >= replay.totalTicks) {
+        verdict.reason = "drops do not fit the tick count";
+        return verdict;
+    }
+
+    Simulation simulation(replay.params, replay.seed);
+    float tickSeconds = 1.0f / replay.tickRate;  // Same expression as the game and tools
+
+    SimInput input;
+    input.deltaTime = tickSeconds;
+
+    std::size_t nextDrop = 0;
+    std::uint64_t tick = 0;
+    for (; tick < replay.totalTicks && !simulation.IsGameOver(); tick++) {
+        input.drop = false;
+        input.dropTime = -1.0f;
+
+        const ReplayDrop* drop = &replay.drops[nextDrop];
+        if (drop->tick == tick) {
+            input.drop = true;
+            if (drop->hasSubTick) {
+                input.dropTime = DecodeSubTick(drop->subTick, tickSeconds);
+            }
+            if (nextDrop + 1 < replay.drops.size()) nextDrop++;
+        }
+
+        simulation.Step(input);
+    }
+
+    verdict.score = simulation.GetScore();
+    verdict.height = simulation.GetTowerHeight();
+    verdict.ticks = tick;
+
+    if (!simulation.IsGameOver() || tick != replay.totalTicks) {
+        verdict.reason = "game does not end at the claimed tick";
+    } else if (verdict.score != replay.claimedScore || verdict.height != replay.claimedHeight) {
+        verdict.reason = "claimed result does not match";
+    } else {
+        verdict.valid = true;
+    }
+    return verdict;
+}
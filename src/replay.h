@@ -0,0 +1,122 @@
+/**
+ * Replay - Compact binary record of one game and a headless verifier
+ *
+ * The game is deterministic given its rules, its tick rate and the ticks
+ * at which drop was pressed, so that is all a replay stores. Re-running
+ * the drops through Simulation reproduces the game bit for bit, which lets
+ * a server check a claimed score without trusting the client. The rules
+ * and tick rate the file names are the client's claim too, so by default
+ * the verifier only accepts the ones the game ships with (ReplayRules).
+ *
+ * Byte layout (little-endian, varint = LEB128 unsigned):
+ *
+ *     u32    magic "TBRP"
+ *     u8     format version
+ *     varint Simulation::RULES_VERSION the game was played under
+ *     u64    seed of the block sequence
+ *     f32    tick rate, then SimParams (initial speed, speed increment,
+ *            perfect threshold, min overlap ratio)
+ *     drops  varint (tickDelta << 1 | hasSubTick) [+ u8 subTick] each,
+ *            tickDelta = tick - previous drop tick (first: tick + 1) >= 1
+ *     varint 0 - end of drops
+ *     varint claimed score, claimed height, total ticks
+ *
+ * A typical drop costs 2-3 bytes, so a 100-block game is a few hundred
+ * bytes.
+ */
+
+#pragma once
+
+#include "fixed_timestep.h"
+#include "simulation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ReplayDrop {
+    std::uint64_t tick;     // Tick index (0-based) whose step pressed drop
+    bool hasSubTick;        // false = drop at the end of the step
+    std::uint8_t subTick;   // Press time within the tick, in 1/256 ticks
+};
+
+struct Replay {
+    std::uint32_t rulesVersion = Simulation::RULES_VERSION;
+    std::uint64_t seed = 0;
+    float tickRate = 240.0f;
+    SimParams params;
+    std::vector<ReplayDrop> drops;
+
+    // What the player claims the game ended with
+    std::int32_t claimedScore = 0;
+    std::int32_t claimedHeight = 0;
+    std::uint64_t totalTicks = 0;
+};
+
+// Sub-tick press times are stored in 1/256 of a tick. The game quantizes
+// with these too, so what it simulates is exactly what the replay holds.
+inline std::uint8_t EncodeSubTick(float dropTime, float tickSeconds) {
+    int q = static_cast<int>(dropTime / tickSeconds * 256.0f);
+    return static_cast<std::uint8_t>(q < 0 ? 0 : (q > 255 ? 255 : q));
+}
+
+inline float DecodeSubTick(std::uint8_t subTick, float tickSeconds) {
+    return tickSeconds * (static_cast<float>(subTick) / 256.0f);
+}
+
+/**
+ * ReplayRecorder - Streams a replay while the game is played
+ *
+ * Time Complexity:
+ * - RecordDrop: O(1) amortized - a few bytes appended
+ */
+class ReplayRecorder {
+public:
+    void Begin(const SimParams& params, float tickRate, std::uint64_t seed);
+    void RecordDrop(const ReplayDrop& drop);
+    void Finish(int score, int height, std::uint64_t totalTicks);
+
+    const std::vector<std::uint8_t>& GetBytes() const { return bytes; }
+    bool IsFinished() const { return finished; }
+
+    // Write the finished replay to `path`. Returns false on I/O error.
+    bool Save(const char* path) const;
+
+private:
+    std::vector<std::uint8_t> bytes;
+    std::uint64_t nextTick = 0;  // Tick after the previous drop
+    bool finished = false;
+};
+
+// Decode a replay; false if the bytes are truncated or not a replay
+bool ParseReplay(const std::uint8_t* data, std::size_t size, Replay& replay);
+bool LoadReplay(const char* path, Replay& replay);
+
+// The rules a replay must have been played under to be verified. Default-
+// constructed, these are the game as shipped: default SimParams at the
+// default tick rate. A file with any other params (a tuning experiment,
+// or a tampered replay with a huge perfect threshold) is rejected unless
+// anyRules is set.
+struct ReplayRules {
+    SimParams params;
+    float tickRate = FixedTimestep::DEFAULT_TICK_RATE;
+    bool anyRules = false;  // Trust the replay's own params and tick rate
+};
+
+struct ReplayVerdict {
+    bool valid = false;
+    const char* reason = "";     // Why the replay was rejected
+    int score = 0;               // Result of re-simulating the drops
+    int height = 0;
+    std::uint64_t ticks = 0;
+};
+
+/**
+ * Re-simulate a replay headless and compare with its claimed result.
+ * Replays longer than maxTicks, or not played under `rules`, are rejected
+ * without being simulated.
+ *
+ * Time Complexity: O(totalTicks) - one Simulation::Step per tick
+ */
+ReplayVerdict VerifyReplay(const Replay& replay, std::uint64_t maxTicks,
+                           const ReplayRules& rules = ReplayRules());
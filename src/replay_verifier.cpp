@@ -0,0 +1,137 @@
+/**
+ * Tower Builder - Replay verifier
+ *
+ * Re-simulates recorded games headless and checks that each one really
+ * ends with the score and height it claims. Files are verified in
+ * parallel, one replay per job.
+ *
+ * Usage:
+ *   TowerBuilderReplay [--threads N] [--max-ticks N] [--any-rules] [--quiet] FILE...
+ *
+ * Only replays played under the shipped rules (default SimParams at the
+ * default tick rate) are valid; --any-rules also accepts games recorded
+ * with custom params or tick rates, such as --tick-rate experiments.
+ *
+ * Exit status is 0 if every replay is valid, 1 otherwise.
+ */
+
+#include "replay.h"
+#include "work_stealing_pool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct VerifierOptions {
+    unsigned threads = 0;                              // 0 = all hardware threads
+    unsigned long long maxTicks = 240ull * 60 * 60 * 4; // Four hours at 240 Hz
+    bool quiet = false;                                // Only print failures
+    ReplayRules rules;                                 // --any-rules sets rules.anyRules
+    std::vector<const char*> files;
+};
+
+struct VerifyJob {
+    const char* path = nullptr;
+    bool loaded = false;
+    Replay replay;
+    ReplayVerdict verdict;
+};
+
+void PrintUsage(const char* program) {
+    std::printf("Usage: %s [--threads N] [--max-ticks N] [--any-rules] [--quiet] FILE...\n",
+                program);
+}
+
+bool ParseOptions(int argc, char** argv, VerifierOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--help") == 0) {
+            return false;
+        } else if (std::strcmp(arg, "--quiet") == 0) {
+            options.quiet = true;
+            continue;
+        } else if (std::strcmp(arg, "--any-rules") == 0) {
+            options.rules.anyRules = true;
+            continue;
+        } else if (std::strncmp(arg, "--", 2) != 0) {
+            options.files.push_back(arg);
+            continue;
+        } else if (value == nullptr) {
+            std::fprintf(stderr, "Missing value for %s\n", arg);
+            return false;
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strcmp(arg, "--max-ticks") == 0) {
+            options.maxTicks = std::strtoull(value, nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+        i++;
+    }
+    return !options.files.empty() && options.maxTicks > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    VerifierOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<VerifyJob> jobs(options.files.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        jobs[i].path = options.files[i];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    WorkStealingPool pool(options.threads);
+    pool.ParallelFor(static_cast<std::int64_t>(jobs.size()), [&](std::int64_t index, unsigned) {
+        VerifyJob& job = jobs[static_cast<size_t>(index)];
+        job.loaded = LoadReplay(job.path, job.replay);
+        if (job.loaded) {
+            job.verdict = VerifyReplay(job.replay, options.maxTicks, options.rules);
+        }
+    });
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count();
+
+    long long valid = 0;
+    unsigned long long ticks = 0;
+    for (const VerifyJob& job : jobs) {
+        ticks += job.verdict.ticks;
+        if (!job.loaded) {
+            std::printf("FAIL  %s: not a readable replay\n", job.path);
+        } else if (!job.verdict.valid) {
+            std::printf("FAIL  %s: %s (claimed score %d height %d, replayed %d / %d)\n",
+                        job.path, job.verdict.reason,
+                        job.replay.claimedScore, job.replay.claimedHeight,
+                        job.verdict.score, job.verdict.height);
+        } else {
+            valid++;
+            if (!options.quiet) {
+                std::printf("OK    %s: score %d height %d ticks %llu\n", job.path,
+                            job.verdict.score, job.verdict.height,
+                            static_cast<unsigned long long>(job.verdict.ticks));
+            }
+        }
+    }
+
+    std::printf("Replays: %zu  valid %lld  invalid %lld\n",
+                jobs.size(), valid, static_cast<long long>(jobs.size()) - valid);
+    std::printf("Elapsed: %.3f s  (%.0f replays/s, %.0f ticks/s, %u threads)\n", seconds,
+                seconds > 0 ? jobs.size() / seconds : 0.0,
+                seconds > 0 ? ticks / seconds : 0.0, pool.GetThreadCount());
+
+    return valid == static_cast<long long>(jobs.size()) ? 0 : 1;
+}
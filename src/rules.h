@@ -0,0 +1,82 @@
+/**
+ * Rules - Compile-time scoring and difficulty policy
+ *
+ * The shape of the rules (how many points a landing is worth, how often
+ * the blocks speed up) used to be literals scattered through
+ * TrimAndStackBlock and repeated in the SIMD kernel. They now live in one
+ * policy struct that both engines read:
+ *
+ *     GameRules::PerfectPoints(streak)     ->  Simulation, BatchSimulation
+ *     GameRules::AccuracyPoints(accuracy)
+ *     GameRules::SpeedsUpAt(height)
+ *     GameRules::SpeedUpsThrough(height)   ->  Simulation's block preview
+ *
+ * WHY A POLICY INSTEAD OF RUNTIME PARAMETERS?
+ * - Everything here is constexpr, so the compiler folds the constants into
+ *   the hot path and the interactive and batch engines cannot drift apart
+ * - Designers try a different curve by writing another policy struct with
+ *   the same members and pointing GameRules at it; nothing branches on the
+ *   choice at runtime
+ * - The magnitudes that sweeps tune (speeds, perfect threshold, minimum
+ *   overlap) stay in SimParams, since replays record them per game
+ *
+ * A policy must keep PerfectPoints and AccuracyPoints affine (base plus a
+ * per-step amount) and SpeedsUpAt periodic in SPEEDUP_INTERVAL, because the
+ * batch kernel evaluates them on whole SIMD lanes from the same constants.
+ *
+ * Changing GameRules changes game outcomes: bump Simulation::RULES_VERSION.
+ *
+ * Time Complexity: O(1) for every rule, resolved at compile time where the
+ * arguments are constant
+ */
+
+#pragma once
+
+/**
+ * The rules the game ships with
+ */
+struct StandardRules {
+    // Difficulty: blockSpeed += SimParams::speedIncrement whenever the tower
+    // (base block included) reaches a multiple of this height
+    static constexpr int SPEEDUP_INTERVAL = 5;
+
+    // Scoring
+    static constexpr int FIRST_BLOCK_POINTS = 10;     // Landing on an empty tower
+    static constexpr int PERFECT_BASE_POINTS = 50;
+    static constexpr int PERFECT_STREAK_POINTS = 10;  // Per perfect in the streak
+    static constexpr int ACCURACY_BASE_POINTS = 10;
+    static constexpr float ACCURACY_POINTS = 10.0f;   // Extra points at 100% overlap
+
+    // `streak` counts this landing, so the first perfect is worth 60
+    static constexpr int PerfectPoints(int streak) {
+        return PERFECT_BASE_POINTS + streak * PERFECT_STREAK_POINTS;
+    }
+
+    // `accuracy` is overlap / block width, in [minOverlapRatio, 1]
+    static constexpr int AccuracyPoints(float accuracy) {
+        return ACCURACY_BASE_POINTS + static_cast<int>(accuracy * ACCURACY_POINTS);
+    }
+
+    // `height` is the tower height right after the push
+    static constexpr bool SpeedsUpAt(int height) {
+        return height % SPEEDUP_INTERVAL == 0;
+    }
+
+    // How many of the heights 1..height speed up, so a future block's
+    // speed is known without stepping there
+    static constexpr int SpeedUpsThrough(int height) {
+        return height / SPEEDUP_INTERVAL;
+    }
+};
+
+using GameRules = StandardRules;
+
+// The shipped numbers; if one of these fails, outcomes changed and
+// RULES_VERSION needs a bump
+static_assert(StandardRules::PerfectPoints(1) == 60, "first perfect is worth 60");
+static_assert(StandardRules::AccuracyPoints(0.5f) == 15, "half overlap is worth 15");
+static_assert(StandardRules::AccuracyPoints(1.0f) == 20, "full overlap is worth 20");
+static_assert(StandardRules::SpeedsUpAt(5) && !StandardRules::SpeedsUpAt(6),
+              "speed-up every 5 blocks");
+static_assert(StandardRules::SpeedUpsThrough(9) == 1 && StandardRules::SpeedUpsThrough(10) == 2,
+              "SpeedUpsThrough counts SpeedsUpAt");
@@ -0,0 +1,287 @@
+/**
+ * ScoreHistory - LINKED LIST of finished games
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Score Node - Building block of Linked List
+ *
+ * WHY LINKED LIST?
+ * - Dynamic size - don't need to pre-allocate array
+ * - Easy insertion at head - O(1)
+ * - Memory efficient for keeping game history
+ */
+struct ScoreNode {
+    int score;              // Points earned in this game
+    int height;             // Tower height achieved
+    ScoreNode* next;        // Pointer to next node (LINKED LIST concept)
+
+    ScoreNode() : score(0), height(0), next(nullptr) {}
+    ScoreNode(int s, int h) : score(s), height(h), next(nullptr) {}
+};
+
+/**
+ * ScoreNodePool - Chunked arena that hands out ScoreNodes
+ *
+ * WHY A POOL?
+ * - A plain `new ScoreNode` per game means one tiny heap allocation per
+ *   game and nodes scattered across memory
+ * - The pool carves nodes out of CHUNK_SIZE-node arrays, so list nodes sit
+ *   next to each other and traversal stays in cache
+ * - Nodes are never freed one by one (the history only grows or clears),
+ *   so a bump index is all the bookkeeping needed
+ *
+ * Time Complexity:
+ * - Allocate: O(1) amortized - one chunk allocation per CHUNK_SIZE nodes
+ * - At: O(1) - the index-th node handed out since the last Reset
+ * - Reset: O(1) - chunks are kept and reused
+ */
+class ScoreNodePool {
+public:
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+    ScoreNode* Allocate() {
+        if (used == chunks.size() * CHUNK_SIZE) {
+            chunks.emplace_back(new ScoreNode[CHUNK_SIZE]);
+        }
+        ScoreNode* node = &At(used);
+        used++;
+        return node;
+    }
+
+    ScoreNode& At(size_t index) { return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+
+    // Every node becomes reusable; memory stays reserved for the next game
+    void Reset() { used = 0; }
+
+    size_t GetUsed() const { return used; }
+
+private:
+    std::vector<std::unique_ptr<ScoreNode[]>> chunks;
+    size_t used = 0;
+};
+
+/**
+ * ScoreSketch - Fixed-size log histogram for approximate percentiles
+ *
+ * Values below 16 get their own bucket; above that every power of two is
+ * split into 8 buckets, so any reported percentile is within 12.5% of the
+ * true value. The bucket count is fixed, so memory and query cost do not
+ * grow with the number of games.
+ *
+ * Time Complexity:
+ * - Add: O(1)
+ * - Percentile: O(BUCKETS) - constant, independent of games played
+ */
+class ScoreSketch {
+public:
+    static constexpr int LINEAR_LIMIT = 16;   // Exact buckets for 0..15
+    static constexpr int SUB_BUCKETS = 8;     // Buckets per power of two
+    static constexpr int BUCKETS = LINEAR_LIMIT + (31 - 4) * SUB_BUCKETS;
+
+    ScoreSketch() { Clear(); }
+
+    void Add(int value) {
+        buckets[BucketIndex(value)]++;
+        total++;
+    }
+
+    // Smallest bucket lower bound covering fraction q of the values, q in [0, 1]
+    int Percentile(double q) const {
+        if (total == 0) return 0;
+
+        std::int64_t rank = static_cast<std::int64_t>(q * (total - 1));
+        std::int64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += buckets[i];
+            if (seen > rank) return BucketLowerBound(i);
+        }
+        return BucketLowerBound(BUCKETS - 1);
+    }
+
+    void Clear() {
+        for (std::int64_t& bucket : buckets) bucket = 0;
+        total = 0;
+    }
+
+private:
+    std::int64_t buckets[BUCKETS];
+    std::int64_t total;
+
+    static int HighestBit(std::uint32_t value) {
+        int bit = 0;
+        while (value >>= 1) bit++;
+        return bit;
+    }
+
+    static int BucketIndex(int value) {
+        if (value < LINEAR_LIMIT) return value < 0 ? 0 : value;
+
+        int octave = HighestBit(static_cast<std::uint32_t>(value));  // >= 4
+        int sub = (value >> (octave - 3)) & (SUB_BUCKETS - 1);
+        return LINEAR_LIMIT + (octave - 4) * SUB_BUCKETS + sub;
+    }
+
+    static int BucketLowerBound(int index) {
+        if (index < LINEAR_LIMIT) return index;
+
+        int octave = 4 + (index - LINEAR_LIMIT) / SUB_BUCKETS;
+        int sub = (index - LINEAR_LIMIT) % SUB_BUCKETS;
+        return (SUB_BUCKETS + sub) << (octave - 3);
+    }
+};
+
+/**
+ * ScoreAggregates - Running summary of every game added to a history
+ *
+ * Plain fixed-width data (no pointers), so ScoreLog can store it in its
+ * file header and restore it at startup without scanning any records.
+ */
+struct ScoreAggregates {
+    std::int64_t count;
+    std::int32_t bestScore;
+    std::int32_t bestHeight;
+    std::int64_t scoreSum;
+    std::int64_t heightSum;
+    ScoreSketch scoreSketch;
+    ScoreSketch heightSketch;
+
+    ScoreAggregates() { Clear(); }
+
+    void Add(int score, int height) {
+        count++;
+        if (score > bestScore) bestScore = score;
+        if (height > bestHeight) bestHeight = height;
+        scoreSum += score;
+        heightSum += height;
+        scoreSketch.Add(score);
+        heightSketch.Add(height);
+    }
+
+    void Clear() {
+        count = 0;
+        bestScore = 0;
+        bestHeight = 0;
+        scoreSum = 0;
+        heightSum = 0;
+        scoreSketch.Clear();
+        heightSketch.Clear();
+    }
+};
+
+/**
+ * ScoreHistory Class - Demonstrates LINKED LIST Data Structure
+ *
+ * The numbers the UI asks for every frame (best, mean, count, percentiles)
+ * are running aggregates updated in AddScore, so their cost does not
+ * depend on how many games were played.
+ *
+ * Nodes come from a ScoreNodePool. With maxStored > 0 the history works
+ * as a ring buffer: once full, each new game reuses the oldest node, so
+ * memory stays bounded in long kiosk sessions. Aggregates always cover
+ * every game ever added, not only the stored ones.
+ *
+ * Time Complexity:
+ * - Insert at head: O(1) - also updates the aggregates
+ * - Best / mean / count: O(1)
+ * - Percentile: O(1) - fixed-size ScoreSketch
+ * - Clear all: O(1) - the pool is reset, not freed node by node
+ */
+class ScoreHistory {
+private:
+    ScoreNode* head;        // LINKED LIST: Head pointer
+    size_t pushed;          // Nodes pushed since Clear (drives the ring slot)
+    size_t maxStored;       // 0 = keep every game, otherwise ring size
+    ScoreNodePool pool;     // Storage for every node in the list
+    ScoreAggregates aggregates;  // Running totals, maintained by AddScore
+
+    /**
+     * Ring mode: nodes are reused in allocation order, so the oldest node
+     * (the tail) lives in ring slot `pushed % maxStored` and the node that
+     * points at it is the next slot along. Unlinking the tail is O(1)
+     * even though the list is singly linked.
+     */
+    ScoreNode* RecycleOldestNode() {
+        size_t slot = pushed % maxStored;
+        ScoreNode& secondOldest = pool.At((slot + 1) % maxStored);
+        secondOldest.next = nullptr;  // LINKED LIST: New tail
+        return &pool.At(slot);
+    }
+
+    // LINKED LIST OPERATION: Insert at Head - O(1)
+    void PushNode(int score, int height) {
+        bool full = maxStored > 0 && pool.GetUsed() == maxStored;
+        ScoreNode* newNode = full ? RecycleOldestNode() : pool.Allocate();
+
+        newNode->score = score;
+        newNode->height = height;
+        newNode->next = (head == newNode) ? nullptr : head;  // New node points to old head
+        head = newNode;        // Head now points to new node
+        pushed++;
+    }
+
+public:
+    // maxStored = 0 keeps every game; otherwise only the newest maxStored
+    explicit ScoreHistory(size_t maxStored = 0)
+        : head(nullptr), pushed(0), maxStored(maxStored) {}
+
+    // Nodes point into the pool, so copying would leave dangling pointers
+    ScoreHistory(const ScoreHistory&) = delete;
+    ScoreHistory& operator=(const ScoreHistory&) = delete;
+
+    // Record a finished game - O(1)
+    void AddScore(int score, int height) {
+        PushNode(score, height);
+
+        // Keep the aggregates current so readers never traverse the list
+        aggregates.Add(score, height);
+    }
+
+    /**
+     * Startup path for persisted history (see ScoreLog): adopt aggregates
+     * saved with the log, then push the newest stored games oldest first
+     * with RestoreNode, which does not count them a second time.
+     */
+    void RestoreAggregates(const ScoreAggregates& saved) { aggregates = saved; }
+    void RestoreNode(int score, int height) { PushNode(score, height); }
+
+    const ScoreAggregates& GetAggregates() const { return aggregates; }
+
+    // Best score so far - O(1), maintained by AddScore
+    int GetBestScore() const { return aggregates.bestScore; }
+
+    // Best height so far - O(1), maintained by AddScore
+    int GetBestHeight() const { return aggregates.bestHeight; }
+
+    double GetMeanScore() const {
+        return aggregates.count > 0 ? double(aggregates.scoreSum) / aggregates.count : 0.0;
+    }
+    double GetMeanHeight() const {
+        return aggregates.count > 0 ? double(aggregates.heightSum) / aggregates.count : 0.0;
+    }
+
+    // Approximate percentiles (within 12.5%), q in [0, 1]
+    int GetScorePercentile(double q) const { return aggregates.scoreSketch.Percentile(q); }
+    int GetHeightPercentile(double q) const { return aggregates.heightSketch.Percentile(q); }
+
+    // LINKED LIST: Newest game first; follow node->next to walk the history
+    const ScoreNode* GetHead() const { return head; }
+
+    int GetCount() const { return static_cast<int>(aggregates.count); }
+
+    // Nodes currently in the list (at most maxStored in ring mode)
+    size_t GetStoredCount() const { return pool.GetUsed(); }
+
+    void Clear() {
+        pool.Reset();
+        head = nullptr;
+        pushed = 0;
+        aggregates.Clear();
+    }
+};
@@ -0,0 +1,225 @@
+/**
+ * ScoreLog - Persistent, memory-mapped, append-only log of finished games
+ * See score_log.h for the file layout.
+ */
+
+#include "score_log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable<ScoreLogHeader>::value,
+              "ScoreLogHeader is copied to and from the mapping byte for byte");
+static_assert(sizeof(ScoreRecord) == 24, "ScoreRecord layout is part of the file format");
+
+std::size_t ScoreLog::FileSizeFor(std::uint64_t capacity) {
+    return sizeof(ScoreLogHeader) + static_cast<std::size_t>(capacity) * sizeof(ScoreRecord);
+}
+
+bool ScoreLog::Open(const char* path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    file = handle;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        Close();
+        return false;
+    }
+    std::size_t fileSize = static_cast<std::size_t>(size.QuadPart);
+#else
+    file = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (file < 0) return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        Close();
+        return false;
+    }
+    std::size_t fileSize = static_cast<std::size_t>(info.st_size);
+#endif
+
+    if (fileSize == 0) {
+        // New log: empty header plus room for INITIAL_CAPACITY records
+        header = ScoreLogHeader{};
+        header.magic = ScoreLogHeader::MAGIC;
+        header.version = ScoreLogHeader::VERSION;
+        header.headerSize = sizeof(ScoreLogHeader);
+        header.recordSize = sizeof(ScoreRecord);
+        header.recordCount = 0;
+        header.capacity = INITIAL_CAPACITY;
+        header.aggregates.Clear();
+
+        if (!Map(FileSizeFor(header.capacity))) {
+            Close();
+            return false;
+        }
+        WriteHeader();
+        return true;
+    }
+
+    if (fileSize < sizeof(ScoreLogHeader) || !Map(fileSize)) {
+        Close();
+        return false;
+    }
+
+    std::memcpy(&header, view, sizeof(header));
+    bool valid = header.magic == ScoreLogHeader::MAGIC &&
+                 header.version == ScoreLogHeader::VERSION &&
+                 header.headerSize == sizeof(ScoreLogHeader) &&
+                 header.recordSize == sizeof(ScoreRecord) &&
+                 header.capacity > 0 &&
+                 header.recordCount <= header.capacity &&
+                 FileSizeFor(header.capacity) <= fileSize;
+    if (!valid) {
+        Close();
+        return false;
+    }
+
+    if (header.aggregates.count != static_cast<std::int64_t>(header.recordCount)) {
+        RebuildAggregates();
+    }
+    return true;
+}
+
+void ScoreLog::Close() {
+    Unmap();
+    header = ScoreLogHeader{};
+#ifdef _WIN32
+    if (file != nullptr) {
+        CloseHandle(static_cast<HANDLE>(file));
+        file = nullptr;
+    }
+#else
+    if (file >= 0) {
+        ::close(file);
+        file = -1;
+    }
+#endif
+}
+
+bool ScoreLog::Append(const ScoreRecord& record) {
+    if (!IsOpen()) return false;
+    if (header.recordCount == header.capacity && !Grow()) return false;
+
+    // Record first, then the header that makes it visible
+    std::memcpy(view + FileSizeFor(header.recordCount), &record, sizeof(record));
+    header.recordCount++;
+    header.aggregates.Add(record.score, record.height);
+    WriteHeader();
+    return true;
+}
+
+ScoreRecord ScoreLog::GetRecord(std::uint64_t index) const {
+    ScoreRecord record{};
+    if (IsOpen() && index < header.recordCount) {
+        std::memcpy(&record, view + FileSizeFor(index), sizeof(record));
+    }
+    return record;
+}
+
+void ScoreLog::LoadInto(ScoreHistory& history, std::uint64_t maxNodes) const {
+    history.Clear();
+    history.RestoreAggregates(header.aggregates);
+
+    std::uint64_t count = header.recordCount;
+    std::uint64_t first = count - std::min(count, maxNodes);
+    for (std::uint64_t i = first; i < count; i++) {
+        ScoreRecord record = GetRecord(i);
+        history.RestoreNode(record.score, record.height);  // LINKED LIST: Oldest first
+    }
+}
+
+bool ScoreLog::Map(std::size_t size) {
+#ifdef _WIN32
+    // Creating a mapping larger than the file extends the file
+    ULARGE_INTEGER mappedSize;
+    mappedSize.QuadPart = size;
+    HANDLE handle = CreateFileMappingA(static_cast<HANDLE>(file), nullptr, PAGE_READWRITE,
+                                       mappedSize.HighPart, mappedSize.LowPart, nullptr);
+    if (handle == nullptr) return false;
+
+    void* address = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (address == nullptr) {
+        CloseHandle(handle);
+        return false;
+    }
+    mapping = handle;
+#else
+    struct stat info;
+    if (fstat(file, &info) != 0) return false;
+    if (static_cast<std::size_t>(info.st_size) < size &&
+        ftruncate(file, static_cast<off_t>(size)) != 0) {
+        return false;
+    }
+
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (address == MAP_FAILED) return false;
+#endif
+
+    view = static_cast<unsigned char*>(address);
+    viewSize = size;
+    return true;
+}
+
+void ScoreLog::Unmap() {
+    if (view == nullptr) return;
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+    CloseHandle(static_cast<HANDLE>(mapping));
+    mapping = nullptr;
+#else
+    munmap(view, viewSize);
+#endif
+    view = nullptr;
+    viewSize = 0;
+}
+
+// Double the record capacity; the mapping has to be rebuilt at the new size.
+// Never below INITIAL_CAPACITY, so a zero capacity still makes room.
+bool ScoreLog::Grow() {
+    std::uint64_t newCapacity = std::max<std::uint64_t>(header.capacity * 2, INITIAL_CAPACITY);
+    Unmap();
+    if (!Map(FileSizeFor(newCapacity))) {
+        // Fall back to the old size so the log stays usable
+        Map(FileSizeFor(header.capacity));
+        return false;
+    }
+    header.capacity = newCapacity;
+    WriteHeader();
+    return true;
+}
+
+void ScoreLog::WriteHeader() {
+    std::memcpy(view, &header, sizeof(header));
+}
+
+// Recovery path only: recompute the summary from every record - O(n)
+void ScoreLog::RebuildAggregates() {
+    header.aggregates.Clear();
+    for (std::uint64_t i = 0; i < header.recordCount; i++) {
+        ScoreRecord record = GetRecord(i);
+        header.aggregates.Add(record.score, record.height);
+    }
+    WriteHeader();
+}
@@ -0,0 +1,103 @@
+/**
+ * ScoreLog - Persistent, memory-mapped, append-only log of finished games
+ *
+ * File layout (native endianness, fixed-width fields):
+ *
+ *     ScoreLogHeader   magic, version, record count, ScoreAggregates
+ *     ScoreRecord[0]   oldest game
+ *     ScoreRecord[1]
+ *     ...              capacity grows by doubling, unused tail is zero
+ *
+ * WHY MEMORY-MAPPED?
+ * - Opening the log maps the file instead of reading and parsing it, so a
+ *   history of millions of games is available in milliseconds
+ * - The header carries the precomputed aggregates (best, sums, sketches),
+ *   so GetBestScore() is correct on boot without scanning any record
+ * - Appending a game writes one record and the header in place
+ *
+ * A record is written before the header that counts it. If the aggregates
+ * in the header do not match the record count on open (for example after
+ * a crash between the two writes), they are rebuilt from the records.
+ */
+
+#pragma once
+
+#include "score_history.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * One finished game as stored on disk
+ */
+struct ScoreRecord {
+    std::int32_t score;
+    std::int32_t height;
+    std::int64_t timestamp;  // Unix time in seconds
+    std::uint64_t seed;      // Seed of the game's block sequence
+};
+
+struct ScoreLogHeader {
+    static constexpr std::uint32_t MAGIC = 0x4C534254;  // "TBSL"
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint32_t recordSize;
+    std::uint64_t recordCount;
+    std::uint64_t capacity;     // Records the file has room for
+    ScoreAggregates aggregates; // Summary of records [0, recordCount)
+};
+
+class ScoreLog {
+public:
+    static constexpr std::uint64_t INITIAL_CAPACITY = 1024;
+
+    ScoreLog() = default;
+    ~ScoreLog() { Close(); }
+
+    ScoreLog(const ScoreLog&) = delete;
+    ScoreLog& operator=(const ScoreLog&) = delete;
+
+    // Map an existing log or create an empty one. Returns false on I/O error
+    // or if the file exists but is not a score log.
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return view != nullptr; }
+
+    // Append one game and update the header aggregates - O(1) amortized
+    bool Append(const ScoreRecord& record);
+
+    std::uint64_t GetRecordCount() const { return header.recordCount; }
+    const ScoreAggregates& GetAggregates() const { return header.aggregates; }
+
+    // Random access into the mapping - O(1), index 0 is the oldest game
+    ScoreRecord GetRecord(std::uint64_t index) const;
+
+    /**
+     * Seed a ScoreHistory: adopt the saved aggregates, then restore the
+     * newest `maxNodes` records (oldest first) into its list.
+     */
+    void LoadInto(ScoreHistory& history, std::uint64_t maxNodes) const;
+
+private:
+    ScoreLogHeader header{};
+    unsigned char* view = nullptr;  // Mapped file contents
+    std::size_t viewSize = 0;
+
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#else
+    int file = -1;
+#endif
+
+    static std::size_t FileSizeFor(std::uint64_t capacity);
+
+    bool Map(std::size_t size);
+    void Unmap();
+    bool Grow();
+    void WriteHeader();
+    void RebuildAggregates();
+};
@@ -0,0 +1,359 @@
+/**
+ * Tower Builder - Batch Monte Carlo runner (TowerBuilderSim)
+ *
+ * Plays N independent games on a work-stealing pool and reports the
+ * height and score distributions. Every game gets its own Simulation,
+ * its own DropPolicy and a seed derived from (--seed, game index), so
+ * results are reproducible for any thread count.
+ *
+ * Workers append finished-game records to their own buffers; the buffers
+ * are merged only after all workers have joined, so nothing on the hot
+ * path takes a shared lock or touches a shared cache line.
+ *
+ * --engine batch steps groups of --lanes games through the SIMD
+ * BatchSimulation instead of one Simulation per game. Adding --verify
+ * also runs a scalar Simulation per lane in lock step and fails on the
+ * first state that is not bit-identical.
+ *
+ * Usage:
+ *   TowerBuilderSim [--games N] [--threads N] [--seed S]
+ *                   [--engine scalar|batch] [--lanes N] [--verify]
+ *                   [--policy fixed|gaussian|reaction|predictive] [--offset PX]
+ *                   [--sigma PX] [--reaction-ms MS] [--reaction-sd-ms MS]
+ *                   [--anticipation-ms MS] [--initial-speed PX/S]
+ *                   [--speed-increment PX/S] [--perfect-threshold PX]
+ *                   [--min-overlap RATIO] [--tick-rate HZ] [--max-ticks N]
+ */
+
+#include "batch_simulation.h"
+#include "drop_policy.h"
+#include "simulation.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct RunnerOptions {
+    long long games = 10000;
+    unsigned threads = 0;           // 0 = all hardware threads
+    std::uint64_t seed = 1;
+    float tickRate = 240.0f;
+    long long maxTicks = 10000000;  // Per-game cap
+    bool batchEngine = false;       // Step games through BatchSimulation
+    int lanes = 256;                // Games per BatchSimulation
+    bool verify = false;            // Check batch lanes against scalar games
+    SimParams params;
+    DropPolicyConfig policy;
+};
+
+// One finished game - the batch equivalent of a ScoreNode
+struct GameRecord {
+    int score;
+    int height;
+    long long ticks;
+};
+
+// Per-worker results, padded so workers never share a cache line
+struct alignas(64) WorkerResults {
+    std::vector<GameRecord> records;
+    long long verifiedTicks = 0;
+    long long firstMismatchGame = -1;
+    long long firstMismatchTick = -1;
+};
+
+void PrintUsage(const char* program) {
+    std::printf(
+        "Usage: %s [--games N] [--threads N] [--seed S]\n"
+        "          [--engine scalar|batch] [--lanes N] [--verify]\n"
+        "          [--policy fixed|gaussian|reaction|predictive] [--offset PX] [--sigma PX]\n"
+        "          [--reaction-ms MS] [--reaction-sd-ms MS] [--anticipation-ms MS]\n"
+        "          [--initial-speed PX/S] [--speed-increment PX/S]\n"
+        "          [--perfect-threshold PX] [--min-overlap RATIO]\n"
+        "          [--tick-rate HZ] [--max-ticks N]\n",
+        program);
+}
+
+bool ParseOptions(int argc, char** argv, RunnerOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto asFloat = [&]() { return static_cast<float>(std::atof(value)); };
+
+        if (std::strcmp(arg, "--help") == 0) {
+            return false;
+        } else if (std::strcmp(arg, "--verify") == 0) {
+            options.verify = true;
+            continue;
+        } else if (value == nullptr) {
+            std::fprintf(stderr, "Missing value for %s\n", arg);
+            return false;
+        } else if (std::strcmp(arg, "--games") == 0) {
+            options.games = std::atoll(value);
+        } else if (std::strcmp(arg, "--engine") == 0) {
+            if (std::strcmp(value, "batch") == 0) {
+                options.batchEngine = true;
+            } else if (std::strcmp(value, "scalar") != 0) {
+                std::fprintf(stderr, "Unknown engine %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--lanes") == 0) {
+            options.lanes = std::atoi(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--policy") == 0) {
+            if (!ParseDropPolicyKind(value, options.policy.kind)) {
+                std::fprintf(stderr, "Unknown policy %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--offset") == 0) {
+            options.policy.offset = asFloat();
+        } else if (std::strcmp(arg, "--sigma") == 0) {
+            options.policy.jitterSigma = asFloat();
+        } else if (std::strcmp(arg, "--reaction-ms") == 0) {
+            options.policy.reactionMeanMs = asFloat();
+        } else if (std::strcmp(arg, "--reaction-sd-ms") == 0) {
+            options.policy.reactionSdMs = asFloat();
+        } else if (std::strcmp(arg, "--anticipation-ms") == 0) {
+            options.policy.anticipationMs = asFloat();
+        } else if (std::strcmp(arg, "--initial-speed") == 0) {
+            options.params.initialSpeed = asFloat();
+        } else if (std::strcmp(arg, "--speed-increment") == 0) {
+            options.params.speedIncrement = asFloat();
+        } else if (std::strcmp(arg, "--perfect-threshold") == 0) {
+            options.params.perfectThreshold = asFloat();
+        } else if (std::strcmp(arg, "--min-overlap") == 0) {
+            options.params.minOverlapRatio = asFloat();
+        } else if (std::strcmp(arg, "--tick-rate") == 0) {
+            options.tickRate = asFloat();
+        } else if (std::strcmp(arg, "--max-ticks") == 0) {
+            options.maxTicks = std::atoll(value);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+        i++;
+    }
+    if (options.verify && !options.batchEngine) {
+        std::fprintf(stderr, "--verify requires --engine batch\n");
+        return false;
+    }
+    return options.games > 0 && options.tickRate > 0.0f && options.maxTicks > 0 &&
+           options.lanes > 0;
+}
+
+GameRecord PlayGame(const RunnerOptions& options, std::uint64_t seed) {
+    Simulation simulation(options.params);
+    DropPolicy policy(options.policy, seed);
+    policy.BeginBlock(simulation);
+
+    SimInput input;
+    input.deltaTime = 1.0f / options.tickRate;
+
+    long long ticks = 0;
+    while (!simulation.IsGameOver() && ticks < options.maxTicks) {
+        input.drop = policy.ShouldDrop(simulation, input.deltaTime);
+        SimDelta delta = simulation.Step(input);
+        ticks++;
+
+        if (delta.stacked) {
+            policy.BeginBlock(simulation);
+        }
+    }
+
+    return GameRecord{simulation.GetScore(), simulation.GetTowerHeight(), ticks};
+}
+
+// Bit-for-bit comparison of one batch lane against a scalar game
+bool SameBits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+bool LaneMatches(const BatchSimulation& batch, int lane, const Simulation& simulation) {
+    const Block& current = simulation.GetCurrentBlock();
+    const Block& top = simulation.GetTower().Top();
+    return batch.IsGameOver(lane) == simulation.IsGameOver() &&
+           SameBits(batch.GetCurrentX(lane), current.rect.x) &&
+           SameBits(batch.GetCurrentWidth(lane), current.rect.width) &&
+           SameBits(batch.GetTopX(lane), top.rect.x) &&
+           SameBits(batch.GetTopWidth(lane), top.rect.width) &&
+           SameBits(batch.GetBlockSpeed(lane), simulation.GetBlockSpeed()) &&
+           batch.GetDirection(lane) == simulation.GetDirection() &&
+           batch.GetScore(lane) == simulation.GetScore() &&
+           batch.GetConsecutivePerfects(lane) == simulation.GetConsecutivePerfects() &&
+           batch.GetTowerHeight(lane) == simulation.GetTowerHeight();
+}
+
+// Plays games [firstGame, firstGame + count) as lanes of one BatchSimulation
+void PlayBatch(const RunnerOptions& options, long long firstGame, int count,
+               WorkerResults& results) {
+    BatchSimulation batch(count, options.params);
+    std::vector<DropPolicy> policies;
+    policies.reserve(count);
+    for (int lane = 0; lane < count; lane++) {
+        policies.emplace_back(options.policy, GameSeed(options.seed, firstGame + lane));
+        policies[lane].BeginBlock(batch.GetCurrentX(lane), batch.GetCurrentWidth(lane),
+                                  batch.GetTopX(lane), batch.GetBlockSpeed(lane),
+                                  batch.GetDirection(lane));
+    }
+
+    // Scalar reference games, only when verifying
+    std::vector<std::unique_ptr<Simulation>> reference;
+    if (options.verify) {
+        for (int lane = 0; lane < count; lane++) {
+            reference.push_back(std::make_unique<Simulation>(options.params));
+        }
+    }
+
+    const float deltaTime = 1.0f / options.tickRate;
+    std::vector<char> recorded(count, 0);
+    int live = count;
+
+    for (long long tick = 0; live > 0 && tick < options.maxTicks; tick++) {
+        for (int lane = 0; lane < count; lane++) {
+            if (!batch.IsGameOver(lane) &&
+                policies[lane].ShouldDrop(batch.GetCurrentX(lane), deltaTime)) {
+                batch.RequestDrop(lane);
+                if (options.verify) {
+                    reference[lane]->Step(SimInput{deltaTime, true});
+                }
+            } else if (options.verify) {
+                reference[lane]->Step(SimInput{deltaTime, false});
+            }
+        }
+
+        batch.Step(deltaTime);
+
+        for (int lane = 0; lane < count; lane++) {
+            if (recorded[lane]) continue;
+
+            if (options.verify && !LaneMatches(batch, lane, *reference[lane])) {
+                results.firstMismatchGame = firstGame + lane;
+                results.firstMismatchTick = tick;
+                return;
+            }
+
+            if (batch.StackedLastStep(lane)) {
+                policies[lane].BeginBlock(batch.GetCurrentX(lane), batch.GetCurrentWidth(lane),
+                                          batch.GetTopX(lane), batch.GetBlockSpeed(lane),
+                                          batch.GetDirection(lane));
+            } else if (batch.IsGameOver(lane)) {
+                results.records.push_back(GameRecord{batch.GetScore(lane),
+                                                     batch.GetTowerHeight(lane), tick + 1});
+                recorded[lane] = 1;
+                live--;
+            }
+        }
+        if (options.verify) results.verifiedTicks += live;
+    }
+
+    // Games that hit --max-ticks
+    for (int lane = 0; lane < count; lane++) {
+        if (!recorded[lane]) {
+            results.records.push_back(GameRecord{batch.GetScore(lane),
+                                                 batch.GetTowerHeight(lane), options.maxTicks});
+        }
+    }
+}
+
+// Nearest-rank percentile of an already sorted vector
+int Percentile(const std::vector<int>& sorted, double fraction) {
+    size_t rank = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void PrintDistribution(const char* name, std::vector<int>& values) {
+    std::sort(values.begin(), values.end());
+
+    double sum = 0;
+    for (int value : values) sum += value;
+
+    std::printf("%-7s mean %10.2f  p10 %7d  p50 %7d  p90 %7d  p99 %7d  max %7d\n",
+                name, sum / values.size(),
+                Percentile(values, 0.10), Percentile(values, 0.50),
+                Percentile(values, 0.90), Percentile(values, 0.99), values.back());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    RunnerOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    WorkStealingPool pool(options.threads);
+    std::vector<WorkerResults> results(pool.GetThreadCount());
+    for (WorkerResults& worker : results) {
+        worker.records.reserve(options.games / pool.GetThreadCount() + 1);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (options.batchEngine) {
+        long long groups = (options.games + options.lanes - 1) / options.lanes;
+        pool.ParallelFor(groups, [&](std::int64_t group, unsigned worker) {
+            long long firstGame = group * options.lanes;
+            int count = static_cast<int>(std::min<long long>(options.lanes,
+                                                             options.games - firstGame));
+            PlayBatch(options, firstGame, count, results[worker]);
+        });
+    } else {
+        pool.ParallelFor(options.games, [&](std::int64_t game, unsigned worker) {
+            results[worker].records.push_back(PlayGame(options, GameSeed(options.seed, game)));
+        });
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count();
+
+    // Merge per-worker records now that every worker has joined
+    std::vector<int> heights, scores;
+    heights.reserve(options.games);
+    scores.reserve(options.games);
+    long long totalTicks = 0;
+    for (const WorkerResults& worker : results) {
+        for (const GameRecord& record : worker.records) {
+            heights.push_back(record.height);
+            scores.push_back(record.score);
+            totalTicks += record.ticks;
+        }
+    }
+
+    if (options.verify) {
+        long long verifiedTicks = 0;
+        for (const WorkerResults& worker : results) {
+            if (worker.firstMismatchGame >= 0) {
+                std::printf("Verify:  MISMATCH in game %lld at tick %lld\n",
+                            worker.firstMismatchGame, worker.firstMismatchTick);
+                return 1;
+            }
+            verifiedTicks += worker.verifiedTicks;
+        }
+        std::printf("Verify:  batch engine bit-identical to scalar over %lld lane-ticks\n",
+                    verifiedTicks);
+    }
+
+    std::printf("Games:   %lld on %u threads (%s engine)\n", options.games,
+                pool.GetThreadCount(), options.batchEngine ? "batch" : "scalar");
+    std::printf("Params:  initial-speed %.2f  speed-increment %.2f  perfect-threshold %.2f"
+                "  min-overlap %.3f\n",
+                options.params.initialSpeed, options.params.speedIncrement,
+                options.params.perfectThreshold, options.params.minOverlapRatio);
+    std::printf("Elapsed: %.3f s  (%.0f games/s, %.0f ticks/s)\n", seconds,
+                seconds > 0 ? options.games / seconds : 0.0,
+                seconds > 0 ? totalTicks / seconds : 0.0);
+    PrintDistribution("Height", heights);
+    PrintDistribution("Score", scores);
+    return 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * simd.h - Minimal SIMD backends for the batch simulation kernel
+ *
+ * Each backend exposes the same static functions over a float vector (F),
+ * an int32 vector (I) and a lane mask (M), WIDTH lanes at a time:
+ *
+ * - SimdAvx2:   8 lanes (x86-64 built with AVX2, e.g. -mavx2 or -march=native)
+ * - SimdNeon:   4 lanes (AArch64 NEON)
+ * - SimdScalar: 1 lane  (portable fallback, also the reference semantics)
+ *
+ * Only IEEE operations that are exact (add, sub, mul, div, compare, select,
+ * truncating convert) are used, and Min/Max are written as compare+select
+ * with std::min/std::max argument order, so every backend produces results
+ * bit-identical to the scalar Simulation.
+ *
+ * SimdNative is the widest backend the compiler was allowed to use.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+struct SimdScalar {
+    static constexpr int WIDTH = 1;
+    using F = float;
+    using I = std::int32_t;
+    using M = bool;
+
+    static F Load(const float* p) { return *p; }
+    static void Store(float* p, F v) { *p = v; }
+    static F Set(float v) { return v; }
+    static F Add(F a, F b) { return a + b; }
+    static F Sub(F a, F b) { return a - b; }
+    static F Mul(F a, F b) { return a * b; }
+    static F Div(F a, F b) { return a / b; }
+    static F Abs(F a) { return std::fabs(a); }
+    static M Less(F a, F b) { return a < b; }
+    static M LessEqual(F a, F b) { return a <= b; }
+    static M Greater(F a, F b) { return a > b; }
+    static M GreaterEqual(F a, F b) { return a >= b; }
+    static F Select(M m, F a, F b) { return m ? a : b; }
+
+    static I LoadI(const std::int32_t* p) { return *p; }
+    static void StoreI(std::int32_t* p, I v) { *p = v; }
+    static I SetI(std::int32_t v) { return v; }
+    static I AddI(I a, I b) { return a + b; }
+    static I MulI(I a, I b) { return a * b; }
+    static M EqualI(I a, I b) { return a == b; }
+    static I SelectI(M m, I a, I b) { return m ? a : b; }
+    static I Truncate(F a) { return static_cast<std::int32_t>(a); }
+
+    static M And(M a, M b) { return a && b; }
+    static M Or(M a, M b) { return a || b; }
+    static M AndNot(M a, M b) { return a && !b; }  // a & ~b
+    static M NonZero(I a) { return a != 0; }
+    static I MaskToInt(M m) { return m ? 1 : 0; }
+    static bool Any(M m) { return m; }
+};
+
+#if defined(__AVX2__)
+
+struct SimdAvx2 {
+    static constexpr int WIDTH = 8;
+    using F = __m256;
+    using I = __m256i;
+    using M = __m256;  // All-ones lanes are true
+
+    static F Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm256_storeu_ps(p, v); }
+    static F Set(float v) { return _mm256_set1_ps(v); }
+    static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+    static F Abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static M Less(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static M LessEqual(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static M Greater(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static M GreaterEqual(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static F Select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+
+    static I LoadI(const std::int32_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static void StoreI(std::int32_t* p, I v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+    static I SetI(std::int32_t v) { return _mm256_set1_epi32(v); }
+    static I AddI(I a, I b) { return _mm256_add_epi32(a, b); }
+    static I MulI(I a, I b) { return _mm256_mullo_epi32(a, b); }
+    static M EqualI(I a, I b) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)); }
+    static I SelectI(M m, I a, I b) {
+        return _mm256_castps_si256(
+            _mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), m));
+    }
+    static I Truncate(F a) { return _mm256_cvttps_epi32(a); }
+
+    static M And(M a, M b) { return _mm256_and_ps(a, b); }
+    static M Or(M a, M b) { return _mm256_or_ps(a, b); }
+    static M AndNot(M a, M b) { return _mm256_andnot_ps(b, a); }  // a & ~b
+    static M NonZero(I a) {
+        M zero = _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, _mm256_setzero_si256()));
+        return _mm256_xor_ps(zero, _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+    }
+    static I MaskToInt(M m) { return _mm256_srli_epi32(_mm256_castps_si256(m), 31); }
+    static bool Any(M m) { return _mm256_movemask_ps(m) != 0; }
+};
+
+using SimdNative = SimdAvx2;
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+struct SimdNeon {
+    static constexpr int WIDTH = 4;
+    using F = float32x4_t;
+    using I = int32x4_t;
+    using M = uint32x4_t;
+
+    static F Load(const float* p) { return vld1q_f32(p); }
+    static void Store(float* p, F v) { vst1q_f32(p, v); }
+    static F Set(float v) { return vdupq_n_f32(v); }
+    static F Add(F a, F b) { return vaddq_f32(a, b); }
+    static F Sub(F a, F b) { return vsubq_f32(a, b); }
+    static F Mul(F a, F b) { return vmulq_f32(a, b); }
+    static F Div(F a, F b) { return vdivq_f32(a, b); }
+    static F Abs(F a) { return vabsq_f32(a); }
+    static M Less(F a, F b) { return vcltq_f32(a, b); }
+    static M LessEqual(F a, F b) { return vcleq_f32(a, b); }
+    static M Greater(F a, F b) { return vcgtq_f32(a, b); }
+    static M GreaterEqual(F a, F b) { return vcgeq_f32(a, b); }
+    static F Select(M m, F a, F b) { return vbslq_f32(m, a, b); }
+
+    static I LoadI(const std::int32_t* p) { return vld1q_s32(p); }
+    static void StoreI(std::int32_t* p, I v) { vst1q_s32(p, v); }
+    static I SetI(std::int32_t v) { return vdupq_n_s32(v); }
+    static I AddI(I a, I b) { return vaddq_s32(a, b); }
+    static I MulI(I a, I b) { return vmulq_s32(a, b); }
+    static M EqualI(I a, I b) { return vceqq_s32(a, b); }
+    static I SelectI(M m, I a, I b) { return vbslq_s32(m, a, b); }
+    static I Truncate(F a) { return vcvtq_s32_f32(a); }
+
+    static M And(M a, M b) { return vandq_u32(a, b); }
+    static M Or(M a, M b) { return vorrq_u32(a, b); }
+    static M AndNot(M a, M b) { return vbicq_u32(a, b); }  // a & ~b
+    static M NonZero(I a) { return vtstq_s32(a, a); }
+    static I MaskToInt(M m) { return vreinterpretq_s32_u32(vshrq_n_u32(m, 31)); }
+    static bool Any(M m) { return vmaxvq_u32(m) != 0; }
+};
+
+using SimdNative = SimdNeon;
+
+#else
+
+using SimdNative = SimdScalar;
+
+#endif
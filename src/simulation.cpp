@@ -0,0 +1,264 @@
+/**
+ * Simulation - raylib-free game rules for Tower Builder
+ * See simulation.h for an overview.
+ */
+
+#include "simulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+Simulation::Simulation(const SimParams& params, std::uint64_t seed)
+    : params(params), gameOver(false), score(0), consecutivePerfects(0),
+      blockSpeed(params.initialSpeed), direction(1) {
+    Reset(seed);
+}
+
+void Simulation::Reset(std::uint64_t seed) {
+    tower.Clear();
+    sequence = BlockSequence(seed);
+    history.Clear();
+    historyTop = BlockHistory::EMPTY;
+    rewriteFloor = std::numeric_limits<int>::max();
+    score = 0;
+    consecutivePerfects = 0;
+    blockSpeed = params.initialSpeed;
+    direction = 1;
+    gameOver = false;
+
+    // Create base block
+    Block baseBlock(
+        SCREEN_WIDTH / 2 - INITIAL_BLOCK_WIDTH / 2,
+        SCREEN_HEIGHT - 100,
+        INITIAL_BLOCK_WIDTH,
+        BLOCK_HEIGHT,
+        0,
+        0
+    );
+    baseBlock.isMoving = false;
+    PushBlock(baseBlock);  // STACK: Push base block
+
+    SpawnNextBlock();
+}
+
+SimDelta Simulation::Step(const SimInput& input) {
+    SimDelta delta;
+    if (gameOver) return delta;
+
+    if (input.drop && input.dropTime >= 0.0f && input.dropTime < input.deltaTime) {
+        // Sub-step drop: land the block where it was at press time, then
+        // give the newly spawned block the remainder of the step
+        UpdateBlockMovement(input.dropTime);
+        DropBlock(delta);
+        if (!gameOver) {
+            UpdateBlockMovement(input.deltaTime - input.dropTime);
+        }
+        return delta;
+    }
+
+    UpdateBlockMovement(input.deltaTime);
+
+    if (input.drop) {
+        DropBlock(delta);
+    }
+
+    return delta;
+}
+
+// STACK OPERATION: Push - O(1), recorded in the history when enabled
+void Simulation::PushBlock(const Block& block) {
+    tower.Push(block);
+    if (historyEnabled) {
+        historyTop = history.Push(historyTop, block);
+    }
+}
+
+Simulation::Snapshot Simulation::TakeSnapshot() const {
+    Snapshot snapshot;
+    snapshot.top = historyTop;
+    snapshot.currentBlock = currentBlock;
+    snapshot.score = score;
+    snapshot.consecutivePerfects = consecutivePerfects;
+    snapshot.blockSpeed = blockSpeed;
+    snapshot.direction = direction;
+    snapshot.gameOver = gameOver;
+    return snapshot;
+}
+
+void Simulation::RestoreSnapshot(const Snapshot& snapshot) {
+    // STACK: Pop down to just below the part both towers share, then push
+    // the target's blocks from the shared top up. Pushing the shared top
+    // back keeps Top() exact, since a pop exposes a packed block. Compacted
+    // blocks can't be popped, so a target that branches off at or below
+    // the compacted part is rebuilt from the base.
+    BlockHistory::NodeId shared = history.CommonAncestor(historyTop, snapshot.top);
+    int sharedHeight = static_cast<int>(history.GetDepth(shared));
+
+    if (sharedHeight <= tower.GetSummary().blockCount) {
+        RebuildTower(snapshot.top);
+    } else {
+        while (tower.GetHeight() >= sharedHeight) {
+            tower.Pop();
+        }
+        rewriteFloor = std::min(rewriteFloor, tower.GetHeight());
+
+        // Walk down from the target collecting its new blocks and the
+        // shared top, then push them bottom-up
+        BlockHistory::NodeId below = history.GetParent(shared);
+        restoreChain.clear();
+        for (BlockHistory::NodeId node = snapshot.top; node != below;
+             node = history.GetParent(node)) {
+            restoreChain.push_back(node);
+        }
+        for (auto it = restoreChain.rbegin(); it != restoreChain.rend(); ++it) {
+            tower.Push(history.GetBlock(*it));
+        }
+    }
+    historyTop = snapshot.top;
+
+    currentBlock = snapshot.currentBlock;
+    score = snapshot.score;
+    consecutivePerfects = snapshot.consecutivePerfects;
+    blockSpeed = snapshot.blockSpeed;
+    direction = snapshot.direction;
+    gameOver = snapshot.gameOver;
+}
+
+// Refill the tower with every block of the history tower `top` - O(height)
+void Simulation::RebuildTower(BlockHistory::NodeId top) {
+    restoreChain.clear();
+    for (BlockHistory::NodeId node = top; node != BlockHistory::EMPTY;
+         node = history.GetParent(node)) {
+        restoreChain.push_back(node);
+    }
+
+    tower.Clear();
+    rewriteFloor = 0;
+    for (auto it = restoreChain.rbegin(); it != restoreChain.rend(); ++it) {
+        tower.Push(history.GetBlock(*it));  // Compacts again as it goes
+    }
+}
+
+// QUEUE OPERATION: Peek(i) - O(1), nothing stored
+Block Simulation::GetUpcomingBlock(int ahead) const {
+    int index = tower.GetHeight() + 1 + ahead;  // Tower position it will take
+    int speedUps = GameRules::SpeedUpsThrough(index)
+                 - GameRules::SpeedUpsThrough(tower.GetHeight());
+    float width = tower.IsEmpty() ? INITIAL_BLOCK_WIDTH : tower.Top().rect.width;
+
+    return Block(0, 0, width, BLOCK_HEIGHT,
+                 sequence.GetColorIndex(static_cast<std::uint64_t>(index)),
+                 blockSpeed + speedUps * params.speedIncrement);
+}
+
+// QUEUE OPERATION: Dequeue - O(1). The front of the sequence is the block
+// for the next tower position, as wide as the current top.
+void Simulation::SpawnNextBlock() {
+    int index = tower.GetHeight();
+    float width = tower.IsEmpty() ? INITIAL_BLOCK_WIDTH : tower.Top().rect.width;
+    float yPos = SCREEN_HEIGHT - 100 - (index * BLOCK_HEIGHT);
+
+    currentBlock = Block(0, yPos, width, BLOCK_HEIGHT,
+                         sequence.GetColorIndex(static_cast<std::uint64_t>(index)), blockSpeed);
+    currentBlock.isMoving = true;
+}
+
+void Simulation::UpdateBlockMovement(float deltaTime) {
+    if (!currentBlock.isMoving) return;
+
+    currentBlock.rect.x += blockSpeed * direction * deltaTime;
+
+    if (currentBlock.GetRight() >= SCREEN_WIDTH) {
+        direction = -1;
+    } else if (currentBlock.GetLeft() <= 0) {
+        direction = 1;
+    }
+}
+
+bool Simulation::CheckOverlap(const Block& current, const Block& below,
+                              float& overlapStart, float& overlapEnd) {
+    float currentLeft = current.GetLeft();
+    float currentRight = current.GetRight();
+    float belowLeft = below.GetLeft();
+    float belowRight = below.GetRight();
+
+    overlapStart = std::max(currentLeft, belowLeft);
+    overlapEnd = std::min(currentRight, belowRight);
+
+    return overlapEnd > overlapStart;
+}
+
+void Simulation::TrimAndStackBlock(SimDelta& delta) {
+    if (tower.IsEmpty()) {
+        PushBlock(currentBlock);  // STACK: Push
+        score += GameRules::FIRST_BLOCK_POINTS;
+        delta.stacked = true;
+        delta.scoreGained = GameRules::FIRST_BLOCK_POINTS;
+        SpawnNextBlock();
+        return;
+    }
+
+    // STACK: Peek at top block for comparison
+    const Block& topBlock = tower.Top();  // O(1) operation
+    delta.dropOffset = currentBlock.GetLeft() - topBlock.GetLeft();
+
+    float overlapStart, overlapEnd;
+    if (!CheckOverlap(currentBlock, topBlock, overlapStart, overlapEnd)) {
+        gameOver = true;
+        delta.gameOver = true;
+        return;
+    }
+
+    float overlapWidth = overlapEnd - overlapStart;
+    float originalWidth = currentBlock.rect.width;
+
+    if (overlapWidth < originalWidth * params.minOverlapRatio) {
+        gameOver = true;
+        delta.gameOver = true;
+        return;
+    }
+
+    // Create trimmed block
+    Block trimmedBlock = currentBlock;
+    trimmedBlock.rect.x = overlapStart;
+    trimmedBlock.rect.width = overlapWidth;
+
+    // STACK: Push trimmed block onto tower
+    PushBlock(trimmedBlock);  // O(1) operation
+
+    // Calculate score
+    float accuracy = overlapWidth / originalWidth;
+    bool isPerfect = std::abs(overlapWidth - originalWidth) < params.perfectThreshold;
+
+    int gained;
+    if (isPerfect) {
+        consecutivePerfects++;
+        gained = GameRules::PerfectPoints(consecutivePerfects);
+    } else {
+        consecutivePerfects = 0;
+        gained = GameRules::AccuracyPoints(accuracy);
+    }
+    score += gained;
+
+    delta.stacked = true;
+    delta.perfect = isPerfect;
+    delta.scoreGained = gained;
+    delta.overlapRatio = accuracy;
+    delta.trimmedWidth = originalWidth - overlapWidth;
+    // The block is as wide as the top, so the overhang is on one side only
+    delta.trimmedX = currentBlock.GetLeft() < overlapStart ? currentBlock.GetLeft() : overlapEnd;
+
+    // Increase difficulty
+    if (GameRules::SpeedsUpAt(tower.GetHeight())) {
+        blockSpeed += params.speedIncrement;
+    }
+
+    SpawnNextBlock();
+}
+
+void Simulation::DropBlock(SimDelta& delta) {
+    if (!currentBlock.isMoving) return;
+    currentBlock.isMoving = false;
+    delta.dropped = true;
+    TrimAndStackBlock(delta);
+}
@@ -0,0 +1,209 @@
+/**
+ * Simulation - raylib-free game rules for Tower Builder
+ *
+ * The Game class (game.cpp) used to read the clock and the keyboard inside
+ * its own update, so a game could only run in real time. The rules now live
+ * here and are driven by plain data:
+ *
+ *     SimInput (delta time + drop flag)  ->  Step()  ->  SimDelta
+ *
+ * The interactive game turns raylib input into a SimInput each frame; the
+ * headless tools build SimInputs themselves and step as fast as the CPU
+ * allows.
+ */
+
+#pragma once
+
+#include "block.h"
+#include "block_history.h"
+#include "block_sequence.h"
+#include "tower.h"
+#include "rules.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Tunable rules, so batch tools can evaluate difficulty changes without
+ * recompiling. The defaults are the constants the game ships with; the
+ * shape of the scoring and speed curves is the compile-time GameRules
+ * policy (rules.h).
+ */
+struct SimParams {
+    static constexpr float INITIAL_SPEED = 150.0f;
+    static constexpr float SPEED_INCREMENT = 15.0f;
+    static constexpr float PERFECT_THRESHOLD = 5.0f;
+    static constexpr float MIN_OVERLAP_RATIO = 0.1f;
+
+    float initialSpeed = INITIAL_SPEED;        // Block speed at height 0 (px/s)
+    float speedIncrement = SPEED_INCREMENT;    // Added every SPEEDUP_INTERVAL blocks (px/s)
+    float perfectThreshold = PERFECT_THRESHOLD; // Max lost width for a perfect (px)
+    float minOverlapRatio = MIN_OVERLAP_RATIO; // Less overlap than this ends the game
+};
+
+/**
+ * Input for one simulation step
+ */
+struct SimInput {
+    float deltaTime = 0.0f;  // Seconds to advance the moving block
+    bool drop = false;       // Player pressed drop during this step
+
+    // Seconds into the step at which drop was pressed. The block is moved
+    // to where it was at that instant before it lands, and the next block
+    // gets the rest of the step. Negative (the default) drops at the end
+    // of the step, which is what the headless tools use.
+    float dropTime = -1.0f;
+};
+
+/**
+ * What changed during one simulation step
+ */
+struct SimDelta {
+    bool dropped = false;      // A drop was handled this step
+    bool stacked = false;      // The dropped block landed and was pushed
+    bool perfect = false;      // The landing was within the perfect threshold
+    bool gameOver = false;     // The drop missed and ended the game
+    int scoreGained = 0;       // Points awarded by this step
+    float trimmedWidth = 0.0f; // Overhang cut off the dropped block
+    float trimmedX = 0.0f;     // Left edge of that overhang (when trimmedWidth > 0)
+    float dropOffset = 0.0f;   // Dropped block's left edge minus the top's (px, 0 = dead on)
+    float overlapRatio = 0.0f; // Overlap / dropped block width when stacked, else 0
+};
+
+/**
+ * Simulation Class - Owns the tower, the upcoming block sequence and the rules
+ *
+ * Uses two of the game's data structures:
+ * 1. STACK - Tower of placed blocks
+ * 2. QUEUE - Upcoming blocks (FIFO), computed on demand from a seeded
+ *    BlockSequence instead of stored
+ *
+ * Never calls into raylib, so it can be stepped millions of times per
+ * second by the headless tools.
+ *
+ * With EnableHistory(true) every pushed block is also recorded in a
+ * persistent BlockHistory, so the whole game state fits in a small
+ * Snapshot: the id of the tower's top node plus the moving block and the
+ * handful of scalars the rules read. Taking one is O(1); restoring one
+ * pops and pushes only the blocks where the two towers differ. Practice
+ * mode builds undo/redo on this (see timeline.h).
+ */
+class Simulation {
+public:
+    // Game constants
+    static constexpr float BLOCK_HEIGHT = 30.0f;
+    static constexpr float INITIAL_BLOCK_WIDTH = 200.0f;
+    static constexpr float SCREEN_WIDTH = 800.0f;
+    static constexpr float SCREEN_HEIGHT = 600.0f;
+
+    // Bump whenever a change to the rules can change a game's outcome;
+    // replays recorded under another version are rejected.
+    // 2: a block spawns as wide as the top, not as the top was 3 drops ago
+    static constexpr std::uint32_t RULES_VERSION = 2;
+
+    /**
+     * Everything needed to put the game back exactly as it was. Valid
+     * until the next Reset() or EnableHistory() call.
+     */
+    struct Snapshot {
+        BlockHistory::NodeId top = BlockHistory::EMPTY;  // STACK: Tower as a history node
+        Block currentBlock;
+        int score = 0;
+        int consecutivePerfects = 0;
+        float blockSpeed = 0.0f;
+        int direction = 1;
+        bool gameOver = false;
+    };
+
+    // `seed` picks the block sequence (colours); 0 is the classic one
+    explicit Simulation(const SimParams& params = SimParams(), std::uint64_t seed = 0);
+
+    // Start a new game: base block, block sequence for `seed`, initial speed
+    void Reset(std::uint64_t seed = 0);
+
+    // Advance the moving block, then handle a drop if requested (at
+    // input.dropTime into the step if one is given)
+    SimDelta Step(const SimInput& input);
+
+    // Bound tower memory: keep only the newest `blocks` blocks (0 = all).
+    // The rules only read the top block, so outcomes are unchanged.
+    void SetTowerRetention(size_t blocks) { tower.SetRetention(blocks); }
+
+    // Record every pushed block so snapshots can be taken. Off by default:
+    // the history grows by one node per block. Call before Reset(); the
+    // history starts with the next game.
+    void EnableHistory(bool enabled) { historyEnabled = enabled; }
+    bool IsHistoryEnabled() const { return historyEnabled; }
+
+    // O(1). Requires EnableHistory(true) before the last Reset().
+    Snapshot TakeSnapshot() const;
+
+    // Return to `snapshot`. O(blocks that differ) while those are all
+    // retained; a restore reaching below the retained blocks rebuilds the
+    // tower, O(height).
+    void RestoreSnapshot(const Snapshot& snapshot);
+
+    // Lowest tower height restores have popped down to since the last
+    // call (the current height if none did); blocks from there up may have
+    // been replaced. For views that resend only the top of the tower.
+    int ConsumeRewriteFloor() {
+        int floor = std::min(rewriteFloor, tower.GetHeight());
+        rewriteFloor = std::numeric_limits<int>::max();
+        return floor;
+    }
+
+    const SimParams& GetParams() const { return params; }
+    const Tower& GetTower() const { return tower; }
+    const Block& GetCurrentBlock() const { return currentBlock; }
+    std::uint64_t GetSeed() const { return sequence.GetSeed(); }
+
+    // QUEUE: Peek at the block `ahead` places behind the moving one (0 =
+    // next) - O(1) at any depth. Computed as if every drop until then
+    // lands perfectly: as wide as the top is now, at the speed reached by
+    // then. Not positioned; it spawns at the left edge.
+    Block GetUpcomingBlock(int ahead) const;
+
+    bool IsGameOver() const { return gameOver; }
+    int GetScore() const { return score; }
+    int GetConsecutivePerfects() const { return consecutivePerfects; }
+    float GetBlockSpeed() const { return blockSpeed; }
+    int GetDirection() const { return direction; }
+
+    // Blocks stacked on the base block
+    int GetTowerHeight() const { return tower.GetHeight() - 1; }
+
+    // Horizontal overlap of two blocks; false if they do not overlap.
+    // Pure geometry, so tools and benchmarks can call it directly.
+    static bool CheckOverlap(const Block& current, const Block& below,
+                             float& overlapStart, float& overlapEnd);
+
+private:
+    SimParams params;
+
+    // Data Structures
+    Tower tower;                      // STACK: Main tower
+    BlockSequence sequence;           // QUEUE: Every upcoming block, on demand
+    BlockHistory history;             // STACK: Every tower this game, persistent
+    BlockHistory::NodeId historyTop = BlockHistory::EMPTY;  // `tower` as a history node
+    bool historyEnabled = false;
+    std::vector<BlockHistory::NodeId> restoreChain;  // Scratch for RestoreSnapshot
+    int rewriteFloor = std::numeric_limits<int>::max();  // See ConsumeRewriteFloor
+
+    // Game state
+    Block currentBlock;
+    bool gameOver;
+    int score;
+    int consecutivePerfects;
+    float blockSpeed;
+    int direction;  // 1 = right, -1 = left
+
+    void PushBlock(const Block& block);
+    void RebuildTower(BlockHistory::NodeId top);
+    void SpawnNextBlock();
+    void UpdateBlockMovement(float deltaTime);
+    void TrimAndStackBlock(SimDelta& delta);
+    void DropBlock(SimDelta& delta);
+};
@@ -0,0 +1,285 @@
+/**
+ * Spectator protocol - Live game state as compact deltas
+ * See spectator.h for the packet layout.
+ */
+
+#include "spectator.h"
+#include "byte_io.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr std::uint8_t FLAG_GAME_OVER = 1 << 0;
+constexpr std::uint8_t FLAG_MOVING_BLOCK = 1 << 1;
+constexpr std::uint8_t FLAG_CATCH_UP = 1 << 2;
+
+// Where the simulation puts the block at stack index `index`
+float StackY(std::uint64_t index) {
+    return Simulation::SCREEN_HEIGHT - 100 - static_cast<float>(index) * Simulation::BLOCK_HEIGHT;
+}
+
+std::int64_t QuantizePosition(float value) {
+    return static_cast<std::int64_t>(std::lround(value * SPECTATOR_POSITION_SCALE));
+}
+
+void PutBlock(std::vector<std::uint8_t>& bytes, const Block& block) {
+    PutVarint(bytes, ZigZagEncode(QuantizePosition(block.rect.x)));
+    std::int64_t width = std::max<std::int64_t>(0, QuantizePosition(block.rect.width));
+    PutVarint(bytes, static_cast<std::uint64_t>(width));
+    PutVarint(bytes, static_cast<std::uint64_t>(std::max(0, block.colorIndex)));
+}
+
+Block ReadBlock(ByteReader& reader, std::uint64_t index) {
+    float x = static_cast<float>(reader.SignedVarint()) / SPECTATOR_POSITION_SCALE;
+    float width = static_cast<float>(reader.Varint()) / SPECTATOR_POSITION_SCALE;
+    int colorIndex = static_cast<int>(reader.Varint() & 0x7FFFFFFF);
+
+    Block block(x, StackY(index), width, Simulation::BLOCK_HEIGHT, colorIndex, 0.0f);
+    block.isMoving = false;
+    return block;
+}
+
+bool SameBlock(const Block& a, const Block& b) {
+    return a.rect.x == b.rect.x && a.rect.width == b.rect.width && a.colorIndex == b.colorIndex;
+}
+
+}  // namespace
+
+// ============================================================================
+// SpectatorFeed
+// ============================================================================
+
+void SpectatorFeed::BeginGame() {
+    gameId++;
+    sentHeights.fill(0);
+    sentNext = 0;
+}
+
+void SpectatorFeed::MarkRewritten(std::uint64_t fromIndex) {
+    // Lowering every sample keeps the rewritten blocks in the window until
+    // REPEAT_PACKETS updates have sent them, like freshly pushed ones
+    for (std::uint64_t& sent : sentHeights) {
+        sent = std::min(sent, fromIndex);
+    }
+}
+
+const std::vector<std::uint8_t>& SpectatorFeed::EncodeUpdate(const Simulation& simulation,
+                                                             std::uint64_t tick) {
+    // Repeat every block pushed since the lowest height of the last
+    // REPEAT_PACKETS updates. Heights only grow in a normal game, so that
+    // is the oldest; after a rewind MarkRewritten has lowered it to cover
+    // blocks pushed in place of popped ones. The tower may be lower still,
+    // hence the min.
+    std::uint64_t height = static_cast<std::uint64_t>(simulation.GetTower().GetHeight());
+    std::uint64_t firstIndex = height;
+    for (std::uint64_t sent : sentHeights) {
+        firstIndex = std::min(firstIndex, sent);
+    }
+
+    sentHeights[sentNext] = height;
+    sentNext = (sentNext + 1) % REPEAT_PACKETS;
+
+    Encode(simulation, tick, firstIndex, false);
+    return packet;
+}
+
+const std::vector<std::uint8_t>& SpectatorFeed::EncodeCatchUp(const Simulation& simulation,
+                                                              std::uint64_t tick,
+                                                              std::uint64_t fromIndex) {
+    std::uint64_t height = static_cast<std::uint64_t>(simulation.GetTower().GetHeight());
+    Encode(simulation, tick, std::min(fromIndex, height), true);
+    return packet;
+}
+
+void SpectatorFeed::Encode(const Simulation& simulation, std::uint64_t tick,
+                           std::uint64_t firstIndex, bool catchUp) {
+    const Tower& tower = simulation.GetTower();
+    std::uint64_t compacted = static_cast<std::uint64_t>(tower.GetSummary().blockCount);
+    std::uint64_t height = static_cast<std::uint64_t>(tower.GetHeight());
+    // Only retained blocks can be sent, and at most a catch-up's worth;
+    // a spectator further behind resyncs
+    std::uint64_t lowest = height > MAX_CATCHUP_BLOCKS ? height - MAX_CATCHUP_BLOCKS : 0;
+    firstIndex = std::max(firstIndex, std::max(compacted, lowest));
+
+    bool moving = !simulation.IsGameOver() && simulation.GetCurrentBlock().isMoving;
+    std::uint8_t flags = (simulation.IsGameOver() ? FLAG_GAME_OVER : 0) |
+                         (moving ? FLAG_MOVING_BLOCK : 0) |
+                         (catchUp ? FLAG_CATCH_UP : 0);
+
+    packet.clear();
+    packet.push_back(SPECTATOR_STATE);
+    packet.push_back(SPECTATOR_PROTOCOL_VERSION);
+    packet.push_back(stream);
+    PutVarint(packet, gameId);
+    PutVarint(packet, tick);
+    packet.push_back(flags);
+
+    // STACK: The newest blocks, by absolute index
+    PutVarint(packet, firstIndex);
+    PutVarint(packet, height - firstIndex);
+    for (std::uint64_t index = firstIndex; index < height; index++) {
+        PutBlock(packet, tower.GetBlock(static_cast<std::size_t>(index - compacted)));
+    }
+
+    PutVarint(packet, static_cast<std::uint64_t>(std::max(0, simulation.GetScore())));
+    if (moving) {
+        PutBlock(packet, simulation.GetCurrentBlock());
+    }
+}
+
+// ============================================================================
+// SpectatorView
+// ============================================================================
+
+SpectatorView::SpectatorView(std::uint8_t stream) : stream(stream) {
+    tower.SetRetention(TOWER_RETAINED_BLOCKS);
+}
+
+void SpectatorView::Restart(std::uint64_t newBaseIndex) {
+    tower.Clear();
+    baseIndex = newBaseIndex;
+    revision++;
+}
+
+SpectatorView::ApplyResult SpectatorView::Apply(const std::uint8_t* data, std::size_t size) {
+    ByteReader reader{data, size};
+    if (reader.Fixed(1) != SPECTATOR_STATE || reader.Fixed(1) != SPECTATOR_PROTOCOL_VERSION ||
+        reader.Fixed(1) != stream) {
+        return ApplyResult::Ignored;
+    }
+
+    std::uint64_t packetGame = reader.Varint();
+    std::uint64_t packetTick = reader.Varint();
+    std::uint8_t flags = static_cast<std::uint8_t>(reader.Fixed(1));
+    std::uint64_t firstIndex = reader.Varint();
+    std::uint64_t count = reader.Varint();
+    if (!reader.ok || count > SpectatorFeed::MAX_CATCHUP_BLOCKS) return ApplyResult::Ignored;
+
+    bool newGame = !hasGame || packetGame != gameId;
+    if (newGame) {
+        hasGame = true;
+        gameId = packetGame;
+        tick = 0;
+        Restart(0);
+    }
+
+    // Decode into a scratch list first, so a truncated packet changes nothing
+    Block blocks[SpectatorFeed::MAX_CATCHUP_BLOCKS];
+    for (std::uint64_t i = 0; i < count; i++) {
+        blocks[i] = ReadBlock(reader, firstIndex + i);
+    }
+    std::uint64_t packetScore = reader.Varint();
+    Block moving;
+    bool hasMoving = (flags & FLAG_MOVING_BLOCK) != 0;
+    if (hasMoving) {
+        moving = ReadBlock(reader, firstIndex + count);
+        moving.isMoving = true;
+    }
+    if (!reader.ok) return ApplyResult::Ignored;
+
+    // A catch-up may start above what we have; it covers everything a
+    // screen needs, so start the mirror over at its first block. Any other
+    // packet past our top means blocks were lost.
+    bool current = newGame || packetTick >= tick;  // UDP may reorder packets
+    bool gap = firstIndex > GetHeight();
+    if (gap && (flags & FLAG_CATCH_UP) != 0) {
+        Restart(firstIndex);
+        gap = false;
+    } else if (!current) {
+        return ApplyResult::Ignored;  // Older than what we show
+    }
+
+    if (!gap) {
+        // STACK: Skip the blocks we already have, pop from the first one
+        // that differs (the server popped and pushed again) down, then push
+        // the rest. Repeats of known blocks change nothing.
+        std::uint64_t compacted =
+            baseIndex + static_cast<std::uint64_t>(tower.GetSummary().blockCount);
+        std::uint64_t start = std::max(firstIndex, compacted);
+        std::uint64_t end = firstIndex + count;
+        while (start < std::min(GetHeight(), end) &&
+               SameBlock(tower.GetBlock(static_cast<std::size_t>(start - compacted)),
+                         blocks[start - firstIndex])) {
+            start++;
+        }
+
+        if (GetHeight() > start || end > start) revision++;
+        while (GetHeight() > start) {
+            tower.Pop();
+        }
+        for (std::uint64_t index = start; index < end; index++) {
+            tower.Push(blocks[index - firstIndex]);
+        }
+    }
+
+    // Dynamic state: keep the newest. The moving block carries its own
+    // height, so it stays live even while blocks below it are missing.
+    if (current) {
+        tick = packetTick;
+        score = static_cast<int>(std::min<std::uint64_t>(packetScore, INT32_MAX));
+        gameOver = (flags & FLAG_GAME_OVER) != 0;
+        hasMovingBlock = hasMoving;
+        if (hasMoving) movingBlock = moving;
+    }
+
+    return gap ? ApplyResult::NeedsResync : ApplyResult::Applied;
+}
+
+// ============================================================================
+// Spectator -> server packets
+// ============================================================================
+
+std::vector<std::uint8_t> EncodeSpectatorCookie(std::uint64_t cookie) {
+    std::vector<std::uint8_t> bytes = {SPECTATOR_COOKIE, SPECTATOR_PROTOCOL_VERSION};
+    PutFixed(bytes, cookie, 8);
+    return bytes;
+}
+
+bool ParseSpectatorCookie(const std::uint8_t* data, std::size_t size, std::uint64_t& cookie) {
+    ByteReader reader{data, size};
+    if (reader.Fixed(1) != SPECTATOR_COOKIE || reader.Fixed(1) != SPECTATOR_PROTOCOL_VERSION) {
+        return false;
+    }
+    cookie = reader.Fixed(8);
+    return reader.ok;
+}
+
+std::vector<std::uint8_t> EncodeSpectatorHello(std::uint64_t cookie) {
+    std::vector<std::uint8_t> bytes = {SPECTATOR_HELLO, SPECTATOR_PROTOCOL_VERSION};
+    PutFixed(bytes, cookie, 8);
+    bytes.resize(SPECTATOR_MIN_HELLO, 0);  // Padding: never smaller than the cookie reply
+    return bytes;
+}
+
+std::vector<std::uint8_t> EncodeSpectatorResync(std::uint64_t cookie, std::uint8_t stream,
+                                                std::uint64_t fromIndex) {
+    std::vector<std::uint8_t> bytes = {SPECTATOR_RESYNC, SPECTATOR_PROTOCOL_VERSION};
+    PutFixed(bytes, cookie, 8);
+    bytes.push_back(stream);
+    PutVarint(bytes, fromIndex);
+    return bytes;
+}
+
+bool ParseSpectatorHello(const std::uint8_t* data, std::size_t size, std::uint64_t& cookie) {
+    if (size < SPECTATOR_MIN_HELLO) return false;
+    ByteReader reader{data, size};
+    if (reader.Fixed(1) != SPECTATOR_HELLO || reader.Fixed(1) != SPECTATOR_PROTOCOL_VERSION) {
+        return false;
+    }
+    cookie = reader.Fixed(8);
+    return reader.ok;
+}
+
+bool ParseSpectatorResync(const std::uint8_t* data, std::size_t size, std::uint64_t& cookie,
+                          std::uint8_t& stream, std::uint64_t& fromIndex) {
+    ByteReader reader{data, size};
+    if (reader.Fixed(1) != SPECTATOR_RESYNC || reader.Fixed(1) != SPECTATOR_PROTOCOL_VERSION) {
+        return false;
+    }
+    cookie = reader.Fixed(8);
+    stream = static_cast<std::uint8_t>(reader.Fixed(1));
+    fromIndex = reader.Varint();
+    return reader.ok;
+}
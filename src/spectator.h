@@ -0,0 +1,214 @@
+/**
+ * Spectator protocol - Live game state as compact deltas
+ *
+ * Tournament displays mirror live games. Shipping the whole tower every
+ * tick would cost kilobytes per packet; instead the server sends what
+ * changed since the spectator last heard from it:
+ *
+ * - the blocks pushed onto the STACK recently (usually none)
+ * - the moving block, the score and the game-over flag
+ *
+ * Positions are quantized to 1/8 px and every number is a varint, so an
+ * ordinary packet is about 20 bytes. The packet depends only on the game,
+ * never on the spectator, so it is encoded once and the same bytes go to
+ * every spectator of the game.
+ *
+ * WHY IT SURVIVES A LOSSY TRANSPORT (UDP)
+ * - Every packet carries the blocks pushed during the last
+ *   SpectatorFeed::REPEAT_PACKETS packets, so a lost packet or two costs
+ *   nothing
+ * - Blocks carry their absolute stack index. Applying them skips blocks
+ *   the spectator already has and pops down to the first one that differs,
+ *   so repeats, reordering and pops on the server (rewinds) all converge
+ * - A spectator that sees a gap asks for a catch-up: the same packet
+ *   with up to MAX_CATCHUP_BLOCKS top blocks, enough for any screen
+ *
+ * Packet layout (varint = LEB128 unsigned, svarint = zigzag varint):
+ *
+ *     u8      'S' state, 'C' cookie (server -> spectator),
+ *             'H' hello (spectator -> server, keep-alive),
+ *             'R' resync request (spectator -> server)
+ *     u8      SPECTATOR_PROTOCOL_VERSION
+ *
+ *   state:
+ *     u8      stream (player index)
+ *     varint  game id - changes whenever the server starts a new game
+ *     varint  tick
+ *     u8      flags: game over, moving block present, catch-up
+ *     varint  first block index, block count, then per block:
+ *             svarint x, varint width (1/8 px), varint colour index
+ *     varint  score
+ *     moving  svarint x, varint width, varint colour index (if flagged)
+ *
+ *   cookie:
+ *     u64     cookie for the address the hello came from
+ *
+ *   hello:
+ *     u64     the last cookie received (0 before the first), then zero
+ *             padding to SPECTATOR_MIN_HELLO bytes
+ *
+ *   resync:
+ *     u64     cookie
+ *     u8      stream
+ *     varint  first block index missing
+ *
+ * WHY COOKIES?
+ * - A UDP source address can be forged. If a bare hello registered its
+ *   address, one forged 2-byte datagram would aim a packet per frame at a
+ *   third party for SPECTATOR_TIMEOUT
+ * - So a hello without a valid cookie only earns a cookie reply, which is
+ *   never longer than the padded hello. The address is registered once a
+ *   hello echoes the cookie back, which proves it receives what is sent
+ *   to it. Resyncs carry the cookie too, so catch-ups can't be forged either
+ *
+ * The blocks in a state packet always end at the top of the tower, so
+ * first index + count is the tower height.
+ */
+
+#pragma once
+
+#include "simulation.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+constexpr std::uint8_t SPECTATOR_PROTOCOL_VERSION = 2;
+constexpr std::uint8_t SPECTATOR_STATE = 'S';
+constexpr std::uint8_t SPECTATOR_COOKIE = 'C';
+constexpr std::uint8_t SPECTATOR_HELLO = 'H';
+constexpr std::uint8_t SPECTATOR_RESYNC = 'R';
+
+constexpr std::size_t SPECTATOR_COOKIE_SIZE = 10;  // Type, version, u64
+constexpr std::size_t SPECTATOR_MIN_HELLO = 16;    // Longer than the cookie reply
+
+// Positions on the wire are in 1/SPECTATOR_POSITION_SCALE px
+constexpr float SPECTATOR_POSITION_SCALE = 8.0f;
+
+/**
+ * SpectatorFeed - Server side: encodes one game's state packets
+ *
+ * Time Complexity:
+ * - EncodeUpdate: O(blocks pushed or rewritten in the last REPEAT_PACKETS
+ *   packets)
+ * - EncodeCatchUp: O(MAX_CATCHUP_BLOCKS)
+ */
+class SpectatorFeed {
+public:
+    static constexpr int REPEAT_PACKETS = 4;            // Each push is sent this many times
+    static constexpr int MAX_CATCHUP_BLOCKS = 64;       // Two screens of blocks
+
+    explicit SpectatorFeed(std::uint8_t stream = 0) : stream(stream) {}
+
+    // A new game starts: spectators drop the old tower
+    void BeginGame();
+
+    // Blocks from `fromIndex` up were replaced (an undo or rewind), maybe
+    // at an unchanged height: resend them for the next REPEAT_PACKETS
+    // updates - O(REPEAT_PACKETS)
+    void MarkRewritten(std::uint64_t fromIndex);
+
+    // Broadcast packet for the current state. Call at the send rate (for
+    // example once per frame); the repeat window counts these calls.
+    const std::vector<std::uint8_t>& EncodeUpdate(const Simulation& simulation, std::uint64_t tick);
+
+    // Packet for one spectator that is missing blocks from `fromIndex` on
+    const std::vector<std::uint8_t>& EncodeCatchUp(const Simulation& simulation, std::uint64_t tick,
+                                                   std::uint64_t fromIndex);
+
+    std::uint8_t GetStream() const { return stream; }
+
+private:
+    std::uint8_t stream;
+    std::uint64_t gameId = 0;
+
+    // Tower heights at the last REPEAT_PACKETS updates, lowered by
+    // MarkRewritten; the lowest is where the next update's blocks start
+    std::array<std::uint64_t, REPEAT_PACKETS> sentHeights{};
+    int sentNext = 0;
+
+    std::vector<std::uint8_t> packet;
+
+    void Encode(const Simulation& simulation, std::uint64_t tick,
+                std::uint64_t firstIndex, bool catchUp);
+};
+
+/**
+ * SpectatorView - Spectator side: the mirrored game
+ *
+ * The mirrored tower is a real Tower, so it can be drawn with the same
+ * TowerRenderer as the game. Its first block may not be the base block
+ * when the spectator joined mid-game (see GetBaseIndex).
+ *
+ * Time Complexity:
+ * - Apply: O(blocks in the packet)
+ */
+class SpectatorView {
+public:
+    enum class ApplyResult {
+        Ignored,       // Not a state packet for this stream, or malformed
+        Applied,
+        NeedsResync    // Applied, but blocks are missing; send a resync
+    };
+
+    // Blocks kept by the mirrored tower; older ones are compacted away
+    static constexpr size_t TOWER_RETAINED_BLOCKS = 256;
+
+    explicit SpectatorView(std::uint8_t stream = 0);
+
+    ApplyResult Apply(const std::uint8_t* data, std::size_t size);
+
+    std::uint8_t GetStream() const { return stream; }
+    bool HasGame() const { return hasGame; }
+    std::uint64_t GetGameId() const { return gameId; }
+    std::uint64_t GetTick() const { return tick; }
+
+    // STACK: Mirrored tower and the absolute stack index of its first block
+    const Tower& GetTower() const { return tower; }
+    std::uint64_t GetBaseIndex() const { return baseIndex; }
+    std::uint64_t GetHeight() const { return baseIndex + tower.GetHeight(); }
+
+    bool HasMovingBlock() const { return hasMovingBlock; }
+    const Block& GetMovingBlock() const { return movingBlock; }
+    int GetScore() const { return score; }
+    bool IsGameOver() const { return gameOver; }
+
+    // First stack index the view is missing, for a resync request
+    std::uint64_t GetResyncIndex() const { return GetHeight(); }
+
+    // Bumped whenever the mirrored tower's blocks change, so a cached
+    // drawing of it knows to rebuild
+    std::uint64_t GetRevision() const { return revision; }
+
+private:
+    std::uint8_t stream;
+    bool hasGame = false;
+    std::uint64_t gameId = 0;
+    std::uint64_t tick = 0;
+
+    Tower tower;
+    std::uint64_t baseIndex = 0;
+    std::uint64_t revision = 0;
+
+    bool hasMovingBlock = false;
+    Block movingBlock;
+    int score = 0;
+    bool gameOver = false;
+
+    void Restart(std::uint64_t newBaseIndex);
+};
+
+// Server -> spectator address check
+std::vector<std::uint8_t> EncodeSpectatorCookie(std::uint64_t cookie);
+bool ParseSpectatorCookie(const std::uint8_t* data, std::size_t size, std::uint64_t& cookie);
+
+// Spectator -> server packets; `cookie` is the last one received, or 0
+std::vector<std::uint8_t> EncodeSpectatorHello(std::uint64_t cookie);
+std::vector<std::uint8_t> EncodeSpectatorResync(std::uint64_t cookie, std::uint8_t stream,
+                                                std::uint64_t fromIndex);
+
+// Decode a spectator -> server packet; false if it is not one of that type
+bool ParseSpectatorHello(const std::uint8_t* data, std::size_t size, std::uint64_t& cookie);
+bool ParseSpectatorResync(const std::uint8_t* data, std::size_t size, std::uint64_t& cookie,
+                          std::uint8_t& stream, std::uint64_t& fromIndex);
@@ -0,0 +1,183 @@
+/**
+ * Spectator transport - Broadcasts spectator packets over UDP
+ * See spectator_net.h for an overview.
+ */
+
+#include "spectator_net.h"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// Larger than any packet either side sends (a catch-up is < 1 KB)
+constexpr std::size_t DATAGRAM_CAPACITY = 2048;
+
+std::uint64_t RotateLeft(std::uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// SipHash-2-4 of two words: a keyed hash that, unlike a mixer such as
+// SplitMix64, can't be inverted to recover the key from cookies an
+// attacker requests for its own address
+std::uint64_t SipHash(const std::uint64_t key[2], std::uint64_t m0, std::uint64_t m1) {
+    std::uint64_t v0 = key[0] ^ 0x736F6D6570736575ull;
+    std::uint64_t v1 = key[1] ^ 0x646F72616E646F6Dull;
+    std::uint64_t v2 = key[0] ^ 0x6C7967656E657261ull;
+    std::uint64_t v3 = key[1] ^ 0x7465646279746573ull;
+    auto round = [&]() {
+        v0 += v1; v1 = RotateLeft(v1, 13); v1 ^= v0; v0 = RotateLeft(v0, 32);
+        v2 += v3; v3 = RotateLeft(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = RotateLeft(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = RotateLeft(v1, 17); v1 ^= v2; v2 = RotateLeft(v2, 32);
+    };
+    for (std::uint64_t m : {m0, m1, std::uint64_t{16} << 56}) {  // Last: the length block
+        v3 ^= m;
+        round();
+        round();
+        v0 ^= m;
+    }
+    v2 ^= 0xFF;
+    for (int i = 0; i < 4; i++) round();
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+std::uint64_t CookieEpoch(double now) {
+    return static_cast<std::uint64_t>(std::max(now, 0.0) / SpectatorServer::COOKIE_LIFETIME);
+}
+
+}  // namespace
+
+// ============================================================================
+// SpectatorServer
+// ============================================================================
+
+bool SpectatorServer::Open(std::uint16_t port) {
+    std::random_device device;
+    for (std::uint64_t& word : cookieKey) {
+        word = (static_cast<std::uint64_t>(device()) << 32) ^ device();
+    }
+    return socket.Open(port);
+}
+
+std::uint64_t SpectatorServer::MakeCookie(const UdpAddress& address, std::uint64_t epoch) const {
+    std::uint64_t where = (static_cast<std::uint64_t>(address.port) << 32) | address.ip;
+    std::uint64_t cookie = SipHash(cookieKey, where, epoch);
+    return cookie != 0 ? cookie : 1;  // 0 means "no cookie yet" on the wire
+}
+
+void SpectatorServer::SendCookie(const UdpAddress& address, std::uint64_t epoch) {
+    Send(address, EncodeSpectatorCookie(MakeCookie(address, epoch)));
+}
+
+void SpectatorServer::Poll(double now) {
+    resyncs.clear();
+
+    std::uint64_t epoch = CookieEpoch(now);
+    std::uint8_t buffer[DATAGRAM_CAPACITY];
+    UdpAddress address;
+    long size;
+    while ((size = socket.ReceiveFrom(address, buffer, sizeof(buffer))) >= 0) {
+        ResyncRequest request;
+        std::uint64_t cookie;
+        // This epoch's cookie or the previous one's, so a cookie handed out
+        // just before the epoch turned still works
+        auto isValid = [&](std::uint64_t value) {
+            return value == MakeCookie(address, epoch) ||
+                   (epoch > 0 && value == MakeCookie(address, epoch - 1));
+        };
+
+        if (ParseSpectatorHello(buffer, static_cast<std::size_t>(size), cookie)) {
+            // Without a valid cookie the hello only earns one, a reply no
+            // longer than the padded hello, so a forged hello amplifies
+            // nothing; registering needs the cookie sent to that address
+            if (isValid(cookie)) Register(address, now);
+            if (cookie != MakeCookie(address, epoch)) SendCookie(address, epoch);
+        } else if (ParseSpectatorResync(buffer, static_cast<std::size_t>(size), cookie,
+                                        request.stream, request.fromIndex)) {
+            // Catch-ups go only to registered spectators whose request
+            // carries their cookie, so they can't be aimed at anyone else
+            auto known = std::find_if(spectators.begin(), spectators.end(),
+                [&address](const Spectator& spectator) { return spectator.address == address; });
+            if (known != spectators.end() && isValid(cookie)) {
+                request.address = address;
+                resyncs.push_back(request);
+            }
+        }
+    }
+
+    spectators.erase(std::remove_if(spectators.begin(), spectators.end(),
+        [now](const Spectator& spectator) {
+            return now - spectator.lastHeard > SPECTATOR_TIMEOUT;
+        }), spectators.end());
+}
+
+void SpectatorServer::Register(const UdpAddress& address, double now) {
+    for (Spectator& spectator : spectators) {
+        if (spectator.address == address) {
+            spectator.lastHeard = now;
+            return;
+        }
+    }
+    if (static_cast<int>(spectators.size()) < MAX_SPECTATORS) {
+        spectators.push_back(Spectator{address, now});
+    }
+}
+
+void SpectatorServer::Broadcast(const std::vector<std::uint8_t>& packet) {
+    for (const Spectator& spectator : spectators) {
+        socket.SendTo(spectator.address, packet.data(), packet.size());
+    }
+}
+
+void SpectatorServer::Send(const UdpAddress& address, const std::vector<std::uint8_t>& packet) {
+    socket.SendTo(address, packet.data(), packet.size());
+}
+
+// ============================================================================
+// SpectatorClient
+// ============================================================================
+
+bool SpectatorClient::Connect(const char* host, std::uint16_t port) {
+    return ResolveUdpAddress(host, port, server) && socket.Open(0);
+}
+
+void SpectatorClient::Poll(double now, SpectatorView& view) {
+    if (!socket.IsOpen()) return;
+
+    bool needsResync = false;
+    bool helloDue = now - lastHello >= HELLO_INTERVAL;
+    std::uint8_t buffer[DATAGRAM_CAPACITY];
+    UdpAddress address;
+    long size;
+    while ((size = socket.ReceiveFrom(address, buffer, sizeof(buffer))) >= 0) {
+        if (!(address == server)) continue;
+
+        // Echo a new cookie right away; that hello registers us
+        std::uint64_t received;
+        if (ParseSpectatorCookie(buffer, static_cast<std::size_t>(size), received)) {
+            cookie = received;
+            helloDue = true;
+            continue;
+        }
+
+        SpectatorView::ApplyResult result = view.Apply(buffer, static_cast<std::size_t>(size));
+        if (result != SpectatorView::ApplyResult::Ignored) {
+            lastPacket = now;
+            needsResync = result == SpectatorView::ApplyResult::NeedsResync;
+        }
+    }
+
+    if (helloDue) {
+        std::vector<std::uint8_t> hello = EncodeSpectatorHello(cookie);
+        socket.SendTo(server, hello.data(), hello.size());
+        lastHello = now;
+    }
+
+    if (needsResync && now - lastResync >= RESYNC_INTERVAL) {
+        std::vector<std::uint8_t> resync = EncodeSpectatorResync(cookie, view.GetStream(),
+                                                                 view.GetResyncIndex());
+        socket.SendTo(server, resync.data(), resync.size());
+        lastResync = now;
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * Spectator transport - Broadcasts spectator packets over UDP
+ *
+ * SpectatorServer runs inside the game. Spectators register by sending a
+ * hello every HELLO_INTERVAL and are forgotten after SPECTATOR_TIMEOUT of
+ * silence. A hello only registers its address once it echoes the cookie
+ * the server sent there (see spectator.h), so a forged source address
+ * never gets the stream. Each published packet is encoded once (see spectator.h) and
+ * the same datagram is sent to every registered address, so a spectator
+ * costs one sendto of ~20 bytes per update and nothing else.
+ *
+ * SpectatorClient runs on the display. It keeps the registration alive,
+ * applies state packets to a SpectatorView and asks for a catch-up when
+ * the view reports missing blocks.
+ *
+ * Both sides are polled from the frame loop and never block.
+ *
+ * Time Complexity:
+ * - SpectatorServer::Broadcast: O(spectators) sends of one packet
+ * - SpectatorServer::Poll: O(datagrams received x spectators)
+ */
+
+#pragma once
+
+#include "spectator.h"
+#include "udp_socket.h"
+
+#include <cstdint>
+#include <vector>
+
+class SpectatorServer {
+public:
+    static constexpr std::uint16_t DEFAULT_PORT = 47800;
+    static constexpr int MAX_SPECTATORS = 1024;
+    static constexpr double SPECTATOR_TIMEOUT = 5.0;  // Seconds without a hello
+    static constexpr double COOKIE_LIFETIME = 60.0;   // A cookie is accepted for 1-2 of these
+
+    struct ResyncRequest {
+        UdpAddress address;
+        std::uint8_t stream;
+        std::uint64_t fromIndex;
+    };
+
+    // Bind `port` and draw a fresh cookie key
+    bool Open(std::uint16_t port);
+    bool IsOpen() const { return socket.IsOpen(); }
+
+    // Read pending datagrams: register hellos, queue resync requests and
+    // drop spectators that went quiet. `now` is in seconds.
+    void Poll(double now);
+
+    // Resync requests received by the last Poll; answer each with Send
+    const std::vector<ResyncRequest>& GetResyncRequests() const { return resyncs; }
+
+    // Send one packet to every spectator, or to one
+    void Broadcast(const std::vector<std::uint8_t>& packet);
+    void Send(const UdpAddress& address, const std::vector<std::uint8_t>& packet);
+
+    int GetSpectatorCount() const { return static_cast<int>(spectators.size()); }
+
+private:
+    struct Spectator {
+        UdpAddress address;
+        double lastHeard;
+    };
+
+    UdpSocket socket;
+    std::vector<Spectator> spectators;
+    std::vector<ResyncRequest> resyncs;
+    std::uint64_t cookieKey[2] = {0, 0};  // Random per Open; cookies can't be predicted
+
+    void Register(const UdpAddress& address, double now);
+
+    // Cookies are keyed hashes of (address, now / COOKIE_LIFETIME), so the
+    // server keeps no state for addresses that have not answered
+    std::uint64_t MakeCookie(const UdpAddress& address, std::uint64_t epoch) const;
+    void SendCookie(const UdpAddress& address, std::uint64_t epoch);
+};
+
+class SpectatorClient {
+public:
+    static constexpr double HELLO_INTERVAL = 1.0;   // Keep-alive period (seconds)
+    static constexpr double RESYNC_INTERVAL = 0.1;  // At most one catch-up request per this
+
+    // Resolve the server and bind a local port; false on failure
+    bool Connect(const char* host, std::uint16_t port);
+    bool IsConnected() const { return socket.IsOpen(); }
+
+    // Apply every pending packet to `view`, keep the registration alive
+    // and request a catch-up if blocks are missing. `now` is in seconds.
+    void Poll(double now, SpectatorView& view);
+
+    // Seconds since the last state packet was applied
+    double GetSilence(double now) const { return now - lastPacket; }
+
+private:
+    UdpSocket socket;
+    UdpAddress server;
+    std::uint64_t cookie = 0;  // From the server's last cookie packet
+    double lastHello = -HELLO_INTERVAL;
+    double lastResync = -RESYNC_INTERVAL;
+    double lastPacket = 0.0;
+};
@@ -0,0 +1,66 @@
+/**
+ * SpscRing - Lock-free single-producer / single-consumer QUEUE
+ *
+ * WHY LOCK-FREE?
+ * - The producer is the frame loop, which must never block on a consumer
+ *   (for example a thread writing samples to disk)
+ * - With exactly one producer and one consumer, each index is written by
+ *   one side only, so two atomics with acquire/release ordering are all
+ *   the synchronization needed
+ * - When the ring is full TryPush fails instead of waiting; the producer
+ *   decides whether to drop the item
+ *
+ * Layout: an inline power-of-two array and monotonically increasing
+ * indices wrapped with a mask.
+ *
+ * Time Complexity:
+ * - TryPush / TryPop: O(1), wait-free
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (and drops nothing) if the ring is full.
+    bool TryPush(const T& value) {
+        size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - readIndex.load(std::memory_order_acquire) == Capacity) return false;
+
+        items[head & MASK] = value;
+        writeIndex.store(head + 1, std::memory_order_release);  // Publish the item
+        return true;
+    }
+
+    // Consumer side. Returns false if the ring is empty.
+    bool TryPop(T& value) {
+        size_t tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == writeIndex.load(std::memory_order_acquire)) return false;
+
+        value = items[tail & MASK];
+        readIndex.store(tail + 1, std::memory_order_release);  // Hand the slot back
+        return true;
+    }
+
+    bool IsEmpty() const {
+        return readIndex.load(std::memory_order_acquire) ==
+               writeIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    std::array<T, Capacity> items{};
+
+    // Each index on its own cache line so producer and consumer don't
+    // false-share
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    alignas(64) std::atomic<size_t> readIndex{0};
+};
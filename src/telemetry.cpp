@@ -0,0 +1,323 @@
+/**
+ * Telemetry - Per-drop, per-game and frame-time metrics written to a
+ * columnar file by a background thread
+ * See telemetry.h for an overview.
+ */
+
+#include "telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+struct ColumnSpec {
+    char name[16];
+    TelemetryColumnType type;
+};
+
+std::size_t ColumnWidth(TelemetryColumnType type) {
+    return type == TelemetryColumnType::U64 ? 8 : 4;
+}
+
+// Column order is the order Telemetry::Append writes the fields in
+const ColumnSpec DROP_COLUMNS[] = {
+    {"game", TelemetryColumnType::U64},
+    {"player", TelemetryColumnType::U32},
+    {"tick", TelemetryColumnType::U32},
+    {"height", TelemetryColumnType::U32},
+    {"offset_px", TelemetryColumnType::F32},
+    {"overlap_ratio", TelemetryColumnType::F32},
+    {"time_to_drop_s", TelemetryColumnType::F32},
+    {"streak", TelemetryColumnType::U32},
+    {"flags", TelemetryColumnType::U32},
+};
+
+const ColumnSpec GAME_COLUMNS[] = {
+    {"game", TelemetryColumnType::U64},
+    {"player", TelemetryColumnType::U32},
+    {"ticks", TelemetryColumnType::U32},
+    {"score", TelemetryColumnType::I32},
+    {"height", TelemetryColumnType::U32},
+    {"drops", TelemetryColumnType::U32},
+    {"perfects", TelemetryColumnType::U32},
+    {"best_streak", TelemetryColumnType::U32},
+    {"flags", TelemetryColumnType::U32},
+};
+
+// seconds, frames, worst_ms, then one count column per bucket
+constexpr int FRAME_FIXED_COLUMNS = 3;
+ColumnSpec FRAME_COLUMNS[FRAME_FIXED_COLUMNS + TELEMETRY_FRAME_BUCKETS] = {
+    {"seconds", TelemetryColumnType::F32},
+    {"frames", TelemetryColumnType::U32},
+    {"worst_ms", TelemetryColumnType::F32},
+};
+
+// "ge_" + up to 6 digits + "ms" fits ColumnSpec::name with room to spare
+static_assert(TELEMETRY_FRAME_EDGES_MS[TELEMETRY_FRAME_BUCKETS - 2] < 1e6f,
+              "frame bucket edges must stay below 1e6 ms to fit their column names");
+
+// "lt_1ms", "lt_2ms", ... "ge_100ms", from TELEMETRY_FRAME_EDGES_MS
+void NameFrameBuckets() {
+    for (int b = 0; b < TELEMETRY_FRAME_BUCKETS; b++) {
+        ColumnSpec& spec = FRAME_COLUMNS[FRAME_FIXED_COLUMNS + b];
+        bool open = b == TELEMETRY_FRAME_BUCKETS - 1;
+        unsigned edge = static_cast<unsigned>(TELEMETRY_FRAME_EDGES_MS[open ? b - 1 : b]);
+        std::snprintf(spec.name, sizeof(spec.name), "%s_%ums", open ? "ge" : "lt", edge);
+        spec.type = TelemetryColumnType::U32;
+    }
+}
+
+void GetSchema(TelemetryKind kind, const ColumnSpec*& specs, std::size_t& count) {
+    specs = nullptr;
+    count = 0;
+    switch (kind) {
+    case TelemetryKind::Drop:
+        specs = DROP_COLUMNS;
+        count = sizeof(DROP_COLUMNS) / sizeof(DROP_COLUMNS[0]);
+        break;
+    case TelemetryKind::Game:
+        specs = GAME_COLUMNS;
+        count = sizeof(GAME_COLUMNS) / sizeof(GAME_COLUMNS[0]);
+        break;
+    case TelemetryKind::Frames:
+        specs = FRAME_COLUMNS;
+        count = sizeof(FRAME_COLUMNS) / sizeof(FRAME_COLUMNS[0]);
+        break;
+    }
+}
+
+template <typename T>
+void Put(std::vector<std::uint8_t>& column, T value) {
+    std::uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    column.insert(column.end(), bytes, bytes + sizeof(T));
+}
+
+}  // namespace
+
+thread_local Telemetry::Channel* Telemetry::threadChannel = nullptr;
+
+Telemetry& Telemetry::Get() {
+    static Telemetry telemetry;
+    return telemetry;
+}
+
+void Telemetry::AttachThread() {
+    if (threadChannel != nullptr) return;
+    std::lock_guard<std::mutex> lock(channelsMutex);
+    channels.push_back(std::make_unique<Channel>());
+    threadChannel = channels.back().get();
+}
+
+std::uint64_t Telemetry::GetDroppedEvents() const {
+    std::lock_guard<std::mutex> lock(channelsMutex);
+    std::uint64_t dropped = 0;
+    for (const auto& channel : channels) {
+        dropped += channel->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+// ============================================================================
+// RECORDING (hot path)
+// ============================================================================
+
+void Telemetry::Push(const TelemetryEvent& event) {
+    Channel* channel = threadChannel;
+    if (channel == nullptr || !Get().IsRunning()) return;
+
+    // QUEUE: Hand the event to the writer thread; never wait for it
+    if (!channel->ring.TryPush(event)) {
+        channel->dropped.store(channel->dropped.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+    }
+}
+
+void Telemetry::RecordDrop(const TelemetryDrop& drop) {
+    TelemetryEvent event;
+    event.kind = TelemetryKind::Drop;
+    event.drop = drop;
+    Push(event);
+}
+
+void Telemetry::RecordGame(const TelemetryGame& game) {
+    TelemetryEvent event;
+    event.kind = TelemetryKind::Game;
+    event.game = game;
+    Push(event);
+}
+
+void Telemetry::RecordFrame(double frameSeconds) {
+    Channel* channel = threadChannel;
+    if (channel == nullptr || !Get().IsRunning()) return;
+
+    TelemetryFrames& frames = channel->frames;
+    float ms = static_cast<float>(frameSeconds * 1000.0);
+    const float* edges = TELEMETRY_FRAME_EDGES_MS;
+    const float* bucketEdge = std::upper_bound(edges, edges + TELEMETRY_FRAME_BUCKETS - 1, ms);
+    int bucket = static_cast<int>(bucketEdge - edges);
+    frames.counts[bucket]++;
+    frames.frames++;
+    frames.worstMs = std::max(frames.worstMs, ms);
+
+    channel->periodSeconds += frameSeconds;
+    if (channel->periodSeconds < HISTOGRAM_SECONDS) return;
+
+    // One event per period, then start the next histogram
+    channel->totalSeconds += channel->periodSeconds;
+    channel->periodSeconds = 0.0;
+    frames.seconds = static_cast<float>(channel->totalSeconds);
+
+    TelemetryEvent event;
+    event.kind = TelemetryKind::Frames;
+    event.frames = frames;
+    Push(event);
+    frames = TelemetryFrames{};
+}
+
+// ============================================================================
+// WRITER THREAD
+// ============================================================================
+
+bool Telemetry::Start(const char* path) {
+    if (IsRunning()) return true;
+
+    file = std::fopen(path, "wb");
+    if (file == nullptr) return false;
+
+    std::uint32_t header[2] = {MAGIC, VERSION};
+    std::fwrite(header, sizeof(header), 1, file);
+
+    NameFrameBuckets();
+    for (ColumnBlock* block : {&drops, &games, &frames}) {
+        const ColumnSpec* specs;
+        std::size_t count;
+        GetSchema(block->kind, specs, count);
+        block->rows = 0;
+        block->columns.assign(count, std::vector<std::uint8_t>());
+        for (std::size_t c = 0; c < count; c++) {
+            block->columns[c].reserve(BLOCK_ROWS * ColumnWidth(specs[c].type));
+        }
+    }
+
+    writtenEvents.store(0, std::memory_order_relaxed);
+    writerStop.store(false);
+    running.store(true, std::memory_order_release);
+    writer = std::thread(&Telemetry::WriterLoop, this);
+    return true;
+}
+
+void Telemetry::Stop() {
+    if (!running.exchange(false)) return;
+
+    writerStop.store(true);
+    writer.join();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void Telemetry::WriterLoop() {
+    auto lastFlush = std::chrono::steady_clock::now();
+    TelemetryEvent event;
+
+    for (;;) {
+        // Check the flag before draining, so events pushed before Stop are kept
+        bool stopping = writerStop.load();
+        {
+            std::lock_guard<std::mutex> lock(channelsMutex);
+            for (const auto& channel : channels) {
+                while (channel->ring.TryPop(event)) Append(event);
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (stopping || now - lastFlush >= std::chrono::duration<double>(FLUSH_SECONDS)) {
+            WriteBlock(drops);
+            WriteBlock(games);
+            WriteBlock(frames);
+            std::fflush(file);
+            lastFlush = now;
+        }
+        if (stopping) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+void Telemetry::Append(const TelemetryEvent& event) {
+    ColumnBlock* block = nullptr;
+    switch (event.kind) {
+    case TelemetryKind::Drop: {
+        block = &drops;
+        const TelemetryDrop& drop = event.drop;
+        std::vector<std::vector<std::uint8_t>>& c = drops.columns;
+        Put(c[0], drop.game);
+        Put(c[1], drop.player);
+        Put(c[2], drop.tick);
+        Put(c[3], drop.height);
+        Put(c[4], drop.offset);
+        Put(c[5], drop.overlapRatio);
+        Put(c[6], drop.timeToDrop);
+        Put(c[7], drop.streak);
+        Put(c[8], drop.flags);
+        break;
+    }
+    case TelemetryKind::Game: {
+        block = &games;
+        const TelemetryGame& game = event.game;
+        std::vector<std::vector<std::uint8_t>>& c = games.columns;
+        Put(c[0], game.game);
+        Put(c[1], game.player);
+        Put(c[2], game.ticks);
+        Put(c[3], game.score);
+        Put(c[4], game.height);
+        Put(c[5], game.drops);
+        Put(c[6], game.perfects);
+        Put(c[7], game.bestStreak);
+        Put(c[8], game.flags);
+        break;
+    }
+    case TelemetryKind::Frames: {
+        block = &frames;
+        const TelemetryFrames& histogram = event.frames;
+        std::vector<std::vector<std::uint8_t>>& c = frames.columns;
+        Put(c[0], histogram.seconds);
+        Put(c[1], histogram.frames);
+        Put(c[2], histogram.worstMs);
+        for (int b = 0; b < TELEMETRY_FRAME_BUCKETS; b++) {
+            Put(c[FRAME_FIXED_COLUMNS + b], histogram.counts[b]);
+        }
+        break;
+    }
+    }
+    if (block == nullptr) return;
+
+    block->rows++;
+    writtenEvents.fetch_add(1, std::memory_order_relaxed);
+    if (block->rows == BLOCK_ROWS) WriteBlock(*block);
+}
+
+void Telemetry::WriteBlock(ColumnBlock& block) {
+    if (block.rows == 0) return;
+
+    const ColumnSpec* specs;
+    std::size_t count;
+    GetSchema(block.kind, specs, count);
+
+    std::uint32_t header[3] = {static_cast<std::uint32_t>(block.kind), block.rows,
+                               static_cast<std::uint32_t>(count)};
+    std::fwrite(header, sizeof(header), 1, file);
+    for (std::size_t c = 0; c < count; c++) {
+        std::fwrite(specs[c].name, sizeof(specs[c].name), 1, file);
+        std::uint32_t type = static_cast<std::uint32_t>(specs[c].type);
+        std::fwrite(&type, sizeof(type), 1, file);
+    }
+
+    // Column after column: each one is a contiguous array in the file
+    for (std::vector<std::uint8_t>& column : block.columns) {
+        std::fwrite(column.data(), 1, column.size(), file);
+        column.clear();
+    }
+    block.rows = 0;
+}
@@ -0,0 +1,195 @@
+/**
+ * Telemetry - Per-drop, per-game and frame-time metrics written to a
+ * columnar file by a background thread
+ *
+ * The game records, for every drop, how far it landed from the top block,
+ * the overlap ratio, how long the block moved before the press and the
+ * perfect streak; for every game, its result; and, every second, a
+ * histogram of frame times. Recording is a thread-local ring push:
+ *
+ *     game thread  --Record*-->  thread's SpscRing  -->  writer thread
+ *                  (no lock, no allocation)              column blocks, file
+ *
+ * WHY THREAD-LOCAL RINGS?
+ * - Each recording thread owns its ring (allocated once, by AttachThread),
+ *   so the push is the wait-free SpscRing push with no shared lock; a
+ *   thread that never attached, or telemetry that is off, costs one branch
+ * - A full ring drops the event and counts it instead of waiting: the
+ *   frame budget wins over completeness
+ * - Frame times go into a histogram kept in the same thread-local state;
+ *   only one event per HISTOGRAM_SECONDS reaches the ring
+ *
+ * WHY COLUMNAR?
+ * - The writer gathers each event kind into per-column arrays and writes
+ *   BLOCK_ROWS rows (or whatever a second brought) as one block, column
+ *   after column; analysis reads "every overlap ratio" as one contiguous
+ *   array (numpy.frombuffer, Arrow, ...) without parsing rows
+ * - Blocks describe their own columns, so readers need no schema and old
+ *   files stay readable when a column is added
+ *
+ * File layout (native endianness, little-endian on every shipped target):
+ *
+ *     u32 magic "TBTM", u32 version
+ *     block*: u32 kind (TelemetryKind), u32 rows, u32 columns,
+ *             columns x { char name[16], u32 type (TelemetryColumnType) },
+ *             then each column's rows x width bytes, in schema order
+ *
+ * Time Complexity:
+ * - RecordDrop / RecordGame: O(1), wait-free
+ * - RecordFrame: O(log FRAME_BUCKETS), plus an O(1) push once a second
+ * - Writer: O(events) per flush, one fwrite per column
+ */
+
+#pragma once
+
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class TelemetryKind : std::uint32_t {
+    Drop = 1,
+    Game = 2,
+    Frames = 3,
+};
+
+enum class TelemetryColumnType : std::uint32_t {
+    U32 = 0,
+    I32 = 1,
+    F32 = 2,
+    U64 = 3,
+};
+
+// TelemetryDrop::flags
+constexpr std::uint32_t TELEMETRY_PERFECT = 1u << 0;
+constexpr std::uint32_t TELEMETRY_GAME_OVER = 1u << 1;   // The drop missed
+constexpr std::uint32_t TELEMETRY_BOT = 1u << 2;
+constexpr std::uint32_t TELEMETRY_PRACTICE = 1u << 3;
+
+struct TelemetryDrop {
+    std::uint64_t game;         // Match seed, shared by the match's players
+    std::uint32_t player;
+    std::uint32_t tick;         // Simulation tick the drop landed on
+    std::uint32_t height;       // Tower height after the drop
+    float offset;               // Left edge minus the top block's, px
+    float overlapRatio;         // 0 on a miss
+    float timeToDrop;           // Seconds the block moved before the press
+    std::uint32_t streak;       // Consecutive perfects after the drop
+    std::uint32_t flags;        // TELEMETRY_* bits
+};
+
+struct TelemetryGame {
+    std::uint64_t game;
+    std::uint32_t player;
+    std::uint32_t ticks;
+    std::int32_t score;
+    std::uint32_t height;
+    std::uint32_t drops;
+    std::uint32_t perfects;
+    std::uint32_t bestStreak;
+    std::uint32_t flags;        // TELEMETRY_BOT / TELEMETRY_PRACTICE
+};
+
+// Upper bounds (ms) of the frame-time buckets; the last bucket is open
+constexpr int TELEMETRY_FRAME_BUCKETS = 16;
+constexpr float TELEMETRY_FRAME_EDGES_MS[TELEMETRY_FRAME_BUCKETS - 1] = {
+    1, 2, 4, 8, 12, 14, 15, 16, 17, 18, 20, 25, 33, 50, 100
+};
+
+struct TelemetryFrames {
+    float seconds;              // Since Start(), at the end of the period
+    std::uint32_t frames;
+    float worstMs;
+    std::uint32_t counts[TELEMETRY_FRAME_BUCKETS];
+};
+
+struct TelemetryEvent {
+    TelemetryKind kind;
+    union {
+        TelemetryDrop drop;
+        TelemetryGame game;
+        TelemetryFrames frames;
+    };
+};
+
+class Telemetry {
+public:
+    static constexpr std::uint32_t MAGIC = 0x4D544254;  // "TBTM"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t RING_CAPACITY = 4096;  // Events in flight per thread
+    static constexpr std::size_t BLOCK_ROWS = 4096;     // Rows per block, at most
+    static constexpr double HISTOGRAM_SECONDS = 1.0;    // Frame time summed per histogram
+    static constexpr double FLUSH_SECONDS = 1.0;        // Partial blocks wait at most this
+
+    static Telemetry& Get();
+
+    ~Telemetry() { Stop(); }
+
+    // Open `path` and start the writer thread; false on I/O error
+    bool Start(const char* path);
+
+    // Write whatever is queued and close the file
+    void Stop();
+    bool IsRunning() const { return running.load(std::memory_order_relaxed); }
+
+    // Give the calling thread its ring. Allocates; call once per thread,
+    // before its loop, to make its Record* calls count.
+    void AttachThread();
+
+    // Hot path: no lock, no allocation; dropped (and counted) when the
+    // thread's ring is full, ignored when telemetry is off
+    static void RecordDrop(const TelemetryDrop& drop);
+    static void RecordGame(const TelemetryGame& game);
+    static void RecordFrame(double frameSeconds);
+
+    std::uint64_t GetDroppedEvents() const;
+    std::uint64_t GetWrittenEvents() const { return writtenEvents.load(std::memory_order_relaxed); }
+
+private:
+    // One recording thread's state
+    struct Channel {
+        SpscRing<TelemetryEvent, RING_CAPACITY> ring;
+        std::atomic<std::uint64_t> dropped{0};  // Written by the recording thread only
+
+        // Frame histogram of the current period, recording thread only
+        TelemetryFrames frames{};
+        double periodSeconds = 0.0;
+        double totalSeconds = 0.0;
+    };
+
+    // Writer-side rows of one event kind, one byte array per column
+    struct ColumnBlock {
+        TelemetryKind kind;
+        std::uint32_t rows = 0;
+        std::vector<std::vector<std::uint8_t>> columns;
+    };
+
+    Telemetry() = default;
+
+    std::atomic<bool> running{false};
+    std::FILE* file = nullptr;
+    std::thread writer;
+    std::atomic<bool> writerStop{false};
+    std::atomic<std::uint64_t> writtenEvents{0};
+
+    static thread_local Channel* threadChannel;  // nullptr until AttachThread
+
+    mutable std::mutex channelsMutex;  // Attach and the writer only; never the hot path
+    std::vector<std::unique_ptr<Channel>> channels;
+
+    ColumnBlock drops{TelemetryKind::Drop, 0, {}};
+    ColumnBlock games{TelemetryKind::Game, 0, {}};
+    ColumnBlock frames{TelemetryKind::Frames, 0, {}};
+
+    static void Push(const TelemetryEvent& event);
+
+    void WriterLoop();
+    void Append(const TelemetryEvent& event);
+    void WriteBlock(ColumnBlock& block);
+};
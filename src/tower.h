@@ -0,0 +1,240 @@
+/**
+ * Tower - STACK of placed blocks, shared by the game and the simulation
+ */
+
+#pragma once
+
+#include "block.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+/**
+ * What is left of blocks compacted out of the tower
+ */
+struct TowerSummary {
+    int blockCount = 0;      // Blocks folded into the summary
+    float top = 0.0f;        // Top edge of the highest compacted block
+    float minLeft = 0.0f;    // Horizontal extent of the compacted blocks
+    float maxRight = 0.0f;
+    double widthSum = 0.0;   // For the mean width of the compacted part
+
+    void Add(const Block& block) {
+        if (blockCount == 0) {
+            minLeft = block.GetLeft();
+            maxRight = block.GetRight();
+        } else {
+            minLeft = std::min(minLeft, block.GetLeft());
+            maxRight = std::max(maxRight, block.GetRight());
+        }
+        top = block.GetTop();
+        widthSum += block.rect.width;
+        blockCount++;
+    }
+};
+
+/**
+ * Tower Class - Demonstrates STACK Data Structure
+ *
+ * WHY STACK?
+ * - Blocks are stacked on top of each other (LIFO - Last In, First Out)
+ * - The most recently placed block is at the top
+ * - We only interact with the top block for comparison
+ * - Natural fit for a tower building game
+ *
+ * WHY A VECTOR UNDERNEATH?
+ * - A stack only needs push/pop/top at one end, which std::vector does in O(1)
+ * - Contiguous storage lets us iterate the tower directly for drawing,
+ *   without copying it into a temporary container every frame
+ * - Block i sits one BLOCK_HEIGHT above block i - 1, so the on-screen
+ *   slice is found by arithmetic instead of visiting every block
+ *
+ * WHY PACKED BLOCKS?
+ * - Every block is stored as a 6-byte PackedBlock (see block.h); the row
+ *   of block i is derived from the first block's y and height
+ * - The top block is also kept as a full Block, since the rules compare
+ *   against it. Pop leaves the packed copy of the block below as the new
+ *   top; Simulation restores undone towers by pushing, not popping, back
+ *   to an exact top.
+ * - GetBlock(i) rebuilds a Block on demand; iteration yields Blocks by value
+ *
+ * WHY RETENTION?
+ * - A long game can stack tens of thousands of blocks, but the rules only
+ *   look at the top and the screen only shows the last few dozen
+ * - With SetRetention(n), blocks more than n below the top are folded into
+ *   a TowerSummary, so memory stays bounded however tall the tower grows
+ * - GetHeight() still counts every block; GetBlock(), begin()/end(),
+ *   VisibleRange, IsEmpty() and Top() only cover the retained ones. Popping
+ *   down to the compacted part leaves IsEmpty() true with GetHeight() > 0,
+ *   so check IsEmpty() before Top(), not the height.
+ *
+ * Time Complexity:
+ * - Push: O(1) amortized - Add block to top (compaction included)
+ * - Pop: O(1) - Remove block from top
+ * - Peek: O(1) - View top block
+ * - VisibleRange: O(1) - Find blocks inside a vertical window
+ */
+
+class Tower {
+private:
+    std::vector<PackedBlock> blocks;  // STACK: back() is the top of the tower
+    Block topBlock;                   // Full-precision copy of blocks.back(), or Block()
+    float baseY = 0.0f;               // Row of block 0 and the height of every row
+    float blockHeight = 0.0f;
+    size_t retention = 0;             // 0 = keep every block, else newest blocks kept
+    TowerSummary summary;             // Blocks compacted out of `blocks`
+
+    /**
+     * Fold the oldest blocks into the summary once twice the retention is
+     * stored. Erasing `retention` blocks at a time keeps the vector shift
+     * amortized O(1) per push.
+     */
+    void Compact() {
+        if (retention == 0 || blocks.size() < retention * 2) return;
+
+        size_t removed = blocks.size() - retention;
+        size_t firstRow = static_cast<size_t>(summary.blockCount);
+        for (size_t i = 0; i < removed; i++) {
+            summary.Add(blocks[i].Unpack(RowTop(firstRow + i), blockHeight));
+        }
+        blocks.erase(blocks.begin(), blocks.begin() + removed);
+    }
+
+public:
+    /**
+     * A view over a contiguous run of retained tower blocks (bottom to
+     * top), by retained index. Iterating it decodes each Block; nothing is
+     * copied up front. Invalidated by Push/Pop/Clear.
+     */
+    struct BlockRange {
+        const Tower* tower;
+        size_t first;
+        size_t last;
+
+        struct Iterator {
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Block;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Block;
+
+            const Tower* tower;
+            size_t index;
+
+            Block operator*() const { return tower->GetBlock(index); }
+            Iterator& operator++() { index++; return *this; }
+            bool operator==(const Iterator& other) const { return index == other.index; }
+            bool operator!=(const Iterator& other) const { return index != other.index; }
+        };
+
+        Iterator begin() const { return Iterator{tower, first}; }
+        Iterator end() const { return Iterator{tower, last}; }
+        bool empty() const { return first == last; }
+        size_t size() const { return last - first; }
+    };
+
+    Tower() = default;
+
+    // STACK OPERATION: Push - O(1) amortized
+    void Push(const Block& block) {
+        if (GetHeight() == 0) {
+            baseY = block.rect.y;
+            blockHeight = block.rect.height;
+        }
+        blocks.push_back(PackedBlock::Pack(block));  // LIFO: Last block in is on top
+        topBlock = block;
+        Compact();
+    }
+
+    // STACK OPERATION: Pop - O(1). Compacted blocks cannot be popped.
+    void Pop() {
+        if (blocks.empty()) return;
+        blocks.pop_back();
+        topBlock = blocks.empty() ? Block() : GetBlock(blocks.size() - 1);
+    }
+
+    // STACK OPERATION: Top - O(1). Only meaningful while !IsEmpty(); an
+    // empty tower returns a zero-sized Block().
+    const Block& Top() const { return topBlock; }
+
+    // STACK OPERATION: IsEmpty - O(1). No retained blocks; compacted ones
+    // may remain below (see GetHeight).
+    bool IsEmpty() const { return blocks.empty(); }
+
+    // Every block ever pushed and not popped, compacted ones included
+    int GetHeight() const { return summary.blockCount + static_cast<int>(blocks.size()); }
+
+    /**
+     * Keep only the newest `count` blocks in memory (0 = keep all). Takes
+     * effect on the next Push; must be at least 1 so Top() stays valid.
+     */
+    void SetRetention(size_t count) { retention = count; }
+    size_t GetRetention() const { return retention; }
+
+    const TowerSummary& GetSummary() const { return summary; }
+
+    // Blocks still stored, i.e. the span of begin()/end()
+    size_t GetRetainedCount() const { return blocks.size(); }
+
+    // Retained block `index` (0 = lowest retained) as a settled Block - O(1)
+    Block GetBlock(size_t index) const {
+        return blocks[index].Unpack(GetRowTop(index), blockHeight);
+    }
+
+    // Top edge of retained block `index`, whether or not it exists yet
+    float GetRowTop(size_t index) const {
+        return RowTop(static_cast<size_t>(summary.blockCount) + index);
+    }
+
+    // Direct iteration over the retained blocks, lowest to the top block
+    BlockRange::Iterator begin() const { return BlockRange::Iterator{this, 0}; }
+    BlockRange::Iterator end() const { return BlockRange::Iterator{this, blocks.size()}; }
+
+    /**
+     * Blocks that intersect the vertical window [top, bottom] - O(1)
+     *
+     * Rows go up by blockHeight from the base, so the first row at or above
+     * `bottom` and the first row wholly above `top` follow from a division.
+     * The estimate is then nudged onto the exact boundaries, which keeps
+     * the same edge rules as comparing every block.
+     */
+    BlockRange VisibleRange(float top, float bottom) const {
+        size_t count = blocks.size();
+        if (count == 0) return BlockRange{this, 0, 0};
+
+        auto belowWindow = [this, bottom](size_t i) { return GetRowTop(i) > bottom; };
+        auto inWindow = [this, top](size_t i) { return GetRowTop(i) + blockHeight >= top; };
+
+        size_t first = EstimateRow(bottom, count);
+        while (first > 0 && !belowWindow(first - 1)) first--;
+        while (first < count && belowWindow(first)) first++;
+
+        size_t last = std::max(first, EstimateRow(top - blockHeight, count));
+        while (last > first && !inWindow(last - 1)) last--;
+        while (last < count && inWindow(last)) last++;
+
+        return BlockRange{this, first, last};
+    }
+
+    // Keeps the allocated capacity so a restarted game does not reallocate
+    void Clear() {
+        blocks.clear();
+        topBlock = Block();
+        summary = TowerSummary();
+    }
+
+private:
+    // Top edge of the block at stack position `row`, compacted ones included
+    float RowTop(size_t row) const {
+        return baseY - static_cast<float>(row) * blockHeight;
+    }
+
+    // Retained index of the row whose top edge is nearest `y`, clamped
+    size_t EstimateRow(float y, size_t count) const {
+        float row = (baseY - y) / blockHeight - static_cast<float>(summary.blockCount);
+        if (!(row > 0.0f)) return 0;
+        return std::min(count, static_cast<size_t>(row));
+    }
+};
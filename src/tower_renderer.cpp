@@ -0,0 +1,156 @@
+/**
+ * TowerRenderer - Draws the settled tower as one batched submission
+ * See tower_renderer.h for an overview.
+ */
+
+#include "tower_renderer.h"
+#include "palette.h"
+
+#include "raylib.h"
+#include "rlgl.h"
+
+#include <algorithm>
+
+bool TowerRenderer::Sync(const Tower& tower) {
+    size_t compacted = static_cast<size_t>(tower.GetSummary().blockCount);
+    size_t retained = tower.GetRetainedCount();
+    if (compacted == cachedCompacted && retained == cachedBlocks) return false;
+
+    // Blocks compacted out of the tower leave the front of the cache
+    if (compacted != cachedCompacted) {
+        // Fewer compacted blocks than before means the tower was cleared and
+        // regrown, so nothing in the cache is still valid
+        size_t dropped = compacted > cachedCompacted
+            ? std::min(compacted - cachedCompacted, cachedBlocks)
+            : cachedBlocks;
+        vertices.erase(vertices.begin(),
+                       vertices.begin() + dropped * VERTICES_PER_BLOCK);
+        cachedBlocks -= dropped;
+        cachedCompacted = compacted;
+    }
+
+    // STACK: Pops only ever remove from the top, so drop trailing blocks
+    if (cachedBlocks > retained) {
+        cachedBlocks = retained;
+        vertices.resize(cachedBlocks * VERTICES_PER_BLOCK);
+    }
+
+    // STACK: Pushes only ever add at the top, so append the new blocks
+    for (size_t i = cachedBlocks; i < retained; i++) {
+        AppendBlock(tower.GetBlock(i));
+    }
+    cachedBlocks = retained;
+    return true;
+}
+
+void TowerRenderer::AppendBlock(const Block& block) {
+    size_t offset = vertices.size();
+    vertices.resize(offset + VERTICES_PER_BLOCK);
+    BuildBlockVertices(block, vertices.data() + offset);
+}
+
+void TowerRenderer::BuildBlockVertices(const Block& block, Vertex* out) {
+    const BlockRect& rect = block.rect;
+    Color fill = GetBlockColor(block.colorIndex);
+    Color outline = BLACK;
+
+    // Same clamping as DrawRectangleLinesEx for blocks thinner than the outline
+    float thick = OUTLINE_THICKNESS;
+    if (thick > rect.width || thick > rect.height) {
+        if (rect.width > rect.height) {
+            thick = rect.height / 2;
+        } else if (rect.width < rect.height) {
+            thick = rect.width / 2;
+        }
+    }
+
+    // Quad corners in rlgl's RL_QUADS order: top-left, bottom-left,
+    // bottom-right, top-right
+    auto appendQuad = [&out](float x, float y, float width, float height, Color color) {
+        *out++ = Vertex{x, y, color.r, color.g, color.b, color.a};
+        *out++ = Vertex{x, y + height, color.r, color.g, color.b, color.a};
+        *out++ = Vertex{x + width, y + height, color.r, color.g, color.b, color.a};
+        *out++ = Vertex{x + width, y, color.r, color.g, color.b, color.a};
+    };
+
+    appendQuad(rect.x, rect.y, rect.width, rect.height, fill);
+    appendQuad(rect.x, rect.y, rect.width, thick, outline);                        // Top
+    appendQuad(rect.x, rect.y + rect.height - thick, rect.width, thick, outline);  // Bottom
+    appendQuad(rect.x, rect.y + thick, thick, rect.height - thick * 2, outline);   // Left
+    appendQuad(rect.x + rect.width - thick, rect.y + thick,
+               thick, rect.height - thick * 2, outline);                           // Right
+}
+
+void TowerRenderer::StreamVertices(const Vertex* vertex, const Vertex* end,
+                                   float top, float bottom, const ViewTransform& view) {
+    rlCheckRenderBatchLimit(static_cast<int>(end - vertex));
+    rlBegin(RL_QUADS);
+    for (; vertex != end; ++vertex) {
+        // Clamping y clips the axis-aligned quad to the viewport's rows
+        float y = std::clamp(vertex->y, top, bottom);
+        rlColor4ub(vertex->r, vertex->g, vertex->b, vertex->a);
+        rlVertex2f(vertex->x * view.scale + view.offsetX, y * view.scale + view.offsetY);
+    }
+    rlEnd();
+}
+
+void TowerRenderer::Draw(const Tower& tower, float top, float bottom,
+                         const ViewTransform& view) const {
+    Tower::BlockRange visible = tower.VisibleRange(top, bottom);
+    size_t first = visible.first;
+    size_t last = std::min(visible.last, cachedBlocks);
+    if (first >= last) return;
+
+    // Stream in chunks that fit rlgl's vertex batch; consecutive chunks with
+    // the same mode and texture are merged into one draw call by rlgl
+    constexpr size_t BLOCKS_PER_CHUNK = 256;
+
+    for (size_t chunkStart = first; chunkStart < last; chunkStart += BLOCKS_PER_CHUNK) {
+        size_t chunkEnd = std::min(chunkStart + BLOCKS_PER_CHUNK, last);
+        StreamVertices(vertices.data() + chunkStart * VERTICES_PER_BLOCK,
+                       vertices.data() + chunkEnd * VERTICES_PER_BLOCK, top, bottom, view);
+    }
+}
+
+void TowerRenderer::DrawBlock(const Block& block, float top, float bottom,
+                              const ViewTransform& view) {
+    Vertex blockVertices[VERTICES_PER_BLOCK];
+    BuildBlockVertices(block, blockVertices);
+    StreamVertices(blockVertices, blockVertices + VERTICES_PER_BLOCK, top, bottom, view);
+}
+
+void TowerRenderer::DrawParticles(const ParticleSystem& particles, float top, float bottom,
+                                  const ViewTransform& view) {
+    const float* xs = particles.GetX();
+    const float* ys = particles.GetY();
+    const float* sizes = particles.GetSize();
+    const std::uint32_t* colors = particles.GetColor();
+    size_t count = particles.GetCount();
+
+    constexpr size_t PARTICLES_PER_CHUNK = 1024;
+
+    for (size_t chunkStart = 0; chunkStart < count; chunkStart += PARTICLES_PER_CHUNK) {
+        size_t chunkEnd = std::min(chunkStart + PARTICLES_PER_CHUNK, count);
+        rlCheckRenderBatchLimit(static_cast<int>((chunkEnd - chunkStart) * 4));
+        rlBegin(RL_QUADS);
+        for (size_t i = chunkStart; i < chunkEnd; i++) {
+            std::uint32_t rgba = colors[i];
+            float alpha = static_cast<float>(rgba & 0xFF) * particles.GetLifeFraction(i);
+            rlColor4ub(static_cast<unsigned char>(rgba >> 24),
+                       static_cast<unsigned char>(rgba >> 16),
+                       static_cast<unsigned char>(rgba >> 8),
+                       static_cast<unsigned char>(alpha));
+
+            // Same y clamping as StreamVertices: squares are axis-aligned
+            float left = xs[i] * view.scale + view.offsetX;
+            float right = (xs[i] + sizes[i]) * view.scale + view.offsetX;
+            float y0 = std::clamp(ys[i], top, bottom) * view.scale + view.offsetY;
+            float y1 = std::clamp(ys[i] + sizes[i], top, bottom) * view.scale + view.offsetY;
+            rlVertex2f(left, y0);
+            rlVertex2f(left, y1);
+            rlVertex2f(right, y1);
+            rlVertex2f(right, y0);
+        }
+        rlEnd();
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * TowerRenderer - Draws the settled tower as one batched submission
+ *
+ * WHY BATCH?
+ * - Drawing a block as DrawRectangleRec + DrawRectangleLinesEx costs five
+ *   shape calls per block per frame, each recomputing its corners
+ * - The settled blocks never move, so their quads (one fill + four
+ *   outline bands) are built once and kept in a vertex cache
+ * - The tower only changes at the top, so the cache is updated
+ *   incrementally: a push appends one block's quads, a pop drops them,
+ *   and blocks compacted out of the tower (see Tower::SetRetention) are
+ *   dropped from the front
+ *
+ * Each frame the quads of the on-screen blocks (found with
+ * Tower::VisibleRange) are streamed to rlgl in a single
+ * rlBegin(RL_QUADS) pass, which raylib submits as one draw call.
+ *
+ * WHY TRANSFORM ON THE CPU?
+ * - Split-screen draws up to four towers, each in its own viewport
+ * - Switching the camera matrix or scissor rectangle per viewport would
+ *   flush rlgl's batch, i.e. one draw call per player
+ * - Instead each vertex is mapped through a ViewTransform and clipped to
+ *   its viewport as it is streamed; blocks are axis-aligned flat-colour
+ *   quads, so clamping y is exact clipping. Every tower then lands in the
+ *   same vertex batch and four players cost one draw call, like one
+ *
+ * Time Complexity:
+ * - Sync: O(blocks pushed or popped since the last Sync), plus an
+ *   O(retained) shift when the tower compacts
+ * - Draw: O(visible blocks); Tower::VisibleRange is O(1), found from the
+ *   row-height estimate instead of a search
+ */
+
+#pragma once
+
+#include "particle_system.h"
+#include "tower.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * World -> screen mapping of one viewport: screen = world * scale + offset
+ */
+struct ViewTransform {
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+    float scale = 1.0f;
+};
+
+class TowerRenderer {
+public:
+    // Outline thickness, matching DrawRectangleLinesEx(rect, 2.0f, BLACK)
+    static constexpr float OUTLINE_THICKNESS = 2.0f;
+
+    // Bring the vertex cache up to date with the tower. Appends quads for
+    // new blocks and drops quads for popped ones. Returns true if anything
+    // changed, so callers caching the drawn result know to redraw it.
+    bool Sync(const Tower& tower);
+
+    // Forget every cached block; call when blocks below the top change
+    // without a matching Pop (restart, rewind)
+    void Invalidate() { vertices.clear(); cachedBlocks = 0; cachedCompacted = 0; }
+
+    // Draw cached blocks intersecting the world rows [top, bottom], clipped
+    // to them and mapped through `view`, in one batched pass
+    void Draw(const Tower& tower, float top, float bottom, const ViewTransform& view) const;
+
+    // Same for a single uncached block (the moving one). Consecutive calls
+    // share the batch with each other and with Draw.
+    static void DrawBlock(const Block& block, float top, float bottom, const ViewTransform& view);
+
+    // Every live particle as a flat square, faded by its remaining life,
+    // in the same batch as the blocks
+    static void DrawParticles(const ParticleSystem& particles, float top, float bottom,
+                              const ViewTransform& view);
+
+    size_t GetCachedBlockCount() const { return cachedBlocks; }
+
+private:
+    struct Vertex {
+        float x, y;
+        unsigned char r, g, b, a;
+    };
+
+    static constexpr size_t QUADS_PER_BLOCK = 5;               // Fill + 4 outline bands
+    static constexpr size_t VERTICES_PER_BLOCK = QUADS_PER_BLOCK * 4;
+
+    std::vector<Vertex> vertices;  // VERTICES_PER_BLOCK per cached block
+    size_t cachedBlocks = 0;       // Retained tower blocks in the cache
+    size_t cachedCompacted = 0;    // Tower blocks compacted away at last Sync
+
+    void AppendBlock(const Block& block);
+
+    // Fill `out` with a block's VERTICES_PER_BLOCK vertices, in world space
+    static void BuildBlockVertices(const Block& block, Vertex* out);
+
+    static void StreamVertices(const Vertex* vertex, const Vertex* end,
+                               float top, float bottom, const ViewTransform& view);
+};
@@ -0,0 +1,613 @@
+/**
+ * Tower Builder - Difficulty auto-tuner (TowerBuilderTune)
+ *
+ * Searches the SimParams difficulty constants (initial speed, speed
+ * increment, perfect threshold, minimum overlap) for the values that give
+ * a target median tower height under a simulated player.
+ *
+ * Every parameter tuple is scored by playing --games seeded games on the
+ * SIMD BatchSimulation, spread with the batch runner's work-stealing pool
+ * over (tuple, group of lanes) jobs, so one tuple or hundreds keep every
+ * core busy. Every tuple plays the same seeds (the ones TowerBuilderSim
+ * plays for --seed), so differences between tuples are the parameters,
+ * not luck.
+ *
+ * Search:
+ * - grid:   every combination of the given ranges
+ * - refine: a grid, then finer grids centred on the best tuple so far,
+ *           until the median hits the target or --rounds grids have run
+ *
+ * Results go to a cache file (--cache), one line per tuple, keyed by the
+ * tuple and a hash of everything else that decides the outcome (rules
+ * version, games, seed, policy, tick rate). Reruns, refine rounds that
+ * revisit a point and overlapping sweeps only play tuples not seen yet.
+ *
+ * Across machines, --shard I/N plays only every N-th grid tuple starting
+ * at I. Shards write ordinary cache lines, so concatenating the shards'
+ * cache files and rerunning without --shard reports the full sweep.
+ *
+ * Usage:
+ *   TowerBuilderTune [--target-median H] [--search grid|refine] [--rounds N]
+ *                    [--initial-speed MIN[:MAX:N]] [--speed-increment MIN[:MAX:N]]
+ *                    [--perfect-threshold MIN[:MAX:N]] [--min-overlap MIN[:MAX:N]]
+ *                    [--games N] [--seed S] [--threads N] [--lanes N]
+ *                    [--policy fixed|gaussian|reaction|predictive] [--offset PX] [--sigma PX]
+ *                    [--reaction-ms MS] [--reaction-sd-ms MS] [--anticipation-ms MS]
+ *                    [--tick-rate HZ] [--max-ticks N]
+ *                    [--cache FILE] [--no-cache] [--shard I/N] [--top N]
+ */
+
+#include "batch_simulation.h"
+#include "drop_policy.h"
+#include "simulation.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace {
+
+// ============================================================================
+// Parameters
+// ============================================================================
+
+constexpr int PARAM_COUNT = 4;
+using ParamTuple = std::array<float, PARAM_COUNT>;
+
+constexpr const char* PARAM_NAMES[PARAM_COUNT] = {
+    "initial-speed", "speed-increment", "perfect-threshold", "min-overlap"
+};
+
+SimParams ToSimParams(const ParamTuple& tuple) {
+    SimParams params;
+    params.initialSpeed = tuple[0];
+    params.speedIncrement = tuple[1];
+    params.perfectThreshold = tuple[2];
+    params.minOverlapRatio = tuple[3];
+    return params;
+}
+
+// `count` evenly spaced values from min to max (just min when count is 1)
+struct ParamRange {
+    float min;
+    float max;
+    int count;
+
+    float GetValue(int index) const {
+        if (count <= 1) return min;
+        return min + (max - min) * static_cast<float>(index) / static_cast<float>(count - 1);
+    }
+    float GetStep() const { return count > 1 ? (max - min) / (count - 1) : 0.0f; }
+};
+
+enum class SearchKind {
+    Grid,
+    Refine
+};
+
+struct TuneOptions {
+    // Search
+    SearchKind search = SearchKind::Grid;
+    int rounds = 4;
+    double targetMedian = -1.0;     // Negative = no target, just report
+    std::array<ParamRange, PARAM_COUNT> ranges = {{
+        {SimParams::INITIAL_SPEED, SimParams::INITIAL_SPEED, 1},
+        {SimParams::SPEED_INCREMENT, SimParams::SPEED_INCREMENT, 1},
+        {SimParams::PERFECT_THRESHOLD, SimParams::PERFECT_THRESHOLD, 1},
+        {SimParams::MIN_OVERLAP_RATIO, SimParams::MIN_OVERLAP_RATIO, 1}
+    }};
+
+    // Evaluation of one tuple - the same knobs as TowerBuilderSim
+    long long games = 2000;
+    std::uint64_t seed = 1;
+    unsigned threads = 0;           // 0 = all hardware threads
+    int lanes = 256;                // Games per BatchSimulation
+    float tickRate = 240.0f;
+    long long maxTicks = 1000000;   // Per-game cap; easy tuples would run for hours
+    DropPolicyConfig policy;
+
+    // Incremental reruns and sharding
+    const char* cachePath = "tune_cache.txt";  // nullptr = --no-cache
+    int shardIndex = 0;
+    int shardCount = 1;
+    int top = 10;                   // Result rows printed
+};
+
+// What a tuple's games came to
+struct TuneResult {
+    int heightP10;
+    int heightP50;
+    int heightP90;
+    double heightMean;
+    double scoreMean;
+};
+
+// ============================================================================
+// Options
+// ============================================================================
+
+void PrintUsage(const char* program) {
+    std::printf(
+        "Usage: %s [--target-median H] [--search grid|refine] [--rounds N]\n"
+        "          [--initial-speed MIN[:MAX:N]] [--speed-increment MIN[:MAX:N]]\n"
+        "          [--perfect-threshold MIN[:MAX:N]] [--min-overlap MIN[:MAX:N]]\n"
+        "          [--games N] [--seed S] [--threads N] [--lanes N]\n"
+        "          [--policy fixed|gaussian|reaction|predictive] [--offset PX] [--sigma PX]\n"
+        "          [--reaction-ms MS] [--reaction-sd-ms MS] [--anticipation-ms MS]\n"
+        "          [--tick-rate HZ] [--max-ticks N]\n"
+        "          [--cache FILE] [--no-cache] [--shard I/N] [--top N]\n",
+        program);
+}
+
+// "V" or "MIN:MAX:N"
+bool ParseRange(const char* value, ParamRange& range) {
+    float min, max;
+    int count;
+    if (std::sscanf(value, "%f:%f:%d", &min, &max, &count) == 3) {
+        if (count < 1 || max < min) return false;
+        range = ParamRange{min, max, count};
+        return true;
+    }
+    if (std::sscanf(value, "%f", &min) == 1) {
+        range = ParamRange{min, min, 1};
+        return true;
+    }
+    return false;
+}
+
+bool ParseOptions(int argc, char** argv, TuneOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto asFloat = [&]() { return static_cast<float>(std::atof(value)); };
+
+        int param = -1;
+        for (int p = 0; p < PARAM_COUNT; p++) {
+            if (std::strncmp(arg, "--", 2) == 0 && std::strcmp(arg + 2, PARAM_NAMES[p]) == 0) {
+                param = p;
+            }
+        }
+
+        if (std::strcmp(arg, "--help") == 0) {
+            return false;
+        } else if (std::strcmp(arg, "--no-cache") == 0) {
+            options.cachePath = nullptr;
+            continue;
+        } else if (value == nullptr) {
+            std::fprintf(stderr, "Missing value for %s\n", arg);
+            return false;
+        } else if (param >= 0) {
+            if (!ParseRange(value, options.ranges[param])) {
+                std::fprintf(stderr, "Bad range %s for %s (want V or MIN:MAX:N)\n", value, arg);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--target-median") == 0) {
+            options.targetMedian = std::atof(value);
+        } else if (std::strcmp(arg, "--search") == 0) {
+            if (std::strcmp(value, "grid") == 0) {
+                options.search = SearchKind::Grid;
+            } else if (std::strcmp(value, "refine") == 0) {
+                options.search = SearchKind::Refine;
+            } else {
+                std::fprintf(stderr, "Unknown search %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--rounds") == 0) {
+            options.rounds = std::atoi(value);
+        } else if (std::strcmp(arg, "--games") == 0) {
+            options.games = std::atoll(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strcmp(arg, "--lanes") == 0) {
+            options.lanes = std::atoi(value);
+        } else if (std::strcmp(arg, "--policy") == 0) {
+            if (!ParseDropPolicyKind(value, options.policy.kind)) {
+                std::fprintf(stderr, "Unknown policy %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--offset") == 0) {
+            options.policy.offset = asFloat();
+        } else if (std::strcmp(arg, "--sigma") == 0) {
+            options.policy.jitterSigma = asFloat();
+        } else if (std::strcmp(arg, "--reaction-ms") == 0) {
+            options.policy.reactionMeanMs = asFloat();
+        } else if (std::strcmp(arg, "--reaction-sd-ms") == 0) {
+            options.policy.reactionSdMs = asFloat();
+        } else if (std::strcmp(arg, "--anticipation-ms") == 0) {
+            options.policy.anticipationMs = asFloat();
+        } else if (std::strcmp(arg, "--tick-rate") == 0) {
+            options.tickRate = asFloat();
+        } else if (std::strcmp(arg, "--max-ticks") == 0) {
+            options.maxTicks = std::atoll(value);
+        } else if (std::strcmp(arg, "--cache") == 0) {
+            options.cachePath = value;
+        } else if (std::strcmp(arg, "--shard") == 0) {
+            if (std::sscanf(value, "%d/%d", &options.shardIndex, &options.shardCount) != 2 ||
+                options.shardCount < 1 || options.shardIndex < 0 ||
+                options.shardIndex >= options.shardCount) {
+                std::fprintf(stderr, "Bad shard %s (want I/N with 0 <= I < N)\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--top") == 0) {
+            options.top = std::atoi(value);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+        i++;
+    }
+
+    if (options.search == SearchKind::Refine && options.targetMedian < 0.0) {
+        std::fprintf(stderr, "--search refine needs --target-median\n");
+        return false;
+    }
+    // A refine round depends on the best tuple of the last, which needs
+    // every shard's results
+    if (options.shardCount > 1 && options.search != SearchKind::Grid) {
+        std::fprintf(stderr, "--shard requires --search grid\n");
+        return false;
+    }
+    if (options.ranges[0].min <= 0.0f || options.ranges[3].min < 0.0f ||
+        options.ranges[3].max >= 1.0f) {
+        std::fprintf(stderr, "initial-speed must be > 0 and min-overlap in [0, 1)\n");
+        return false;
+    }
+    return options.games > 0 && options.tickRate > 0.0f && options.maxTicks > 0 &&
+           options.lanes > 0 && options.rounds > 0;
+}
+
+// ============================================================================
+// Result cache
+// ============================================================================
+
+/**
+ * Everything besides the tuple that decides a result. Cache lines written
+ * under other settings (or other rules) are kept in the file but ignored.
+ */
+std::uint64_t HashEvaluationConfig(const TuneOptions& options) {
+    char config[512];
+    std::snprintf(config, sizeof(config),
+                  "rules=%u games=%lld seed=%llu tick=%.9g max=%lld "
+                  "policy=%d,%.9g,%.9g,%.9g,%.9g,%.9g",
+                  static_cast<unsigned>(Simulation::RULES_VERSION), options.games,
+                  static_cast<unsigned long long>(options.seed), options.tickRate,
+                  options.maxTicks, static_cast<int>(options.policy.kind),
+                  options.policy.offset, options.policy.jitterSigma,
+                  options.policy.reactionMeanMs, options.policy.reactionSdMs,
+                  options.policy.anticipationMs);
+
+    // FNV-1a
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char* c = config; *c != '\0'; c++) {
+        hash = (hash ^ static_cast<unsigned char>(*c)) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+/**
+ * ResultCache - Append-only text file of finished tuples
+ *
+ * One line per tuple: config hash, the four parameters (%.9g, which reads
+ * back to the same float) and the result. Lines are flushed as tuples
+ * finish, so an interrupted sweep keeps what it played.
+ *
+ * Time Complexity:
+ * - Find / Add: O(log tuples)
+ */
+class ResultCache {
+public:
+    ~ResultCache() {
+        if (file != nullptr) std::fclose(file);
+    }
+
+    bool Open(const char* path, std::uint64_t configHash) {
+        hash = configHash;
+
+        if (FILE* existing = std::fopen(path, "r")) {
+            char line[512];
+            while (std::fgets(line, sizeof(line), existing) != nullptr) {
+                unsigned long long lineHash;
+                ParamTuple tuple;
+                TuneResult result;
+                if (std::sscanf(line, "%llx %f %f %f %f %d %d %d %lf %lf", &lineHash,
+                                &tuple[0], &tuple[1], &tuple[2], &tuple[3],
+                                &result.heightP10, &result.heightP50, &result.heightP90,
+                                &result.heightMean, &result.scoreMean) == 10 &&
+                    lineHash == hash) {
+                    results[ToKey(tuple)] = result;
+                }
+            }
+            std::fclose(existing);
+        }
+
+        file = std::fopen(path, "a");
+        return file != nullptr;
+    }
+
+    const TuneResult* Find(const ParamTuple& tuple) const {
+        auto found = results.find(ToKey(tuple));
+        return found != results.end() ? &found->second : nullptr;
+    }
+
+    void Add(const ParamTuple& tuple, const TuneResult& result) {
+        results[ToKey(tuple)] = result;
+        if (file == nullptr) return;
+        std::fprintf(file, "%016llx %.9g %.9g %.9g %.9g %d %d %d %.4f %.4f\n",
+                     static_cast<unsigned long long>(hash),
+                     tuple[0], tuple[1], tuple[2], tuple[3],
+                     result.heightP10, result.heightP50, result.heightP90,
+                     result.heightMean, result.scoreMean);
+        std::fflush(file);
+    }
+
+    size_t GetSize() const { return results.size(); }
+
+private:
+    // Bit patterns, so -0.0f and 0.0f or NaNs can't confuse the ordering
+    using Key = std::array<std::uint32_t, PARAM_COUNT>;
+
+    static Key ToKey(const ParamTuple& tuple) {
+        Key key;
+        std::memcpy(key.data(), tuple.data(), sizeof(key));
+        return key;
+    }
+
+    std::uint64_t hash = 0;
+    std::map<Key, TuneResult> results;
+    FILE* file = nullptr;
+};
+
+// ============================================================================
+// Evaluation
+// ============================================================================
+
+// Plays games [firstGame, firstGame + count) of one tuple as lanes of one
+// BatchSimulation, writing each game's height and score to its slot
+void PlayGroup(const TuneOptions& options, const SimParams& params, long long firstGame,
+               int count, int* heights, int* scores) {
+    BatchSimulation batch(count, params);
+    std::vector<DropPolicy> policies;
+    policies.reserve(count);
+    for (int lane = 0; lane < count; lane++) {
+        policies.emplace_back(options.policy, GameSeed(options.seed, firstGame + lane));
+        policies[lane].BeginBlock(batch.GetCurrentX(lane), batch.GetCurrentWidth(lane),
+                                  batch.GetTopX(lane), batch.GetBlockSpeed(lane),
+                                  batch.GetDirection(lane));
+    }
+
+    const float deltaTime = 1.0f / options.tickRate;
+    for (long long tick = 0; batch.GetLiveLaneCount() > 0 && tick < options.maxTicks; tick++) {
+        for (int lane = 0; lane < count; lane++) {
+            if (!batch.IsGameOver(lane) &&
+                policies[lane].ShouldDrop(batch.GetCurrentX(lane), deltaTime)) {
+                batch.RequestDrop(lane);
+            }
+        }
+
+        batch.Step(deltaTime);
+
+        for (int lane = 0; lane < count; lane++) {
+            if (batch.StackedLastStep(lane)) {
+                policies[lane].BeginBlock(batch.GetCurrentX(lane), batch.GetCurrentWidth(lane),
+                                          batch.GetTopX(lane), batch.GetBlockSpeed(lane),
+                                          batch.GetDirection(lane));
+            }
+        }
+    }
+
+    // Games still running at --max-ticks count with what they reached
+    for (int lane = 0; lane < count; lane++) {
+        heights[lane] = batch.GetTowerHeight(lane);
+        scores[lane] = batch.GetScore(lane);
+    }
+}
+
+// Nearest-rank percentile of an already sorted vector (as TowerBuilderSim)
+int Percentile(const std::vector<int>& sorted, double fraction) {
+    size_t rank = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+TuneResult Summarize(std::vector<int>& heights, const std::vector<int>& scores) {
+    std::sort(heights.begin(), heights.end());
+    double heightSum = 0, scoreSum = 0;
+    for (int height : heights) heightSum += height;
+    for (int score : scores) scoreSum += score;
+
+    return TuneResult{Percentile(heights, 0.10), Percentile(heights, 0.50),
+                      Percentile(heights, 0.90), heightSum / heights.size(),
+                      scoreSum / scores.size()};
+}
+
+/**
+ * Play every tuple in `tuples` and add the results to the cache. One job
+ * is one lane group of one tuple, so the pool stays busy whether there is
+ * a single tuple or hundreds. Each job writes its own slice of its
+ * tuple's vectors; nothing is shared until every worker has joined.
+ */
+void Evaluate(const TuneOptions& options, const std::vector<ParamTuple>& tuples,
+              WorkStealingPool& pool, ResultCache& cache) {
+    if (tuples.empty()) return;
+
+    long long groupsPerTuple = (options.games + options.lanes - 1) / options.lanes;
+    std::vector<std::vector<int>> heights(tuples.size(), std::vector<int>(options.games));
+    std::vector<std::vector<int>> scores(tuples.size(), std::vector<int>(options.games));
+
+    pool.ParallelFor(static_cast<std::int64_t>(tuples.size()) * groupsPerTuple,
+                     [&](std::int64_t job, unsigned) {
+        size_t tuple = static_cast<size_t>(job / groupsPerTuple);
+        long long firstGame = (job % groupsPerTuple) * options.lanes;
+        int count = static_cast<int>(std::min<long long>(options.lanes, options.games - firstGame));
+        PlayGroup(options, ToSimParams(tuples[tuple]), firstGame, count,
+                  heights[tuple].data() + firstGame, scores[tuple].data() + firstGame);
+    });
+
+    for (size_t tuple = 0; tuple < tuples.size(); tuple++) {
+        cache.Add(tuples[tuple], Summarize(heights[tuple], scores[tuple]));
+    }
+}
+
+// ============================================================================
+// Search
+// ============================================================================
+
+// Every combination of the ranges' values, first parameter slowest
+std::vector<ParamTuple> GridTuples(const std::array<ParamRange, PARAM_COUNT>& ranges) {
+    std::vector<ParamTuple> tuples;
+    std::array<int, PARAM_COUNT> index = {};
+    for (;;) {
+        ParamTuple tuple;
+        for (int p = 0; p < PARAM_COUNT; p++) tuple[p] = ranges[p].GetValue(index[p]);
+        tuples.push_back(tuple);
+
+        int p = PARAM_COUNT - 1;
+        while (p >= 0 && ++index[p] == ranges[p].count) {
+            index[p] = 0;
+            p--;
+        }
+        if (p < 0) return tuples;
+    }
+}
+
+// Lower is closer to the target: the median first, the mean breaks ties
+bool IsCloser(const TuneResult& a, const TuneResult& b, double target) {
+    double medianA = std::fabs(a.heightP50 - target);
+    double medianB = std::fabs(b.heightP50 - target);
+    if (medianA != medianB) return medianA < medianB;
+    return std::fabs(a.heightMean - target) < std::fabs(b.heightMean - target);
+}
+
+// Half a step either side of `best` on each swept axis, inside the original
+// range: the next grid's step is the old one divided by count - 1, centred
+// on the best. A two-point axis spans a whole step, so it would replay the
+// same window; its window is halved instead so every pass converges.
+std::array<ParamRange, PARAM_COUNT> RefineAround(const std::array<ParamRange, PARAM_COUNT>& ranges,
+                                                 const std::array<ParamRange, PARAM_COUNT>& bounds,
+                                                 const ParamTuple& best) {
+    std::array<ParamRange, PARAM_COUNT> refined = ranges;
+    for (int p = 0; p < PARAM_COUNT; p++) {
+        if (ranges[p].count <= 1) continue;
+        float window = std::min(ranges[p].GetStep(), (ranges[p].max - ranges[p].min) / 2);
+        refined[p].min = std::max(bounds[p].min, best[p] - window / 2);
+        refined[p].max = std::min(bounds[p].max, best[p] + window / 2);
+    }
+    return refined;
+}
+
+void PrintResultHeader() {
+    std::printf("  %13s %15s %17s %11s  %5s %5s %5s %8s %10s\n", PARAM_NAMES[0],
+                PARAM_NAMES[1], PARAM_NAMES[2], PARAM_NAMES[3],
+                "p10", "p50", "p90", "mean", "score-mean");
+}
+
+void PrintResult(const ParamTuple& tuple, const TuneResult& result) {
+    std::printf("  %13.3f %15.3f %17.3f %11.4f  %5d %5d %5d %8.2f %10.1f\n",
+                tuple[0], tuple[1], tuple[2], tuple[3],
+                result.heightP10, result.heightP50, result.heightP90,
+                result.heightMean, result.scoreMean);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    TuneOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    ResultCache cache;
+    if (options.cachePath != nullptr &&
+        !cache.Open(options.cachePath, HashEvaluationConfig(options))) {
+        std::fprintf(stderr, "Could not open cache %s\n", options.cachePath);
+        return 1;
+    }
+    size_t cachedAtStart = cache.GetSize();
+
+    WorkStealingPool pool(options.threads);
+    std::printf("Tune:    %lld games per tuple on %u threads, %zu cached results\n",
+                options.games, pool.GetThreadCount(), cachedAtStart);
+
+    auto start = std::chrono::steady_clock::now();
+    std::array<ParamRange, PARAM_COUNT> ranges = options.ranges;
+    std::vector<ParamTuple> reported;     // Every tuple looked at, for the table
+    ParamTuple best = {};
+    const TuneResult* bestResult = nullptr;
+    long long played = 0;
+
+    int rounds = options.search == SearchKind::Refine ? options.rounds : 1;
+    for (int round = 0; round < rounds; round++) {
+        std::vector<ParamTuple> grid = GridTuples(ranges);
+
+        // This shard's share of the grid, minus what the cache already has
+        std::vector<ParamTuple> mine, pending;
+        for (size_t i = 0; i < grid.size(); i++) {
+            if (static_cast<int>(i % options.shardCount) != options.shardIndex) continue;
+            mine.push_back(grid[i]);
+            if (cache.Find(grid[i]) == nullptr) pending.push_back(grid[i]);
+        }
+
+        auto roundStart = std::chrono::steady_clock::now();
+        Evaluate(options, pending, pool, cache);
+        std::chrono::duration<double> roundTime = std::chrono::steady_clock::now() - roundStart;
+        played += static_cast<long long>(pending.size());
+
+        for (const ParamTuple& tuple : mine) {
+            reported.push_back(tuple);
+            const TuneResult* result = cache.Find(tuple);
+            if (options.targetMedian >= 0.0 &&
+                (bestResult == nullptr || IsCloser(*result, *bestResult, options.targetMedian))) {
+                best = tuple;
+                bestResult = result;
+            }
+        }
+
+        std::printf("Round %d: %zu tuples (%zu played, %zu cached) in %.2f s",
+                    round + 1, mine.size(), pending.size(), mine.size() - pending.size(),
+                    roundTime.count());
+        if (bestResult != nullptr) {
+            std::printf(", best median %d (target %.1f)", bestResult->heightP50,
+                        options.targetMedian);
+        }
+        std::printf("\n");
+
+        if (bestResult != nullptr && bestResult->heightP50 == options.targetMedian) break;
+        ranges = RefineAround(ranges, options.ranges, best);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("Elapsed: %.3f s  (%lld tuples played, %lld games)\n", elapsed.count(),
+                played, played * options.games);
+
+    // Closest to the target first; without a target, in sweep order
+    std::sort(reported.begin(), reported.end());
+    reported.erase(std::unique(reported.begin(), reported.end()), reported.end());
+    if (options.targetMedian >= 0.0) {
+        std::stable_sort(reported.begin(), reported.end(),
+            [&](const ParamTuple& a, const ParamTuple& b) {
+                return IsCloser(*cache.Find(a), *cache.Find(b), options.targetMedian);
+            });
+    }
+
+    PrintResultHeader();
+    size_t rows = std::min(reported.size(), static_cast<size_t>(std::max(0, options.top)));
+    for (size_t i = 0; i < rows; i++) {
+        PrintResult(reported[i], *cache.Find(reported[i]));
+    }
+    if (bestResult != nullptr) {
+        std::printf("Best:    --initial-speed %.9g --speed-increment %.9g "
+                    "--perfect-threshold %.9g --min-overlap %.9g\n",
+                    best[0], best[1], best[2], best[3]);
+    }
+    return 0;
+}
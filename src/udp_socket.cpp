@@ -0,0 +1,146 @@
+/**
+ * UdpSocket - Minimal non-blocking IPv4 UDP socket
+ * See udp_socket.h for an overview.
+ */
+
+#include "udp_socket.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using SocketHandle = SOCKET;
+using SocketLength = int;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SocketHandle = int;
+using SocketLength = socklen_t;
+#endif
+
+namespace {
+
+#ifdef _WIN32
+// Winsock must be started once per process before any socket call
+bool StartSockets() {
+    static bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+#else
+bool StartSockets() { return true; }
+#endif
+
+sockaddr_in ToSockaddr(const UdpAddress& address) {
+    sockaddr_in socketAddress = {};
+    socketAddress.sin_family = AF_INET;
+    socketAddress.sin_addr.s_addr = htonl(address.ip);
+    socketAddress.sin_port = htons(address.port);
+    return socketAddress;
+}
+
+}  // namespace
+
+bool ResolveUdpAddress(const char* host, std::uint16_t port, UdpAddress& address) {
+    if (!StartSockets()) return false;
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &result) != 0 || result == nullptr) return false;
+
+    const sockaddr_in* resolved = reinterpret_cast<const sockaddr_in*>(result->ai_addr);
+    address.ip = ntohl(resolved->sin_addr.s_addr);
+    address.port = port;
+    freeaddrinfo(result);
+    return true;
+}
+
+bool UdpSocket::Open(std::uint16_t port) {
+    Close();
+    if (!StartSockets()) return false;
+
+#ifdef _WIN32
+    SocketHandle socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (socketHandle == INVALID_SOCKET) return false;
+    u_long nonBlocking = 1;
+    bool configured = ioctlsocket(socketHandle, FIONBIO, &nonBlocking) == 0;
+#else
+    SocketHandle socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (socketHandle < 0) return false;
+    int flags = fcntl(socketHandle, F_GETFL, 0);
+    bool configured = flags >= 0 && fcntl(socketHandle, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+    handle = static_cast<long long>(socketHandle);
+
+    UdpAddress any;
+    any.port = port;
+    sockaddr_in bindAddress = ToSockaddr(any);
+    if (!configured ||
+        bind(socketHandle, reinterpret_cast<const sockaddr*>(&bindAddress),
+             sizeof(bindAddress)) != 0) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void UdpSocket::Close() {
+    if (handle < 0) return;
+#ifdef _WIN32
+    closesocket(static_cast<SocketHandle>(handle));
+#else
+    close(static_cast<SocketHandle>(handle));
+#endif
+    handle = -1;
+}
+
+bool UdpSocket::SendTo(const UdpAddress& address, const std::uint8_t* data, std::size_t size) {
+    if (handle < 0) return false;
+    sockaddr_in target = ToSockaddr(address);
+    long sent = static_cast<long>(sendto(static_cast<SocketHandle>(handle),
+                                         reinterpret_cast<const char*>(data),
+                                         static_cast<int>(size), 0,
+                                         reinterpret_cast<const sockaddr*>(&target),
+                                         sizeof(target)));
+    return sent == static_cast<long>(size);
+}
+
+long UdpSocket::ReceiveFrom(UdpAddress& address, std::uint8_t* buffer, std::size_t capacity) {
+    if (handle < 0) return -1;
+    sockaddr_in source = {};
+    SocketLength sourceLength = sizeof(source);
+    long received = static_cast<long>(recvfrom(static_cast<SocketHandle>(handle),
+                                               reinterpret_cast<char*>(buffer),
+                                               static_cast<int>(capacity), 0,
+                                               reinterpret_cast<sockaddr*>(&source),
+                                               &sourceLength));
+    if (received < 0) return -1;  // Nothing waiting (EWOULDBLOCK) or an error
+
+    address.ip = ntohl(source.sin_addr.s_addr);
+    address.port = ntohs(source.sin_port);
+    return received;
+}
+
+bool UdpSocket::WaitReadable(int timeoutMs) const {
+    if (handle < 0) return false;
+#ifdef _WIN32
+    WSAPOLLFD descriptor = {};
+    descriptor.fd = static_cast<SocketHandle>(handle);
+    descriptor.events = POLLRDNORM;
+    return WSAPoll(&descriptor, 1, timeoutMs) > 0;
+#else
+    pollfd descriptor = {};
+    descriptor.fd = static_cast<SocketHandle>(handle);
+    descriptor.events = POLLIN;
+    return poll(&descriptor, 1, timeoutMs) > 0;
+#endif
+}
@@ -0,0 +1,50 @@
+/**
+ * UdpSocket - Minimal non-blocking IPv4 UDP socket
+ *
+ * Wraps BSD sockets (Winsock on Windows) behind a tiny interface so the
+ * spectator code never includes platform headers; in particular
+ * <windows.h> clashes with raylib's names, so it stays inside
+ * udp_socket.cpp.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct UdpAddress {
+    std::uint32_t ip = 0;    // Host byte order
+    std::uint16_t port = 0;  // Host byte order
+
+    bool operator==(const UdpAddress& other) const { return ip == other.ip && port == other.port; }
+};
+
+// Resolve "host" (name or dotted quad) to an IPv4 address; false on failure
+bool ResolveUdpAddress(const char* host, std::uint16_t port, UdpAddress& address);
+
+class UdpSocket {
+public:
+    UdpSocket() = default;
+    ~UdpSocket() { Close(); }
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Bind to `port` on all interfaces (0 = any free port), non-blocking
+    bool Open(std::uint16_t port);
+    void Close();
+    bool IsOpen() const { return handle >= 0; }
+
+    // Returns false if the datagram could not be queued
+    bool SendTo(const UdpAddress& address, const std::uint8_t* data, std::size_t size);
+
+    // Next pending datagram: its size, or -1 if none is waiting
+    long ReceiveFrom(UdpAddress& address, std::uint8_t* buffer, std::size_t capacity);
+
+    // Sleep until a datagram is waiting or `timeoutMs` passes; true if one
+    // is. For server threads with nothing else to do between datagrams.
+    bool WaitReadable(int timeoutMs) const;
+
+private:
+    long long handle = -1;  // SOCKET on Windows, file descriptor elsewhere
+};
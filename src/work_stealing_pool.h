@@ -0,0 +1,133 @@
+/**
+ * WorkStealingPool - Runs independent jobs across all cores
+ *
+ * WHY WORK STEALING?
+ * - Games finish after very different numbers of ticks, so splitting the
+ *   work into equal static chunks leaves some cores idle at the end
+ * - Each worker starts with its own contiguous range of job indices and
+ *   takes jobs from the front of it
+ * - A worker that runs dry steals the back half of the fullest victim's
+ *   range (largest end - begin when it scanned), so load balances itself
+ *   with few steals
+ *
+ * Every range has its own lock, so the owner only ever contends with a
+ * thief and never with the other workers. Threads are started per
+ * ParallelFor call; the batch jobs it runs last seconds to minutes.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    // threadCount 0 means one worker per hardware thread
+    explicit WorkStealingPool(unsigned threadCount = 0)
+        : threadCount(threadCount != 0 ? threadCount
+                                       : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    unsigned GetThreadCount() const { return threadCount; }
+
+    /**
+     * Calls body(index, worker) once for every index in [0, count) and
+     * returns when all calls have finished. worker is in
+     * [0, GetThreadCount()) and is stable for the calling thread, so
+     * bodies can write to per-worker state without synchronization.
+     */
+    template <typename Body>
+    void ParallelFor(std::int64_t count, Body body) {
+        if (count <= 0) return;
+
+        unsigned workers = static_cast<unsigned>(
+            std::min<std::int64_t>(threadCount, count));
+        std::unique_ptr<WorkRange[]> ranges(new WorkRange[workers]);
+
+        // Initial even split; stealing fixes any imbalance
+        for (unsigned w = 0; w < workers; w++) {
+            ranges[w].begin = count * w / workers;
+            ranges[w].end = count * (w + 1) / workers;
+        }
+
+        auto run = [&](unsigned worker) {
+            std::int64_t index;
+            while (TakeOwn(ranges[worker], index) ||
+                   Steal(ranges.get(), workers, worker, index)) {
+                body(index, worker);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (unsigned w = 1; w < workers; w++) {
+            threads.emplace_back(run, w);
+        }
+        run(0);  // The calling thread is worker 0
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    // Padded to a cache line so owners do not false-share each other's range
+    struct alignas(64) WorkRange {
+        std::mutex mutex;
+        std::int64_t begin = 0;
+        std::int64_t end = 0;
+    };
+
+    unsigned threadCount;
+
+    static bool TakeOwn(WorkRange& range, std::int64_t& index) {
+        std::lock_guard<std::mutex> lock(range.mutex);
+        if (range.begin >= range.end) return false;
+        index = range.begin++;
+        return true;
+    }
+
+    // Move the back half of the fullest victim's range into our own -
+    // O(workers) per attempt
+    static bool Steal(WorkRange* ranges, unsigned workers, unsigned thief,
+                      std::int64_t& index) {
+        for (;;) {
+            // Sizes are sampled one lock at a time, so the victim may have
+            // shrunk by the time we lock it again; rescan if it ran dry
+            WorkRange* victim = nullptr;
+            std::int64_t largest = 0;
+            for (unsigned offset = 1; offset < workers; offset++) {
+                WorkRange& candidate = ranges[(thief + offset) % workers];
+                std::lock_guard<std::mutex> lock(candidate.mutex);
+                std::int64_t remaining = candidate.end - candidate.begin;
+                if (remaining > largest) {
+                    largest = remaining;
+                    victim = &candidate;
+                }
+            }
+            if (victim == nullptr) return false;
+
+            std::int64_t stolenBegin, stolenEnd;
+            {
+                std::lock_guard<std::mutex> lock(victim->mutex);
+                std::int64_t remaining = victim->end - victim->begin;
+                if (remaining <= 0) continue;
+
+                stolenEnd = victim->end;
+                stolenBegin = stolenEnd - (remaining + 1) / 2;
+                victim->end = stolenBegin;
+            }
+
+            // Run the first stolen job now and keep the rest stealable
+            WorkRange& own = ranges[thief];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = stolenBegin + 1;
+            own.end = stolenEnd;
+            index = stolenBegin;
+            return true;
+        }
+    }
+};